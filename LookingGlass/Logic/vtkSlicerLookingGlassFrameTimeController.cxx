@@ -0,0 +1,258 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// LookingGlass Logic includes
+#include "vtkSlicerLookingGlassFrameTimeController.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+/// Weight of the last frame in the smoothed frame time
+const double SmoothingFactor = 0.5;
+/// Frame time ratios (target / measured) within which no adjustment is made
+const double LowerTolerance = 0.9;
+const double UpperTolerance = 1.2;
+/// Bounds of the frame time ratio applied in a single adjustment
+const double MaximumReduction = 0.5;
+const double MaximumIncrease = 1.25;
+/// Number of frames ignored after an adjustment
+const int NumberOfSettlingFrames = 1;
+
+//----------------------------------------------------------------------------
+/// The rendering cost is proportional to the knob value raised to this
+/// exponent, e.g. the number of pixels grows with the square of the tile scale.
+double costExponent(int knob)
+{
+  return knob == vtkSlicerLookingGlassFrameTimeController::KnobTileResolution ? 2.0 : 1.0;
+}
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerLookingGlassFrameTimeController);
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassFrameTimeController::vtkSlicerLookingGlassFrameTimeController()
+  : TargetFrameTime(1.0 / 30.0)
+  , SmoothedFrameTime(0.0)
+  , SettlingFrames(0)
+  , NumberOfAdjustments(0)
+  , LastAdjustedKnob(-1)
+  , LastAdjustedKnobPreviousValue(1.0)
+{
+  for (int knob = 0; knob < Knob_Last; ++knob)
+    {
+    this->MinimumKnobValues[knob] = 1.0;
+    this->KnobValues[knob] = 1.0;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassFrameTimeController::~vtkSlicerLookingGlassFrameTimeController()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassFrameTimeController::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "TargetFrameTime: " << this->TargetFrameTime << "\n";
+  os << indent << "SmoothedFrameTime: " << this->SmoothedFrameTime << "\n";
+  for (int knob = 0; knob < Knob_Last; ++knob)
+    {
+    os << indent << GetKnobAsString(knob) << ": " << this->KnobValues[knob]
+      << " (minimum " << this->MinimumKnobValues[knob] << ")\n";
+    }
+  os << indent << "NumberOfAdjustments: " << this->NumberOfAdjustments << "\n";
+  os << indent << "LastAdjustment: " << this->GetLastAdjustmentAsString() << "\n";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkSlicerLookingGlassFrameTimeController::GetKnobAsString(int id)
+{
+  switch (id)
+  {
+  case KnobGeometry: return "Geometry";
+  case KnobVolume: return "Volume";
+  case KnobViewCount: return "ViewCount";
+  case KnobTileResolution: return "TileResolution";
+  default:
+    // invalid id
+    return "";
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerLookingGlassFrameTimeController::GetKnobFromString(const char* name)
+{
+  if (name == nullptr)
+  {
+    // invalid name
+    return -1;
+  }
+  for (int ii = 0; ii < Knob_Last; ii++)
+  {
+    if (strcmp(name, GetKnobAsString(ii)) == 0)
+    {
+      // found a matching name
+      return ii;
+    }
+  }
+  // unknown name
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassFrameTimeController::SetMinimumKnobValue(int knob, double value)
+{
+  if (knob < 0 || knob >= Knob_Last)
+    {
+    vtkErrorMacro("SetMinimumKnobValue: invalid knob " << knob);
+    return;
+    }
+  value = std::min(std::max(value, 0.0), 1.0);
+  if (this->MinimumKnobValues[knob] == value)
+    {
+    return;
+    }
+  this->MinimumKnobValues[knob] = value;
+  this->KnobValues[knob] = std::max(this->KnobValues[knob], value);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerLookingGlassFrameTimeController::GetMinimumKnobValue(int knob)
+{
+  if (knob < 0 || knob >= Knob_Last)
+    {
+    return 1.0;
+    }
+  return this->MinimumKnobValues[knob];
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerLookingGlassFrameTimeController::GetKnobValue(int knob)
+{
+  if (knob < 0 || knob >= Knob_Last)
+    {
+    return 1.0;
+    }
+  return this->KnobValues[knob];
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassFrameTimeController::AddFrameTime(double frameTime)
+{
+  if (frameTime <= 0.0 || this->TargetFrameTime <= 0.0)
+    {
+    return false;
+    }
+  if (this->SettlingFrames > 0)
+    {
+    --this->SettlingFrames;
+    return false;
+    }
+
+  // Isolated slow frames (e.g. garbage collection, shader compilation)
+  // are filtered out
+  this->SmoothedFrameTime = this->SmoothedFrameTime > 0.0
+    ? SmoothingFactor * frameTime + (1.0 - SmoothingFactor) * this->SmoothedFrameTime
+    : frameTime;
+  double ratio = this->TargetFrameTime / this->SmoothedFrameTime;
+
+  int knob = -1;
+  double factor = 1.0;
+  if (ratio < LowerTolerance)
+    {
+    for (int candidate = 0; candidate < Knob_Last; ++candidate)
+      {
+      if (this->KnobValues[candidate] > this->MinimumKnobValues[candidate])
+        {
+        knob = candidate;
+        break;
+        }
+      }
+    factor = std::max(ratio, MaximumReduction);
+    }
+  else if (ratio > UpperTolerance)
+    {
+    for (int candidate = Knob_Last - 1; candidate >= 0; --candidate)
+      {
+      if (this->KnobValues[candidate] < 1.0)
+        {
+        knob = candidate;
+        break;
+        }
+      }
+    factor = std::min(ratio, MaximumIncrease);
+    }
+  if (knob < 0)
+    {
+    // Within tolerance, or all the knobs are at their bounds
+    return false;
+    }
+
+  double previousValue = this->KnobValues[knob];
+  this->KnobValues[knob] = std::min(std::max(previousValue * std::pow(factor, 1.0 / costExponent(knob)),
+    this->MinimumKnobValues[knob]), 1.0);
+
+  // Frame times measured with the previous settings are not relevant anymore
+  this->SmoothedFrameTime = 0.0;
+  this->SettlingFrames = NumberOfSettlingFrames;
+  ++this->NumberOfAdjustments;
+  this->LastAdjustedKnob = knob;
+  this->LastAdjustedKnobPreviousValue = previousValue;
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassFrameTimeController::Reset()
+{
+  for (int knob = 0; knob < Knob_Last; ++knob)
+    {
+    this->KnobValues[knob] = 1.0;
+    }
+  this->SmoothedFrameTime = 0.0;
+  this->SettlingFrames = 0;
+  this->NumberOfAdjustments = 0;
+  this->LastAdjustedKnob = -1;
+  this->LastAdjustedKnobPreviousValue = 1.0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerLookingGlassFrameTimeController::GetLastAdjustmentAsString()
+{
+  if (this->LastAdjustedKnob < 0)
+    {
+    return std::string();
+    }
+  double value = this->KnobValues[this->LastAdjustedKnob];
+  std::ostringstream adjustment;
+  adjustment << (value < this->LastAdjustedKnobPreviousValue ? "Reduced " : "Increased ")
+    << GetKnobAsString(this->LastAdjustedKnob) << " from " << this->LastAdjustedKnobPreviousValue
+    << " to " << value;
+  return adjustment.str();
+}
@@ -0,0 +1,118 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerLookingGlassFrameTimeController_h
+#define __vtkSlicerLookingGlassFrameTimeController_h
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <string>
+
+#include "vtkSlicerLookingGlassModuleLogicExport.h"
+
+/// \brief Adjust rendering quality knobs to hold a target frame time.
+///
+/// Each knob is a quality level in the [minimum, 1] range, 1 being full
+/// quality. The measured frame times are smoothed and compared to the
+/// target frame time: when frames are too slow, the first knob that is not
+/// at its minimum is reduced, in the order of the Knob enum; when frames
+/// are fast enough, the last reduced knob is restored first. The knobs
+/// with the least visible effect are therefore reduced first and restored
+/// last.
+///
+/// Adjustments are proportional to the frame time error, damped, and only
+/// made out of a tolerance band around the target. Frames rendered just
+/// after an adjustment are not measured, as they include the reallocation
+/// of the resources modified by the adjustment.
+class VTK_SLICER_LOOKINGGLASS_MODULE_LOGIC_EXPORT vtkSlicerLookingGlassFrameTimeController : public vtkObject
+{
+public:
+  static vtkSlicerLookingGlassFrameTimeController* New();
+  vtkTypeMacro(vtkSlicerLookingGlassFrameTimeController, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Quality knobs, in reduction order
+  /// Geometry: triangle budget of the decimated proxies of large models
+  /// Volume: volume rendering sample distance
+  /// ViewCount: fraction of the quilt views that are rendered, the other
+  ///   ones are synthesized
+  /// TileResolution: scale of the quilt tile size
+  enum
+  {
+    KnobGeometry = 0,
+    KnobVolume,
+    KnobViewCount,
+    KnobTileResolution,
+    Knob_Last
+  };
+
+  /// Convert between knob ID and name
+  static const char* GetKnobAsString(int id);
+  static int GetKnobFromString(const char* name);
+
+  /// Frame time to hold, in seconds. Default is 1/30.
+  vtkSetMacro(TargetFrameTime, double);
+  vtkGetMacro(TargetFrameTime, double);
+
+  /// Lowest quality level of \a knob, in the [0, 1] range.
+  /// A minimum of 1 disables the knob. Default is 1.
+  void SetMinimumKnobValue(int knob, double value);
+  double GetMinimumKnobValue(int knob);
+
+  /// Current quality level of \a knob.
+  double GetKnobValue(int knob);
+
+  /// Update the knobs from the time of a rendered frame.
+  /// Return true if a knob has been adjusted.
+  bool AddFrameTime(double frameTime);
+
+  /// Restore full quality and forget the measured frame times.
+  void Reset();
+
+  /// Smoothed frame time the last adjustment was based on.
+  vtkGetMacro(SmoothedFrameTime, double);
+  /// Total number of adjustments since last reset.
+  vtkGetMacro(NumberOfAdjustments, unsigned long);
+  /// Knob of the last adjustment, -1 if none.
+  vtkGetMacro(LastAdjustedKnob, int);
+  /// Description of the last adjustment, e.g. "Reduced Volume to 0.5".
+  /// Empty if none.
+  std::string GetLastAdjustmentAsString();
+
+protected:
+  vtkSlicerLookingGlassFrameTimeController();
+  ~vtkSlicerLookingGlassFrameTimeController() override;
+
+  double TargetFrameTime;
+  double MinimumKnobValues[Knob_Last];
+  double KnobValues[Knob_Last];
+  double SmoothedFrameTime;
+  /// Frames still ignored after the last adjustment
+  int SettlingFrames;
+  unsigned long NumberOfAdjustments;
+  int LastAdjustedKnob;
+  /// Value of the last adjusted knob before the adjustment
+  double LastAdjustedKnobPreviousValue;
+
+private:
+  vtkSlicerLookingGlassFrameTimeController(const vtkSlicerLookingGlassFrameTimeController&); // Not implemented
+  void operator=(const vtkSlicerLookingGlassFrameTimeController&); // Not implemented
+};
+
+#endif
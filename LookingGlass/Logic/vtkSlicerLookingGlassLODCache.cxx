@@ -0,0 +1,436 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// LookingGlass Logic includes
+#include "vtkSlicerLookingGlassLODCache.h"
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkCellArray.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkProp.h>
+#include <vtkPropCollection.h>
+#include <vtkQuadricClustering.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/// Ratio between the number of triangles of successive levels of detail
+const double LevelReductionFactor = 4.0;
+/// Number of proxies built for each input, from the finest to the coarsest
+const int NumberOfLevels = 3;
+
+typedef std::vector<vtkSmartPointer<vtkPolyData> > LevelList;
+
+//----------------------------------------------------------------------------
+vtkIdType numberOfTriangles(vtkPolyData* polyData)
+{
+  return polyData ? polyData->GetNumberOfPolys() + polyData->GetNumberOfStrips() : 0;
+}
+
+//----------------------------------------------------------------------------
+/// Proxies of an input, built by the worker thread of a BuildQueue
+struct BuildJob
+{
+  /// Copy of the input points and triangles
+  vtkSmartPointer<vtkPolyData> Input;
+  vtkIdType NumberOfTriangles = 0;
+  /// Set by the main thread when the proxies are not needed anymore,
+  /// checked by the worker thread between levels
+  std::atomic<bool> Cancelled{false};
+  /// Set by the worker thread once Levels is written
+  std::atomic<bool> Done{false};
+  LevelList Levels;
+};
+
+//----------------------------------------------------------------------------
+/// Jobs built one at a time by a single worker thread, in request order.
+/// The worker thread shares the ownership of the queue, so that the cache
+/// can be destroyed without waiting for the job being built.
+struct BuildQueue
+{
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  std::deque<std::shared_ptr<BuildJob> > Jobs;
+  bool Stopped = false;
+};
+
+//----------------------------------------------------------------------------
+LevelList buildLevels(vtkPolyData* input, vtkIdType inputTriangles, const std::atomic<bool>& cancelled)
+{
+  LevelList levels;
+  vtkIdType previousTriangles = inputTriangles;
+  double targetTriangles = static_cast<double>(inputTriangles);
+  for (int level = 0; level < NumberOfLevels; ++level)
+    {
+    if (cancelled)
+      {
+      levels.clear();
+      break;
+      }
+    targetTriangles /= LevelReductionFactor;
+    // Clustering a surface in n^3 cells produces about 2 n^2 triangles
+    int divisions = std::max(8, static_cast<int>(std::sqrt(targetTriangles / 2.0)));
+    vtkNew<vtkQuadricClustering> clustering;
+    clustering->SetInputData(input);
+    clustering->SetNumberOfDivisions(divisions, divisions, divisions);
+    clustering->AutoAdjustNumberOfDivisionsOn();
+    // Normals of the input are not clustered
+    vtkNew<vtkPolyDataNormals> normals;
+    normals->SetInputConnection(clustering->GetOutputPort());
+    normals->SplittingOff();
+    normals->ConsistencyOff();
+    normals->Update();
+    vtkSmartPointer<vtkPolyData> proxy = normals->GetOutput();
+    vtkIdType proxyTriangles = numberOfTriangles(proxy);
+    if (proxyTriangles == 0 || proxyTriangles >= previousTriangles)
+      {
+      // The input cannot be reduced further
+      break;
+      }
+    levels.push_back(proxy);
+    previousTriangles = proxyTriangles;
+    }
+  return levels;
+}
+
+//----------------------------------------------------------------------------
+void runBuildQueue(std::shared_ptr<BuildQueue> queue)
+{
+  while (true)
+    {
+    std::shared_ptr<BuildJob> job;
+    {
+      std::unique_lock<std::mutex> lock(queue->Mutex);
+      queue->Condition.wait(lock, [&queue] { return queue->Stopped || !queue->Jobs.empty(); });
+      if (queue->Stopped)
+        {
+        return;
+        }
+      job = queue->Jobs.front();
+      queue->Jobs.pop_front();
+    }
+    if (!job->Cancelled)
+      {
+      job->Levels = buildLevels(job->Input, job->NumberOfTriangles, job->Cancelled);
+      }
+    job->Input = nullptr;
+    job->Done = true;
+    }
+}
+}
+
+//----------------------------------------------------------------------------
+class vtkSlicerLookingGlassLODCache::vtkInternal
+{
+public:
+  struct Proxy
+  {
+    vtkWeakPointer<vtkActor> Actor;
+    vtkWeakPointer<vtkPolyData> Input;
+    vtkMTimeType InputMTime = 0;
+    vtkIdType NumberOfTriangles = 0;
+    /// Proxies from the finest to the coarsest, empty until built
+    LevelList Levels;
+    /// True once the levels are built, even if the input cannot be reduced
+    bool Built = false;
+    std::shared_ptr<BuildJob> Build;
+    /// Renders the proxy with the settings of the original mapper
+    vtkSmartPointer<vtkPolyDataMapper> Mapper;
+    vtkMTimeType OriginalMapperMTime = 0;
+  };
+
+  vtkInternal()
+    : Queue(std::make_shared<BuildQueue>())
+  {
+  }
+
+  ~vtkInternal()
+  {
+    // The worker thread completes or cancels the job being built on its own
+    {
+      std::lock_guard<std::mutex> lock(this->Queue->Mutex);
+      this->Queue->Stopped = true;
+      this->Queue->Jobs.clear();
+    }
+    this->Queue->Condition.notify_all();
+  }
+
+  /// Queue the build of the proxies of \a input, starting the worker thread
+  /// on the first request.
+  void RequestBuild(Proxy& proxy, vtkSmartPointer<vtkPolyData> input)
+  {
+    proxy.Build = std::make_shared<BuildJob>();
+    proxy.Build->Input = input;
+    proxy.Build->NumberOfTriangles = proxy.NumberOfTriangles;
+    {
+      std::lock_guard<std::mutex> lock(this->Queue->Mutex);
+      this->Queue->Jobs.push_back(proxy.Build);
+    }
+    if (!this->WorkerStarted)
+      {
+      std::thread(runBuildQueue, this->Queue).detach();
+      this->WorkerStarted = true;
+      }
+    this->Queue->Condition.notify_one();
+  }
+
+  /// Cancel the build of a proxy being discarded without waiting for it,
+  /// the worker thread stops at the next level.
+  void DiscardBuild(Proxy& proxy)
+  {
+    if (proxy.Build)
+      {
+      proxy.Build->Cancelled = true;
+      proxy.Build.reset();
+      }
+    proxy.Levels.clear();
+    proxy.Built = false;
+  }
+
+  std::map<vtkActor*, Proxy> Proxies;
+  std::shared_ptr<BuildQueue> Queue;
+  bool WorkerStarted = false;
+  /// Actors rendered with a proxy and their original mapper
+  std::vector<std::pair<vtkWeakPointer<vtkActor>, vtkSmartPointer<vtkMapper> > > SwappedMappers;
+};
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerLookingGlassLODCache);
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassLODCache::vtkSlicerLookingGlassLODCache()
+  : MinimumNumberOfTriangles(100000)
+  , NumberOfProxyActors(0)
+  , NumberOfRenderedTriangles(0)
+  , Internal(new vtkInternal)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassLODCache::~vtkSlicerLookingGlassLODCache()
+{
+  this->Clear();
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassLODCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MinimumNumberOfTriangles: " << this->MinimumNumberOfTriangles << "\n";
+  os << indent << "NumberOfProxyActors: " << this->NumberOfProxyActors << "\n";
+  os << indent << "NumberOfRenderedTriangles: " << this->NumberOfRenderedTriangles << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassLODCache::ApplyProxies(vtkRenderer* renderer, vtkIdType triangleBudget)
+{
+  this->RestoreMappers();
+  this->NumberOfProxyActors = 0;
+  this->NumberOfRenderedTriangles = 0;
+
+  for (auto it = this->Internal->Proxies.begin(); it != this->Internal->Proxies.end();)
+    {
+    if (!it->second.Actor)
+      {
+      // Actor has been deleted
+      this->Internal->DiscardBuild(it->second);
+      it = this->Internal->Proxies.erase(it);
+      }
+    else
+      {
+      ++it;
+      }
+    }
+  if (!renderer)
+    {
+    return;
+    }
+
+  std::vector<vtkInternal::Proxy*> proxies;
+  vtkIdType totalTriangles = 0;
+  vtkPropCollection* props = renderer->GetViewProps();
+  vtkCollectionSimpleIterator it;
+  vtkProp* prop = nullptr;
+  for (props->InitTraversal(it); (prop = props->GetNextProp(it));)
+    {
+    vtkActor* actor = vtkActor::SafeDownCast(prop);
+    vtkPolyDataMapper* mapper = actor ? vtkPolyDataMapper::SafeDownCast(actor->GetMapper()) : nullptr;
+    vtkPolyData* input = mapper ? mapper->GetInput() : nullptr;
+    if (!prop->GetVisibility() || !input)
+      {
+      continue;
+      }
+    vtkIdType triangles = numberOfTriangles(input);
+    totalTriangles += triangles;
+    // Point and cell scalars are not clustered
+    if (triangles < this->MinimumNumberOfTriangles || mapper->GetScalarVisibility())
+      {
+      continue;
+      }
+
+    vtkInternal::Proxy& proxy = this->Internal->Proxies[actor];
+    if (proxy.Actor != actor || proxy.Input != input || proxy.InputMTime != input->GetMTime())
+      {
+      // New or modified input
+      this->Internal->DiscardBuild(proxy);
+      proxy.Actor = actor;
+      proxy.Input = input;
+      proxy.InputMTime = input->GetMTime();
+      proxy.NumberOfTriangles = triangles;
+      }
+    if (!proxy.Built && !proxy.Build)
+      {
+      // The proxies are built from a copy of the points and triangles: the
+      // arrays of the input may be modified by the main thread meanwhile.
+      vtkSmartPointer<vtkPolyData> inputCopy = vtkSmartPointer<vtkPolyData>::New();
+      vtkNew<vtkPoints> points;
+      points->DeepCopy(input->GetPoints());
+      inputCopy->SetPoints(points);
+      vtkNew<vtkCellArray> polys;
+      polys->DeepCopy(input->GetPolys());
+      inputCopy->SetPolys(polys);
+      vtkNew<vtkCellArray> strips;
+      strips->DeepCopy(input->GetStrips());
+      inputCopy->SetStrips(strips);
+      this->Internal->RequestBuild(proxy, inputCopy);
+      }
+    if (proxy.Build && proxy.Build->Done)
+      {
+      proxy.Levels = std::move(proxy.Build->Levels);
+      proxy.Built = true;
+      proxy.Build.reset();
+      }
+    proxies.push_back(&proxy);
+    }
+
+  this->NumberOfRenderedTriangles = totalTriangles;
+  if (triangleBudget <= 0 || totalTriangles <= triangleBudget)
+    {
+    return;
+    }
+
+  // All the large actors are reduced by the same ratio
+  double ratio = static_cast<double>(triangleBudget) / totalTriangles;
+  for (vtkInternal::Proxy* proxy : proxies)
+    {
+    if (proxy->Levels.empty())
+      {
+      continue;
+      }
+    vtkPolyData* level = proxy->Levels.back();
+    for (vtkPolyData* candidate : proxy->Levels)
+      {
+      if (numberOfTriangles(candidate) <= ratio * proxy->NumberOfTriangles)
+        {
+        level = candidate;
+        break;
+        }
+      }
+
+    vtkMapper* originalMapper = proxy->Actor->GetMapper();
+    if (!proxy->Mapper)
+      {
+      proxy->Mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+      }
+    if (proxy->OriginalMapperMTime != originalMapper->GetMTime() || proxy->Mapper->GetInput() != level)
+      {
+      // Lookup table, clipping planes, coincident topology...
+      proxy->Mapper->ShallowCopy(originalMapper);
+      proxy->Mapper->SetInputData(level);
+      proxy->OriginalMapperMTime = originalMapper->GetMTime();
+      }
+    this->Internal->SwappedMappers.push_back(std::make_pair(
+      vtkWeakPointer<vtkActor>(proxy->Actor), vtkSmartPointer<vtkMapper>(originalMapper)));
+    proxy->Actor->SetMapper(proxy->Mapper);
+    this->NumberOfRenderedTriangles += numberOfTriangles(level) - proxy->NumberOfTriangles;
+    ++this->NumberOfProxyActors;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassLODCache::RestoreMappers()
+{
+  for (auto& swappedMapper : this->Internal->SwappedMappers)
+    {
+    if (swappedMapper.first)
+      {
+      swappedMapper.first->SetMapper(swappedMapper.second);
+      }
+    }
+  this->Internal->SwappedMappers.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassLODCache::ReleaseGraphicsResources(vtkWindow* window)
+{
+  for (auto& proxy : this->Internal->Proxies)
+    {
+    if (proxy.second.Mapper)
+      {
+      proxy.second.Mapper->ReleaseGraphicsResources(window);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassLODCache::Clear()
+{
+  this->RestoreMappers();
+  for (auto& proxy : this->Internal->Proxies)
+    {
+    this->Internal->DiscardBuild(proxy.second);
+    }
+  this->Internal->Proxies.clear();
+  this->NumberOfProxyActors = 0;
+  this->NumberOfRenderedTriangles = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerLookingGlassLODCache::GetNumberOfPendingProxies()
+{
+  int numberOfPendingProxies = 0;
+  for (auto& proxy : this->Internal->Proxies)
+    {
+    if (proxy.second.Build)
+      {
+      ++numberOfPendingProxies;
+      }
+    }
+  return numberOfPendingProxies;
+}
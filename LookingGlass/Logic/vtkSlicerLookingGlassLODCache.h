@@ -0,0 +1,99 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerLookingGlassLODCache_h
+#define __vtkSlicerLookingGlassLODCache_h
+
+// VTK includes
+#include <vtkObject.h>
+
+#include "vtkSlicerLookingGlassModuleLogicExport.h"
+
+class vtkRenderer;
+class vtkWindow;
+
+/// \brief Render large surface models with decimated proxies.
+///
+/// Models and segmentations of several million triangles are rendered once
+/// per quilt view. During interaction, ApplyProxies() replaces the mapper of
+/// each large polydata actor of the renderer with a mapper rendering a
+/// decimated proxy of its input, so that the number of triangles rendered
+/// per view fits a triangle budget. RestoreMappers() puts the original
+/// mappers back. Mappers must be swapped after the displayable managers
+/// updated the actors and restored before they update them again, e.g.
+/// at the start and end events of the renderer.
+///
+/// Proxies are cached per actor, i.e. per displayed node, and rebuilt when
+/// the input polydata is modified. They are built one input at a time by a
+/// background worker thread, by quadric clustering of a copy of the input
+/// points and triangles, actors are rendered with full detail until their
+/// proxies are available. Builds of discarded proxies are cancelled between
+/// levels and never waited for.
+class VTK_SLICER_LOOKINGGLASS_MODULE_LOGIC_EXPORT vtkSlicerLookingGlassLODCache : public vtkObject
+{
+public:
+  static vtkSlicerLookingGlassLODCache* New();
+  vtkTypeMacro(vtkSlicerLookingGlassLODCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Actors with fewer triangles are always rendered with full detail.
+  /// Default is 100000.
+  vtkSetMacro(MinimumNumberOfTriangles, vtkIdType);
+  vtkGetMacro(MinimumNumberOfTriangles, vtkIdType);
+
+  /// Render the actors of \a renderer with the finest proxies that fit
+  /// \a triangleBudget triangles per render, the actors of fewer triangles
+  /// included. Actors are rendered with full detail if the budget is not
+  /// exceeded. Proxies of new or modified inputs are requested.
+  void ApplyProxies(vtkRenderer* renderer, vtkIdType triangleBudget);
+
+  /// Restore the original mappers of the actors modified by ApplyProxies().
+  void RestoreMappers();
+
+  /// Release the graphics resources of the proxy mappers for \a window,
+  /// which must be called before the window is destroyed.
+  void ReleaseGraphicsResources(vtkWindow* window);
+
+  /// Remove all the proxies.
+  /// Cancels the proxies being built without waiting for them.
+  void Clear();
+
+  /// Number of actors rendered with a proxy by the last ApplyProxies().
+  vtkGetMacro(NumberOfProxyActors, int);
+  /// Number of triangles of the visible actors rendered after the last
+  /// ApplyProxies(), proxies included.
+  vtkGetMacro(NumberOfRenderedTriangles, vtkIdType);
+  /// Number of proxies being built.
+  int GetNumberOfPendingProxies();
+
+protected:
+  vtkSlicerLookingGlassLODCache();
+  ~vtkSlicerLookingGlassLODCache() override;
+
+  vtkIdType MinimumNumberOfTriangles;
+  int NumberOfProxyActors;
+  vtkIdType NumberOfRenderedTriangles;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkSlicerLookingGlassLODCache(const vtkSlicerLookingGlassLODCache&); // Not implemented
+  void operator=(const vtkSlicerLookingGlassLODCache&); // Not implemented
+};
+
+#endif
@@ -16,6 +16,7 @@
 ==============================================================================*/
 
 // LookingGlass Logic includes
+#include "vtkMRMLLookingGlassRenderStatistics.h"
 #include "vtkMRMLLookingGlassViewNode.h"
 #include "vtkSlicerLookingGlassLogic.h"
 
@@ -25,13 +26,29 @@
 // Slicer includes
 #include "vtkSlicerVolumeRenderingLogic.h"
 
+// VolumeRendering MRML includes
+#include <vtkMRMLVolumeRenderingDisplayNode.h>
+
 // VTK includes
 #include <vtkIntArray.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 
 // STD includes
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <set>
+#include <sstream>
+
+namespace
+{
+// Volume rendering sample distance is at most 10 times the volume spacing
+const double MinimumOversamplingFactor = 0.1;
+// The oversampling factor is rounded to this step so that the mappers
+// are not modified for each insignificant quality change.
+const double OversamplingFactorStep = 0.05;
+}
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerLookingGlassLogic);
@@ -55,6 +72,7 @@ vtkSlicerLookingGlassLogic::~vtkSlicerLookingGlassLogic()
 void vtkSlicerLookingGlassLogic::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "ShaderCacheDirectory: " << this->ShaderCacheDirectory << "\n";
 }
 
 //---------------------------------------------------------------------------
@@ -104,6 +122,11 @@ void vtkSlicerLookingGlassLogic
     {
     this->SetActiveViewNode(lgViewNode);
     }
+  else
+    {
+    // View node of another device
+    this->Modified();
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -119,16 +142,24 @@ void vtkSlicerLookingGlassLogic
     {
     this->SetActiveViewNode(nullptr);
     }
+  else
+    {
+    this->Modified();
+    }
 }
 
 //----------------------------------------------------------------------------
 void vtkSlicerLookingGlassLogic::OnMRMLSceneEndImport()
 {
-  if (this->ActiveViewNode != nullptr && this->ActiveViewNode->GetActive())
+  for (int n = 0; n < this->GetNumberOfLookingGlassViewNodes(); ++n)
     {
-    // Override the active flag and visibility flags, as LG connection is not restored on scene load
-    this->ActiveViewNode->SetActive(0);
-    this->ActiveViewNode->SetVisibility(0);
+    vtkMRMLLookingGlassViewNode* lgViewNode = this->GetNthLookingGlassViewNode(n);
+    if (lgViewNode->GetActive())
+      {
+      // Override the active flag and visibility flags, as LG connection is not restored on scene load
+      lgViewNode->SetActive(0);
+      lgViewNode->SetVisibility(0);
+      }
     }
 
   this->Modified();
@@ -140,8 +171,47 @@ vtkMRMLLookingGlassViewNode* vtkSlicerLookingGlassLogic::GetLookingGlassViewNode
   return this->ActiveViewNode;
 }
 
+//----------------------------------------------------------------------------
+vtkMRMLLookingGlassViewNode* vtkSlicerLookingGlassLogic::GetLookingGlassViewNodeForDevice(int deviceIndex)
+{
+  if (this->ActiveViewNode && this->ActiveViewNode->GetDeviceIndex() == deviceIndex)
+    {
+    return this->ActiveViewNode;
+    }
+  for (int n = 0; n < this->GetNumberOfLookingGlassViewNodes(); ++n)
+    {
+    vtkMRMLLookingGlassViewNode* lgViewNode = this->GetNthLookingGlassViewNode(n);
+    if (lgViewNode->GetDeviceIndex() == deviceIndex)
+      {
+      return lgViewNode;
+      }
+    }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerLookingGlassLogic::GetNumberOfLookingGlassViewNodes()
+{
+  if (!this->GetMRMLScene())
+    {
+    return 0;
+    }
+  return this->GetMRMLScene()->GetNumberOfNodesByClass("vtkMRMLLookingGlassViewNode");
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLLookingGlassViewNode* vtkSlicerLookingGlassLogic::GetNthLookingGlassViewNode(int n)
+{
+  if (!this->GetMRMLScene())
+    {
+    return nullptr;
+    }
+  return vtkMRMLLookingGlassViewNode::SafeDownCast(
+    this->GetMRMLScene()->GetNthNodeByClass(n, "vtkMRMLLookingGlassViewNode"));
+}
+
 //---------------------------------------------------------------------------
-vtkMRMLLookingGlassViewNode* vtkSlicerLookingGlassLogic::AddLookingGlassViewNode()
+vtkMRMLLookingGlassViewNode* vtkSlicerLookingGlassLogic::AddLookingGlassViewNode(int deviceIndex)
 {
   vtkMRMLScene* scene = this->GetMRMLScene();
   if (!scene)
@@ -150,18 +220,40 @@ vtkMRMLLookingGlassViewNode* vtkSlicerLookingGlassLogic::AddLookingGlassViewNode
     return nullptr;
     }
 
-  if (this->ActiveViewNode)
+  if (deviceIndex < 0)
+    {
+    vtkErrorMacro("AddLookingGlassViewNode: Invalid device index " << deviceIndex);
+    return nullptr;
+    }
+
+  vtkMRMLLookingGlassViewNode* existingViewNode = this->GetLookingGlassViewNodeForDevice(deviceIndex);
+  if (existingViewNode)
     {
     // There is already a usable VR node, return that
-    return this->ActiveViewNode;
+    return existingViewNode;
     }
 
   // Create LookingGlass view node. Use CreateNodeByClass so that node properties
   // can be overridden with default node properties defined in the scene.
   vtkSmartPointer<vtkMRMLLookingGlassViewNode> vrViewNode = vtkSmartPointer<vtkMRMLLookingGlassViewNode>::Take(
         vtkMRMLLookingGlassViewNode::SafeDownCast(scene->CreateNodeByClass("vtkMRMLLookingGlassViewNode")));
-  // We create the node as a singleton to make sure there is only one VR view node in the scene.
-  vrViewNode->SetSingletonTag("Active");
+  vrViewNode->SetDeviceIndex(deviceIndex);
+  // We create the node as a singleton to make sure there is only one VR view node per device in the scene.
+  // The view node of the first device is the active view node.
+  if (deviceIndex == 0)
+    {
+    vrViewNode->SetSingletonTag("Active");
+    }
+  else
+    {
+    std::stringstream singletonTag;
+    singletonTag << "Device" << deviceIndex;
+    vrViewNode->SetSingletonTag(singletonTag.str().c_str());
+    // Each device publishes its quilts to its own shared memory segment
+    std::stringstream publishingKey;
+    publishingKey << vrViewNode->GetQuiltPublishingKey() << deviceIndex;
+    vrViewNode->SetQuiltPublishingKey(publishingKey.str());
+    }
   // If a singleton node by that name exists already then it is overwritten
   // and pointer of that node is returned.
   vrViewNode = vtkMRMLLookingGlassViewNode::SafeDownCast(scene->AddNode(vrViewNode));
@@ -297,11 +389,17 @@ bool vtkSlicerLookingGlassLogic::GetLookingGlassActive()
 //---------------------------------------------------------------------------
 void vtkSlicerLookingGlassLogic::SetDefaultReferenceView()
 {
-  if (!this->ActiveViewNode)
+  this->SetDefaultReferenceView(this->ActiveViewNode);
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerLookingGlassLogic::SetDefaultReferenceView(vtkMRMLLookingGlassViewNode* lgViewNode)
+{
+  if (!lgViewNode)
     {
     return;
     }
-  if (this->ActiveViewNode->GetReferenceViewNode() != nullptr)
+  if (lgViewNode->GetReferenceViewNode() != nullptr)
     {
     // Reference view is already set, there is nothing to do
     return;
@@ -310,21 +408,132 @@ void vtkSlicerLookingGlassLogic::SetDefaultReferenceView()
     {
     return;
     }
+  std::set<vtkMRMLViewNode*> usedReferenceViewNodes;
+  for (int n = 0; n < this->GetNumberOfLookingGlassViewNodes(); ++n)
+    {
+    usedReferenceViewNodes.insert(this->GetNthLookingGlassViewNode(n)->GetReferenceViewNode());
+    }
   vtkSmartPointer<vtkCollection> nodes = vtkSmartPointer<vtkCollection>::Take(
       this->GetMRMLScene()->GetNodesByClass("vtkMRMLViewNode"));
+  vtkMRMLViewNode* referenceViewNode = nullptr;
   vtkMRMLViewNode* viewNode = nullptr;
   vtkCollectionSimpleIterator it;
   for (nodes->InitTraversal(it); (viewNode = vtkMRMLViewNode::SafeDownCast(
                                     nodes->GetNextItemAsObject(it)));)
     {
+    if (vtkMRMLLookingGlassViewNode::SafeDownCast(viewNode))
+      {
+      continue;
+      }
     if (viewNode->GetVisibility() && viewNode->IsMappedInLayout())
       {
       // Found a view node displayed in current layout, use this
-      break;
+      // unless another device already follows it
+      if (usedReferenceViewNodes.count(viewNode) == 0)
+        {
+        referenceViewNode = viewNode;
+        break;
+        }
+      if (!referenceViewNode || !referenceViewNode->IsMappedInLayout())
+        {
+        referenceViewNode = viewNode;
+        }
+      }
+    else if (!referenceViewNode)
+      {
+      referenceViewNode = viewNode;
       }
     }
   // Either use a view node displayed in current layout or just any 3D view node found in the scene
-  this->ActiveViewNode->SetAndObserveReferenceViewNode(viewNode);
+  lgViewNode->SetAndObserveReferenceViewNode(referenceViewNode);
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerLookingGlassLogic::StartQuiltPublishing(const std::string& key)
+{
+  vtkMRMLLookingGlassViewNode* viewNode = this->AddLookingGlassViewNode();
+  if (!viewNode)
+    {
+    vtkErrorMacro("StartQuiltPublishing failed: view node is not available");
+    return;
+    }
+  this->StartQuiltPublishing(viewNode, key);
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerLookingGlassLogic::StartQuiltPublishing(vtkMRMLLookingGlassViewNode* viewNode, const std::string& key)
+{
+  if (!viewNode)
+    {
+    vtkErrorMacro("StartQuiltPublishing failed: invalid view node");
+    return;
+    }
+  int wasModifying = viewNode->StartModify();
+  if (!key.empty())
+    {
+    viewNode->SetQuiltPublishingKey(key);
+    }
+  viewNode->SetQuiltPublishing(true);
+  viewNode->EndModify(wasModifying);
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerLookingGlassLogic::StopQuiltPublishing()
+{
+  this->StopQuiltPublishing(this->ActiveViewNode);
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerLookingGlassLogic::StopQuiltPublishing(vtkMRMLLookingGlassViewNode* viewNode)
+{
+  if (viewNode)
+    {
+    viewNode->SetQuiltPublishing(false);
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassLogic::GetQuiltPublishing()
+{
+  return this->GetQuiltPublishing(this->ActiveViewNode);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassLogic::GetQuiltPublishing(vtkMRMLLookingGlassViewNode* viewNode)
+{
+  return viewNode && viewNode->GetQuiltPublishing();
+}
+
+//-----------------------------------------------------------------------------
+double vtkSlicerLookingGlassLogic::GetLastQuiltPublishLatency()
+{
+  return this->GetLastQuiltPublishLatency(this->ActiveViewNode);
+}
+
+//-----------------------------------------------------------------------------
+double vtkSlicerLookingGlassLogic::GetLastQuiltPublishLatency(vtkMRMLLookingGlassViewNode* viewNode)
+{
+  if (!viewNode)
+    {
+    return 0.0;
+    }
+  return viewNode->GetRenderStatistics()->GetLastPublishLatency();
+}
+
+//-----------------------------------------------------------------------------
+double vtkSlicerLookingGlassLogic::GetMeanQuiltPublishLatency()
+{
+  return this->GetMeanQuiltPublishLatency(this->ActiveViewNode);
+}
+
+//-----------------------------------------------------------------------------
+double vtkSlicerLookingGlassLogic::GetMeanQuiltPublishLatency(vtkMRMLLookingGlassViewNode* viewNode)
+{
+  if (!viewNode)
+    {
+    return 0.0;
+    }
+  return viewNode->GetRenderStatistics()->GetMeanPublishLatency();
 }
 
 //-----------------------------------------------------------------------------
@@ -345,3 +554,36 @@ vtkMRMLLookingGlassViewNode* vtkSlicerLookingGlassLogic::GetDefaultLookingGlassV
     }
   return vtkMRMLLookingGlassViewNode::SafeDownCast(defaultNode);
 }
+
+//-----------------------------------------------------------------------------
+double vtkSlicerLookingGlassLogic::GetVolumeRenderingOversamplingFactor(vtkMRMLLookingGlassViewNode* viewNode, double quality)
+{
+  if (!viewNode || !this->VolumeRenderingLogic)
+    {
+    return 0.0;
+    }
+  if (viewNode->GetVolumeRenderingQuality() == vtkMRMLViewNode::Adaptive)
+    {
+    // Sample distances follow the desired update rate chosen by the user
+    return 0.0;
+    }
+  vtkMRMLVolumeRenderingDisplayNode* displayNode =
+    this->VolumeRenderingLogic->GetVolumeRenderingDisplayNodeForViewNode(viewNode);
+  if (!displayNode)
+    {
+    // No volume is rendered in the view
+    return 0.0;
+    }
+
+  double oversamplingFactor = viewNode->GetVolumeRenderingStillOversamplingFactor();
+  if (quality < 1.0)
+    {
+    oversamplingFactor = viewNode->GetVolumeRenderingInteractiveOversamplingFactor();
+    if (viewNode->GetVolumeRenderingAutoDownsampling())
+      {
+      oversamplingFactor *= std::max(quality, 0.0);
+      }
+    }
+  oversamplingFactor = std::floor(oversamplingFactor / OversamplingFactorStep + 0.5) * OversamplingFactorStep;
+  return std::max(oversamplingFactor, MinimumOversamplingFactor);
+}
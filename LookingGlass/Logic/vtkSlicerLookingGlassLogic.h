@@ -31,6 +31,7 @@
 
 // STD includes
 #include <cstdlib>
+#include <string>
 
 #include "vtkSlicerLookingGlassModuleLogicExport.h"
 
@@ -47,15 +48,25 @@ public:
   vtkTypeMacro(vtkSlicerLookingGlassLogic, vtkSlicerModuleLogic);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
-  /// Creates a singleton looking glass view node and adds it to the scene.
-  /// If there is a looking glass view node in the scene already then it just returns that.
-  /// If current view node is created, deleted, or modified then a Modified() event is invoked
-  /// for this logic class, to make it easy for modules to detect view changes.
-  vtkMRMLLookingGlassViewNode* AddLookingGlassViewNode();
+  /// Creates a singleton looking glass view node for the device \a deviceIndex and adds it to the scene.
+  /// If there is a looking glass view node for that device in the scene already then it just returns that.
+  /// The view node of the first device is the active view node.
+  /// If current view node is created, deleted, or modified, or if a view node of another device
+  /// is added or removed, then a Modified() event is invoked for this logic class, to make it
+  /// easy for modules to detect view changes.
+  vtkMRMLLookingGlassViewNode* AddLookingGlassViewNode(int deviceIndex = 0);
 
   /// Get active singleton looking glass view node
   vtkMRMLLookingGlassViewNode* GetLookingGlassViewNode();
 
+  /// Get the looking glass view node displayed by the device \a deviceIndex.
+  /// Return nullptr if there is none.
+  vtkMRMLLookingGlassViewNode* GetLookingGlassViewNodeForDevice(int deviceIndex);
+
+  /// Get all the looking glass view nodes of the scene, one per device.
+  int GetNumberOfLookingGlassViewNodes();
+  vtkMRMLLookingGlassViewNode* GetNthLookingGlassViewNode(int n);
+
   /// Retrieves the default VR view node from the scene. Creates it if does not exist.
   vtkMRMLLookingGlassViewNode* GetDefaultLookingGlassViewNode();
 
@@ -75,8 +86,60 @@ public:
   /// method has no effect.
   void SetDefaultReferenceView();
 
+  /// Set the first visible 3D view that is not the reference view of
+  /// another looking glass view as reference view for \a viewNode, so
+  /// that each device follows its own 3D view by default.
+  /// If a reference view has been already set then the
+  /// method has no effect.
+  void SetDefaultReferenceView(vtkMRMLLookingGlassViewNode* viewNode);
+
   /// Set volume rendering logic
   void SetVolumeRenderingLogic(vtkSlicerVolumeRenderingLogic* volumeRenderingLogic);
+  vtkGetObjectMacro(VolumeRenderingLogic, vtkSlicerVolumeRenderingLogic);
+
+  /// Return the volume rendering oversampling factor of the looking glass
+  /// view for rendering a frame with the given \a quality level (in the
+  /// [0, 1] range, 1 means full quality). The still oversampling factor is
+  /// used at full quality, the interactive oversampling factor otherwise,
+  /// scaled by the quality level if automatic downsampling is enabled.
+  /// Return 0 if no volume is rendered in the view, or if the volume
+  /// rendering quality of the view node is Adaptive: the mappers then adjust
+  /// their sample distance to the desired update rate of the render window.
+  /// The view node is not modified, the view applies the factor to its
+  /// volume mappers while rendering.
+  /// \sa vtkMRMLLookingGlassViewNode::GetVolumeRenderingStillOversamplingFactor
+  double GetVolumeRenderingOversamplingFactor(vtkMRMLLookingGlassViewNode* viewNode, double quality);
+
+  /// Start/stop publishing the quilts rendered in the looking glass view
+  /// \a viewNode to a shared memory ring buffer, which other processes can
+  /// map to read the frames live. If \a key is empty then the key of the
+  /// view node is used. Each device publishes to its own key by default.
+  /// Methods without a view node act on the view node of the first device,
+  /// which StartQuiltPublishing() adds if needed.
+  /// \sa vtkMRMLLookingGlassViewNode::SetQuiltPublishing
+  void StartQuiltPublishing(vtkMRMLLookingGlassViewNode* viewNode, const std::string& key = std::string());
+  void StartQuiltPublishing(const std::string& key = std::string());
+  void StopQuiltPublishing(vtkMRMLLookingGlassViewNode* viewNode);
+  void StopQuiltPublishing();
+  bool GetQuiltPublishing(vtkMRMLLookingGlassViewNode* viewNode);
+  bool GetQuiltPublishing();
+
+  /// Time (in seconds) from the end of the quilt rendering to the frame being
+  /// available in shared memory, for the last published frame and in average
+  /// over the recent frames of \a viewNode. Return 0 if no frame has been
+  /// published.
+  double GetLastQuiltPublishLatency(vtkMRMLLookingGlassViewNode* viewNode);
+  double GetLastQuiltPublishLatency();
+  double GetMeanQuiltPublishLatency(vtkMRMLLookingGlassViewNode* viewNode);
+  double GetMeanQuiltPublishLatency();
+
+  /// Directory where the linked shader programs of the looking glass render
+  /// windows are cached, so that they are not compiled again when a window
+  /// is created or the application is restarted. Empty disables the cache,
+  /// which is the default. It applies to render windows created afterwards.
+  /// \sa vtkSlicerLookingGlassShaderCache
+  vtkSetMacro(ShaderCacheDirectory, std::string);
+  vtkGetMacro(ShaderCacheDirectory, std::string);
 
 protected:
   vtkSlicerLookingGlassLogic();
@@ -100,6 +163,9 @@ protected:
   /// Volume rendering logic
   vtkSlicerVolumeRenderingLogic* VolumeRenderingLogic;
 
+  /// Program binary cache directory of the looking glass render windows
+  std::string ShaderCacheDirectory;
+
 private:
 
   vtkSlicerLookingGlassLogic(const vtkSlicerLookingGlassLogic&); // Not implemented
@@ -0,0 +1,404 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// LookingGlass Logic includes
+#include "vtkSlicerLookingGlassMultiViewCuller.h"
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkCallbackCommand.h>
+#include <vtkObjectFactory.h>
+#include <vtkOpenGLPolyDataMapper.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkPolyData.h>
+#include <vtkProperty.h>
+#include <vtkShaderProgram.h>
+#include <vtkShaderProperty.h>
+#include <vtkUniforms.h>
+#include <vtk_glew.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+const char* NumberOfViewsUniform = "lookingGlassNumberOfViews";
+const char* ViewCorrectionsUniform = "lookingGlassViewCorrections";
+
+/// Upper bound of the number of views of a pass, GL_MAX_GEOMETRY_SHADER_INVOCATIONS
+/// is at least 32 and GL_MAX_VIEWPORTS at least 16.
+const int MaximumNumberOfViewsLimit = 32;
+
+/// Geometry shader of the actors of the multi-view pass. The VTK::...
+/// placeholders pass the outputs of the vertex shader of the mapper to its
+/// fragment shader, as in the geometry shaders of the VTK poly data mappers.
+const char* GeometryShaderTemplate =
+  "//VTK::System::Dec\n"
+  "#extension GL_ARB_gpu_shader5 : require\n"
+  "#extension GL_ARB_viewport_array : require\n"
+  "\n"
+  "//VTK::PositionVC::Dec\n"
+  "//VTK::PrimID::Dec\n"
+  "//VTK::Color::Dec\n"
+  "//VTK::Normal::Dec\n"
+  "//VTK::Light::Dec\n"
+  "//VTK::TCoord::Dec\n"
+  "//VTK::Picking::Dec\n"
+  "//VTK::DepthPeeling::Dec\n"
+  "//VTK::Clip::Dec\n"
+  "\n"
+  "// Number of views of the multi-view pass, 0 outside of the pass\n"
+  "uniform int lookingGlassNumberOfViews;\n"
+  "// Clip coordinates of the renderer camera to clip coordinates of each view\n"
+  "uniform mat4 lookingGlassViewCorrections[@NUMBER_OF_VIEWS@];\n"
+  "\n"
+  "layout(triangles, invocations = @NUMBER_OF_VIEWS@) in;\n"
+  "layout(triangle_strip, max_vertices = 3) out;\n"
+  "\n"
+  "void main()\n"
+  "{\n"
+  "  bool multiView = lookingGlassNumberOfViews > 0;\n"
+  "  if (gl_InvocationID >= (multiView ? lookingGlassNumberOfViews : 1))\n"
+  "  {\n"
+  "    return;\n"
+  "  }\n"
+  "  for (int i = 0; i < 3; i++)\n"
+  "  {\n"
+  "    //VTK::PrimID::Impl\n"
+  "    //VTK::Clip::Impl\n"
+  "    //VTK::Color::Impl\n"
+  "    //VTK::Normal::Impl\n"
+  "    //VTK::Light::Impl\n"
+  "    //VTK::TCoord::Impl\n"
+  "    //VTK::DepthPeeling::Impl\n"
+  "    //VTK::Picking::Impl\n"
+  "    //VTK::PositionVC::Impl\n"
+  "    gl_Position = multiView\n"
+  "      ? lookingGlassViewCorrections[gl_InvocationID] * gl_in[i].gl_Position\n"
+  "      : gl_in[i].gl_Position;\n"
+  "    // Viewport 0 is set by the renderer, the views use the next ones\n"
+  "    gl_ViewportIndex = multiView ? gl_InvocationID + 1 : 0;\n"
+  "    EmitVertex();\n"
+  "  }\n"
+  "  EndPrimitive();\n"
+  "}\n";
+
+//----------------------------------------------------------------------------
+/// Column-major identity matrices of \a numberOfViews views.
+std::vector<float> identityMatrices(int numberOfViews)
+{
+  std::vector<float> matrices(16 * static_cast<size_t>(numberOfViews), 0.0f);
+  for (int view = 0; view < numberOfViews; ++view)
+    {
+    for (int i = 0; i < 4; ++i)
+      {
+      matrices[16 * view + 5 * i] = 1.0f;
+      }
+    }
+  return matrices;
+}
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerLookingGlassMultiViewCuller);
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassMultiViewCuller::vtkSlicerLookingGlassMultiViewCuller()
+  : Pass(PassAllProps)
+  , MaximumNumberOfViews(-1)
+  , NumberOfViews(0)
+  , NumberOfMultiViewProps(0)
+  , NumberOfTileProps(0)
+{
+  this->ViewportsCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->ViewportsCallback->SetClientData(this);
+  this->ViewportsCallback->SetCallback(vtkSlicerLookingGlassMultiViewCuller::SetViewportsCallback);
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassMultiViewCuller::~vtkSlicerLookingGlassMultiViewCuller()
+{
+  this->EndMultiViewPass();
+  this->RemoveMultiViewShaders();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassMultiViewCuller::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Pass: " << this->Pass << "\n";
+  os << indent << "MaximumNumberOfViews: " << this->MaximumNumberOfViews << "\n";
+  os << indent << "NumberOfMultiViewProps: " << this->NumberOfMultiViewProps << "\n";
+  os << indent << "NumberOfTileProps: " << this->NumberOfTileProps << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerLookingGlassMultiViewCuller::Initialize(vtkRenderWindow* renderWindow)
+{
+  // Shaders of another context may have another number of views
+  this->RemoveMultiViewShaders();
+  this->MaximumNumberOfViews = 0;
+  vtkOpenGLRenderWindow* openGLRenderWindow = vtkOpenGLRenderWindow::SafeDownCast(renderWindow);
+  if (!openGLRenderWindow)
+    {
+    return this->MaximumNumberOfViews;
+    }
+  openGLRenderWindow->MakeCurrent();
+  if (!GLEW_ARB_gpu_shader5 || !GLEW_ARB_viewport_array || !glViewportArrayv)
+    {
+    vtkDebugMacro("Initialize: geometry shader invocations or viewport arrays are not supported");
+    return this->MaximumNumberOfViews;
+    }
+  GLint maximumNumberOfViewports = 0;
+  GLint maximumNumberOfInvocations = 0;
+  glGetIntegerv(GL_MAX_VIEWPORTS, &maximumNumberOfViewports);
+  glGetIntegerv(GL_MAX_GEOMETRY_SHADER_INVOCATIONS, &maximumNumberOfInvocations);
+  int maximumNumberOfViews = std::min(MaximumNumberOfViewsLimit,
+    std::min(static_cast<int>(maximumNumberOfViewports) - 1, static_cast<int>(maximumNumberOfInvocations)));
+  if (maximumNumberOfViews < 2)
+    {
+    return this->MaximumNumberOfViews;
+    }
+  this->MaximumNumberOfViews = maximumNumberOfViews;
+  this->GeometryShaderCode = GeometryShaderTemplate;
+  vtkShaderProgram::Substitute(this->GeometryShaderCode, "@NUMBER_OF_VIEWS@",
+    std::to_string(this->MaximumNumberOfViews), /* all= */ true);
+  return this->MaximumNumberOfViews;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassMultiViewCuller::SetViews(int numberOfViews, const float* corrections, const float* viewports)
+{
+  if (numberOfViews < 1 || numberOfViews > this->MaximumNumberOfViews)
+    {
+    vtkErrorMacro("SetViews: invalid number of views " << numberOfViews);
+    return;
+    }
+  this->NumberOfViews = numberOfViews;
+  // Unused views keep the identity
+  this->Corrections = identityMatrices(this->MaximumNumberOfViews);
+  std::copy(corrections, corrections + 16 * numberOfViews, this->Corrections.begin());
+  this->Viewports.assign(viewports, viewports + 4 * numberOfViews);
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassMultiViewCuller::EndMultiViewPass()
+{
+  for (const std::pair<vtkWeakPointer<vtkMapper>, unsigned long>& observedMapper : this->ObservedMappers)
+    {
+    if (observedMapper.first)
+      {
+      observedMapper.first->RemoveObserver(observedMapper.second);
+      }
+    }
+  this->ObservedMappers.clear();
+  for (std::map<vtkActor*, vtkWeakPointer<vtkActor> >::iterator it = this->ShaderActors.begin();
+    it != this->ShaderActors.end();)
+    {
+    if (!it->second)
+      {
+      it = this->ShaderActors.erase(it);
+      continue;
+      }
+    if (this->MultiViewProps.count(it->first))
+      {
+      // Other renders draw each triangle once, with the renderer camera
+      it->second->GetShaderProperty()->GetGeometryCustomUniforms()->SetUniformi(NumberOfViewsUniform, 0);
+      }
+    ++it;
+    }
+  this->NumberOfViews = 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassMultiViewCuller::IsMultiViewProp(vtkProp* prop)
+{
+  vtkActor* actor = vtkActor::SafeDownCast(prop);
+  // Subclasses such as followers orient the actor to the camera of each
+  // view, or select their mapper when rendered.
+  if (!actor || strcmp(actor->GetClassName(), "vtkOpenGLActor") != 0
+    || actor->HasTranslucentPolygonalGeometry())
+    {
+    return false;
+    }
+  // Composite mappers render their blocks with helper mappers
+  vtkOpenGLPolyDataMapper* mapper = vtkOpenGLPolyDataMapper::SafeDownCast(actor->GetMapper());
+  if (!mapper || mapper->IsA("vtkCompositePolyDataMapper2"))
+    {
+    return false;
+    }
+  // The geometry shader only takes triangles
+  vtkPolyData* polyData = mapper->GetInput();
+  if (!polyData || polyData->GetNumberOfVerts() > 0 || polyData->GetNumberOfLines() > 0
+    || polyData->GetNumberOfPolys() + polyData->GetNumberOfStrips() == 0)
+    {
+    return false;
+    }
+  vtkProperty* property = actor->GetProperty();
+  if (property->GetRepresentation() != VTK_SURFACE || property->GetEdgeVisibility()
+    || property->GetVertexVisibility())
+    {
+    return false;
+    }
+  vtkShaderProperty* shaderProperty = actor->GetShaderProperty();
+  return !shaderProperty->HasGeometryShaderCode()
+    || this->GeometryShaderCode == shaderProperty->GetGeometryShaderCode();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassMultiViewCuller::AddMultiViewShader(vtkActor* actor)
+{
+  std::map<vtkActor*, vtkWeakPointer<vtkActor> >::iterator it = this->ShaderActors.find(actor);
+  if (it != this->ShaderActors.end() && it->second == actor)
+    {
+    return;
+    }
+  // The uniforms are declared by the shader, and set by the mapper for each draw
+  vtkShaderProperty* shaderProperty = actor->GetShaderProperty();
+  shaderProperty->SetGeometryShaderCode(this->GeometryShaderCode.c_str());
+  vtkUniforms* uniforms = shaderProperty->GetGeometryCustomUniforms();
+  uniforms->SetUniformi(NumberOfViewsUniform, 0);
+  std::vector<float> identities = identityMatrices(this->MaximumNumberOfViews);
+  uniforms->SetUniformMatrix4x4v(ViewCorrectionsUniform, this->MaximumNumberOfViews, identities.data());
+  this->ShaderActors[actor] = actor;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassMultiViewCuller::RemoveMultiViewShader(vtkActor* actor)
+{
+  std::map<vtkActor*, vtkWeakPointer<vtkActor> >::iterator it = this->ShaderActors.find(actor);
+  if (it == this->ShaderActors.end())
+    {
+    return;
+    }
+  if (it->second == actor)
+    {
+    vtkShaderProperty* shaderProperty = actor->GetShaderProperty();
+    shaderProperty->SetGeometryShaderCode(nullptr);
+    shaderProperty->GetGeometryCustomUniforms()->RemoveUniform(NumberOfViewsUniform);
+    shaderProperty->GetGeometryCustomUniforms()->RemoveUniform(ViewCorrectionsUniform);
+    }
+  this->ShaderActors.erase(it);
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassMultiViewCuller::RemoveMultiViewShaders()
+{
+  while (!this->ShaderActors.empty())
+    {
+    this->RemoveMultiViewShader(this->ShaderActors.begin()->first);
+    }
+  this->MultiViewProps.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassMultiViewCuller::RemoveInvalidMultiViewShaders(vtkProp** propList, int listLength)
+{
+  if (this->ShaderActors.empty())
+    {
+    return;
+    }
+  for (int i = 0; i < listLength; ++i)
+    {
+    vtkActor* actor = vtkActor::SafeDownCast(propList[i]);
+    if (actor && this->ShaderActors.count(actor) && !this->IsMultiViewProp(actor))
+      {
+      // e.g. wireframe actors, whose lines cannot be drawn by the shader
+      this->RemoveMultiViewShader(actor);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerLookingGlassMultiViewCuller::Cull(vtkRenderer* vtkNotUsed(ren), vtkProp** propList, int& listLength,
+  int& vtkNotUsed(initialized))
+{
+  if (this->Pass == PassBackground)
+    {
+    listLength = 0;
+    }
+  else if (this->Pass == PassMultiView)
+    {
+    this->MultiViewProps.clear();
+    this->NumberOfMultiViewProps = 0;
+    this->NumberOfTileProps = 0;
+    for (int i = 0; i < listLength; ++i)
+      {
+      vtkProp* prop = propList[i];
+      vtkActor* actor = vtkActor::SafeDownCast(prop);
+      if (this->NumberOfViews == 0 || !this->IsMultiViewProp(prop))
+        {
+        if (actor)
+          {
+          this->RemoveMultiViewShader(actor);
+          }
+        ++this->NumberOfTileProps;
+        continue;
+        }
+      this->AddMultiViewShader(actor);
+      vtkUniforms* uniforms = actor->GetShaderProperty()->GetGeometryCustomUniforms();
+      uniforms->SetUniformi(NumberOfViewsUniform, this->NumberOfViews);
+      uniforms->SetUniformMatrix4x4v(ViewCorrectionsUniform, this->MaximumNumberOfViews, this->Corrections.data());
+      // Mappers are observed when the actor is rendered, as the level of
+      // detail may replace them in the renderer StartEvent.
+      vtkMapper* mapper = actor->GetMapper();
+      bool observed = false;
+      for (const std::pair<vtkWeakPointer<vtkMapper>, unsigned long>& observedMapper : this->ObservedMappers)
+        {
+        observed = observed || observedMapper.first == mapper;
+        }
+      if (!observed)
+        {
+        this->ObservedMappers.push_back(std::make_pair(vtkWeakPointer<vtkMapper>(mapper),
+          mapper->AddObserver(vtkCommand::UpdateShaderEvent, this->ViewportsCallback)));
+        }
+      this->MultiViewProps.insert(prop);
+      propList[this->NumberOfMultiViewProps++] = prop;
+      }
+    listLength = this->NumberOfMultiViewProps;
+    }
+  else
+    {
+    int numberOfProps = 0;
+    for (int i = 0; i < listLength; ++i)
+      {
+      if (this->Pass != PassTiles || this->MultiViewProps.find(propList[i]) == this->MultiViewProps.end())
+        {
+        propList[numberOfProps++] = propList[i];
+        }
+      }
+    listLength = numberOfProps;
+    this->RemoveInvalidMultiViewShaders(propList, listLength);
+    }
+  // Render time is evenly distributed among the props
+  return static_cast<double>(listLength);
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassMultiViewCuller::SetViewportsCallback(vtkObject* vtkNotUsed(caller),
+  unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  vtkSlicerLookingGlassMultiViewCuller* self = static_cast<vtkSlicerLookingGlassMultiViewCuller*>(clientData);
+  if (self->Pass != PassMultiView || self->NumberOfViews == 0)
+    {
+    return;
+    }
+  // The mapper is about to draw with the program of the geometry shader,
+  // the renderer camera has set all the viewports to the renderer viewport.
+  glViewportArrayv(1, self->NumberOfViews, self->Viewports.data());
+}
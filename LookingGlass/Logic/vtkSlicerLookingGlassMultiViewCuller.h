@@ -0,0 +1,160 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerLookingGlassMultiViewCuller_h
+#define __vtkSlicerLookingGlassMultiViewCuller_h
+
+// VTK includes
+#include <vtkCuller.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+#include "vtkSlicerLookingGlassModuleLogicExport.h"
+
+// STD includes
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+class vtkActor;
+class vtkCallbackCommand;
+class vtkMapper;
+class vtkProp;
+class vtkRenderer;
+class vtkRenderWindow;
+
+/// \brief Select the props of the passes of the multi-view rendering of a quilt.
+///
+/// Opaque poly data actors, such as the models and the segmentations, are
+/// rendered once for several views of the quilt instead of once per view.
+/// A geometry shader instanced once per view (GL_ARB_gpu_shader5) multiplies
+/// each triangle by the matrix from the clip coordinates of the renderer
+/// camera to the clip coordinates of the view, and emits it in the viewport
+/// of the view (GL_ARB_viewport_array).
+///
+/// The culler selects the props rendered by each pass of
+/// vtkSlicerLookingGlassQuiltRenderer:
+/// - PassBackground: no prop, the renderer only clears the viewport of a view.
+/// - PassMultiView: the opaque poly data actors, rendered for all the views
+///   set by SetViews(). The geometry shader is set on their shader property.
+/// - PassTiles: the other props, rendered in each view on top of the
+///   multi-view pass.
+/// - PassAllProps: all the props.
+///
+/// Actors keep the geometry shader after the multi-view pass: outside of it
+/// the shader emits each triangle once, unchanged. The shader is removed from
+/// the actors that can no longer be rendered by the multi-view pass (e.g.
+/// translucent or wireframe actors) when a pass finds them, and from all the
+/// actors by RemoveMultiViewShaders().
+class VTK_SLICER_LOOKINGGLASS_MODULE_LOGIC_EXPORT vtkSlicerLookingGlassMultiViewCuller : public vtkCuller
+{
+public:
+  static vtkSlicerLookingGlassMultiViewCuller* New();
+  vtkTypeMacro(vtkSlicerLookingGlassMultiViewCuller, vtkCuller);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum Pass
+  {
+    PassAllProps = 0,
+    PassBackground,
+    PassMultiView,
+    PassTiles,
+    Pass_Last
+  };
+
+  /// Pass of the next render. Default is PassAllProps.
+  vtkSetClampMacro(Pass, int, PassAllProps, Pass_Last - 1);
+  vtkGetMacro(Pass, int);
+
+  /// Check that the OpenGL context of \a renderWindow supports the
+  /// multi-view pass. The render window must have been rendered.
+  /// Return the maximum number of views of a multi-view pass.
+  int Initialize(vtkRenderWindow* renderWindow);
+
+  /// Maximum number of views of a multi-view pass, 0 if the OpenGL context
+  /// does not support it and -1 until Initialize() is called.
+  vtkGetMacro(MaximumNumberOfViews, int);
+
+  /// Set the views of the next multi-view pass.
+  /// \a corrections contains a column-major 4x4 matrix per view, from the
+  /// clip coordinates of the renderer camera to the clip coordinates of the
+  /// view. \a viewports contains the x, y, width and height (in pixels) of
+  /// the viewport of each view.
+  void SetViews(int numberOfViews, const float* corrections, const float* viewports);
+
+  /// Restore the actors of the multi-view pass to the renderer camera.
+  /// Must be called after rendering the multi-view pass.
+  void EndMultiViewPass();
+
+  /// Remove the geometry shader from all the actors.
+  void RemoveMultiViewShaders();
+
+  /// Number of props rendered by the last multi-view pass, and number of
+  /// props it left to the tile pass.
+  vtkGetMacro(NumberOfMultiViewProps, int);
+  vtkGetMacro(NumberOfTileProps, int);
+
+  /// Remove the props not rendered by the current pass from \a propList.
+  double Cull(vtkRenderer* ren, vtkProp** propList, int& listLength, int& initialized) override;
+
+  /// Return true if \a prop can be rendered by the multi-view pass:
+  /// an opaque actor of triangles rendered as a surface by an OpenGL poly
+  /// data mapper, without a custom geometry shader.
+  bool IsMultiViewProp(vtkProp* prop);
+
+protected:
+  vtkSlicerLookingGlassMultiViewCuller();
+  ~vtkSlicerLookingGlassMultiViewCuller() override;
+
+  /// Set the geometry shader on the shader property of \a actor.
+  void AddMultiViewShader(vtkActor* actor);
+  /// Remove the geometry shader of \a actor, if it has been set.
+  void RemoveMultiViewShader(vtkActor* actor);
+  /// Remove the geometry shader of the props of \a propList that can no
+  /// longer be rendered by the multi-view pass.
+  void RemoveInvalidMultiViewShaders(vtkProp** propList, int listLength);
+
+  /// Set the viewports of the views before a mapper draws the actors of
+  /// the multi-view pass, as the renderer sets all the viewports to its own.
+  static void SetViewportsCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
+
+  int Pass;
+  int MaximumNumberOfViews;
+  std::string GeometryShaderCode;
+
+  int NumberOfViews;
+  std::vector<float> Corrections;
+  std::vector<float> Viewports;
+
+  int NumberOfMultiViewProps;
+  int NumberOfTileProps;
+  /// Props of the last multi-view pass, culled by the tile pass
+  std::unordered_set<vtkProp*> MultiViewProps;
+  /// Actors whose shader property has the geometry shader
+  std::map<vtkActor*, vtkWeakPointer<vtkActor> > ShaderActors;
+  /// Mappers observed during the multi-view pass
+  std::vector<std::pair<vtkWeakPointer<vtkMapper>, unsigned long> > ObservedMappers;
+  vtkSmartPointer<vtkCallbackCommand> ViewportsCallback;
+
+private:
+  vtkSlicerLookingGlassMultiViewCuller(const vtkSlicerLookingGlassMultiViewCuller&); // Not implemented
+  void operator=(const vtkSlicerLookingGlassMultiViewCuller&); // Not implemented
+};
+
+#endif
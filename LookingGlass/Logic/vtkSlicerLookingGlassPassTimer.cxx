@@ -0,0 +1,242 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// LookingGlass Logic includes
+#include "vtkSlicerLookingGlassPassTimer.h"
+
+// LookingGlass MRML includes
+#include "vtkMRMLLookingGlassRenderStatistics.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+#include <vtkRenderTimerLog.h>
+#include <vtkRenderWindow.h>
+
+// STD includes
+#include <string>
+
+namespace
+{
+const char* TileEventName = "vtkSlicerLookingGlassPassTimer::Tile";
+const char* QuiltEventName = "vtkSlicerLookingGlassPassTimer::Quilt";
+
+/// Substrings of the names of the events logged by VTK for the passes
+const char* VolumePassName = "Volum";
+const char* TranslucentPassName = "Translucent";
+
+/// Quilts of the virtual device are rendered with one render per tile,
+/// the timer log must keep the renders of a few quilts.
+const unsigned int TimerLogFrameLimit = 1024;
+
+//----------------------------------------------------------------------------
+/// Add the time of \a event and its children to the tile, volume and
+/// translucent passes of \a passTimes. Return the volume time of the
+/// event, so that translucent passes exclude the volumes they render.
+double addEventTime(const vtkRenderTimerLog::Event& event, double* passTimes, bool inTranslucentPass)
+{
+  double elapsedTime = event.ElapsedTimeSeconds();
+  if (event.Name.find(VolumePassName) != std::string::npos)
+    {
+    passTimes[vtkMRMLLookingGlassRenderStatistics::GPUPassVolume] += elapsedTime;
+    return elapsedTime;
+    }
+  bool translucentPass = !inTranslucentPass && event.Name.find(TranslucentPassName) != std::string::npos;
+  double volumeTime = 0.0;
+  for (const vtkRenderTimerLog::Event& child : event.Events)
+    {
+    volumeTime += addEventTime(child, passTimes, inTranslucentPass || translucentPass);
+    }
+  if (event.Name == TileEventName)
+    {
+    passTimes[vtkMRMLLookingGlassRenderStatistics::GPUPassTiles] += elapsedTime;
+    }
+  else if (translucentPass)
+    {
+    passTimes[vtkMRMLLookingGlassRenderStatistics::GPUPassTranslucent] += elapsedTime - volumeTime;
+    }
+  return volumeTime;
+}
+
+//----------------------------------------------------------------------------
+/// Return the time of the tile events of \a event and its children.
+double tileTime(const vtkRenderTimerLog::Event& event)
+{
+  if (event.Name == TileEventName)
+    {
+    return event.ElapsedTimeSeconds();
+    }
+  double time = 0.0;
+  for (const vtkRenderTimerLog::Event& child : event.Events)
+    {
+    time += tileTime(child);
+    }
+  return time;
+}
+}
+
+//----------------------------------------------------------------------------
+class vtkSlicerLookingGlassPassTimer::vtkInternal
+{
+public:
+  vtkInternal()
+  {
+    this->ClearPassTimes();
+  }
+  void ClearPassTimes()
+  {
+    for (int pass = 0; pass < vtkMRMLLookingGlassRenderStatistics::GPUPass_Last; ++pass)
+      {
+      this->PassTimes[pass] = 0.0;
+      }
+  }
+
+  /// Pass times of the quilt whose events are being collected
+  double PassTimes[vtkMRMLLookingGlassRenderStatistics::GPUPass_Last];
+};
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerLookingGlassPassTimer);
+vtkCxxSetObjectMacro(vtkSlicerLookingGlassPassTimer, RenderWindow, vtkRenderWindow);
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassPassTimer::vtkSlicerLookingGlassPassTimer()
+  : RenderWindow(nullptr)
+  , Enabled(false)
+  , TileInProgress(false)
+  , Internal(new vtkInternal)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassPassTimer::~vtkSlicerLookingGlassPassTimer()
+{
+  this->SetEnabled(false);
+  this->SetRenderWindow(nullptr);
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassPassTimer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "RenderWindow: " << this->RenderWindow << "\n";
+  os << indent << "Enabled: " << (this->Enabled ? "true" : "false") << "\n";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkSlicerLookingGlassPassTimer::GetTileEventName()
+{
+  return TileEventName;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkSlicerLookingGlassPassTimer::GetQuiltEventName()
+{
+  return QuiltEventName;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassPassTimer::SetEnabled(bool enabled)
+{
+  if (this->Enabled == enabled)
+    {
+    return;
+    }
+  this->Enabled = enabled;
+  this->TileInProgress = false;
+  this->Internal->ClearPassTimes();
+  if (this->RenderWindow)
+    {
+    vtkRenderTimerLog* timer = this->RenderWindow->GetRenderTimer();
+    timer->SetFrameLimit(TimerLogFrameLimit);
+    timer->SetLoggingEnabled(enabled && timer->IsSupported());
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassPassTimer::IsSupported()
+{
+  return this->RenderWindow && this->RenderWindow->GetRenderTimer()->IsSupported();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassPassTimer::BeginTile()
+{
+  if (!this->Enabled || !this->RenderWindow || this->TileInProgress)
+    {
+    return;
+    }
+  this->RenderWindow->GetRenderTimer()->MarkStartEvent(TileEventName);
+  this->TileInProgress = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassPassTimer::EndTile()
+{
+  if (!this->TileInProgress || !this->RenderWindow)
+    {
+    return;
+    }
+  this->RenderWindow->GetRenderTimer()->MarkEndEvent();
+  this->TileInProgress = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassPassTimer::EndQuilt()
+{
+  if (!this->Enabled || !this->RenderWindow)
+    {
+    return;
+    }
+  // Empty event marking the end of the quilt in the last render
+  vtkRenderTimerLog* timer = this->RenderWindow->GetRenderTimer();
+  timer->MarkStartEvent(QuiltEventName);
+  timer->MarkEndEvent();
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerLookingGlassPassTimer::CollectQuilts(vtkMRMLLookingGlassRenderStatistics* statistics)
+{
+  if (!this->Enabled || !this->RenderWindow || !statistics)
+    {
+    return 0;
+    }
+  vtkRenderTimerLog* timer = this->RenderWindow->GetRenderTimer();
+  double* passTimes = this->Internal->PassTimes;
+  int numberOfQuilts = 0;
+  // Only frames whose queries are available are popped, the GPU is not waited for
+  while (timer->FrameReady())
+    {
+    vtkRenderTimerLog::Frame frame = timer->PopFirstReadyFrame();
+    for (const vtkRenderTimerLog::Event& event : frame.Events)
+      {
+      if (event.Name == QuiltEventName)
+        {
+        statistics->AddGPUFrame(passTimes);
+        this->Internal->ClearPassTimes();
+        ++numberOfQuilts;
+        continue;
+        }
+      addEventTime(event, passTimes, false);
+      // Time spent in the render window outside of the tiles
+      passTimes[vtkMRMLLookingGlassRenderStatistics::GPUPassComposition] +=
+        event.ElapsedTimeSeconds() - tileTime(event);
+      }
+    }
+  return numberOfQuilts;
+}
@@ -0,0 +1,99 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerLookingGlassPassTimer_h
+#define __vtkSlicerLookingGlassPassTimer_h
+
+// VTK includes
+#include <vtkObject.h>
+
+#include "vtkSlicerLookingGlassModuleLogicExport.h"
+
+class vtkMRMLLookingGlassRenderStatistics;
+class vtkRenderWindow;
+
+/// \brief Measure the GPU time of the render passes of the quilts.
+///
+/// Uses the render timer log of the render window, which brackets the
+/// logged events with OpenGL timer queries. Results become available a few
+/// frames after the rendering and are collected without waiting for the GPU.
+///
+/// The renderer pass of each quilt tile is logged between BeginTile() and
+/// EndTile(). The volume and translucent passes are identified by the names
+/// of the events logged by the VTK renderer within the tiles. The time of
+/// the other events of the render window, i.e. the light field composition
+/// and presentation for devices and the quilt read back for the virtual
+/// device, is the composition time. EndQuilt() marks the end of a quilt,
+/// which may be rendered by several renders of the render window.
+///
+/// Timer queries measure the GPU timestamps at the beginning and end of the
+/// events, so GPU idle time within an event (e.g. waiting for the CPU to
+/// submit commands) is included.
+class VTK_SLICER_LOOKINGGLASS_MODULE_LOGIC_EXPORT vtkSlicerLookingGlassPassTimer : public vtkObject
+{
+public:
+  static vtkSlicerLookingGlassPassTimer* New();
+  vtkTypeMacro(vtkSlicerLookingGlassPassTimer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Render window rendering the quilts.
+  void SetRenderWindow(vtkRenderWindow* renderWindow);
+  vtkGetObjectMacro(RenderWindow, vtkRenderWindow);
+
+  /// Log the render events. Default is false.
+  /// Timer queries are not supported by all OpenGL implementations.
+  void SetEnabled(bool enabled);
+  vtkGetMacro(Enabled, bool);
+  vtkBooleanMacro(Enabled, bool);
+
+  /// Return true if the render window supports timer queries.
+  bool IsSupported();
+
+  /// Bracket the renderer pass of a tile.
+  void BeginTile();
+  void EndTile();
+
+  /// Mark the end of a quilt, the passes logged since the end of the
+  /// previous quilt are summed into the pass times of the quilt.
+  void EndQuilt();
+
+  /// Add the pass times of the quilts whose timer queries are available
+  /// to \a statistics. Return the number of added quilts.
+  int CollectQuilts(vtkMRMLLookingGlassRenderStatistics* statistics);
+
+  /// Name of the events logged for each tile and each quilt
+  static const char* GetTileEventName();
+  static const char* GetQuiltEventName();
+
+protected:
+  vtkSlicerLookingGlassPassTimer();
+  ~vtkSlicerLookingGlassPassTimer() override;
+
+  vtkRenderWindow* RenderWindow;
+  bool Enabled;
+  /// Set while a tile event is logged
+  bool TileInProgress;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkSlicerLookingGlassPassTimer(const vtkSlicerLookingGlassPassTimer&); // Not implemented
+  void operator=(const vtkSlicerLookingGlassPassTimer&); // Not implemented
+};
+
+#endif
@@ -0,0 +1,200 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// LookingGlass Logic includes
+#include "vtkSlicerLookingGlassQuiltCuller.h"
+#include "vtkSlicerLookingGlassQuiltRenderer.h"
+
+// VTK includes
+#include <vtkCamera.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkProp.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderer.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerLookingGlassQuiltCuller);
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassQuiltCuller::vtkSlicerLookingGlassQuiltCuller()
+  : ViewCone(40.0)
+  , DisplayAspect(0.75)
+  , UseClippingLimits(false)
+  , NearClippingLimit(0.8)
+  , FarClippingLimit(1.2)
+  , NumberOfVisibleProps(0)
+  , NumberOfCulledProps(0)
+{
+  this->LeftCamera = vtkSmartPointer<vtkCamera>::New();
+  this->RightCamera = vtkSmartPointer<vtkCamera>::New();
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassQuiltCuller::~vtkSlicerLookingGlassQuiltCuller() = default;
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassQuiltCuller::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ViewCone: " << this->ViewCone << "\n";
+  os << indent << "DisplayAspect: " << this->DisplayAspect << "\n";
+  os << indent << "UseClippingLimits: " << (this->UseClippingLimits ? "true" : "false") << "\n";
+  os << indent << "NearClippingLimit: " << this->NearClippingLimit << "\n";
+  os << indent << "FarClippingLimit: " << this->FarClippingLimit << "\n";
+  os << indent << "NumberOfVisibleProps: " << this->NumberOfVisibleProps << "\n";
+  os << indent << "NumberOfCulledProps: " << this->NumberOfCulledProps << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassQuiltCuller::BeginQuilt(vtkRenderer* renderer)
+{
+  this->CulledProps.clear();
+  this->NumberOfVisibleProps = 0;
+  this->NumberOfCulledProps = 0;
+  vtkCamera* camera = renderer ? renderer->GetActiveCamera() : nullptr;
+  if (!camera)
+    {
+    return;
+    }
+
+  // A point is outside of all the views if it is outside of the same plane
+  // of the leftmost and of the rightmost view, as the side planes of the
+  // views in between are interpolated between them. Near and far planes
+  // are ignored as the clipping range is computed from the visible props.
+  vtkSlicerLookingGlassQuiltRenderer::ComputeViewCamera(camera, -this->ViewCone / 2.0, this->DisplayAspect, this->LeftCamera);
+  vtkSlicerLookingGlassQuiltRenderer::ComputeViewCamera(camera, this->ViewCone / 2.0, this->DisplayAspect, this->RightCamera);
+  double planes[2][24];
+  this->LeftCamera->GetFrustumPlanes(this->DisplayAspect, planes[0]);
+  this->RightCamera->GetFrustumPlanes(this->DisplayAspect, planes[1]);
+  for (int view = 0; view < 2; ++view)
+    {
+    for (int plane = 0; plane < 6; ++plane)
+      {
+      double* equation = planes[view] + 4 * plane;
+      double norm = vtkMath::Norm(equation);
+      if (norm > 0.0)
+        {
+        for (int i = 0; i < 4; ++i)
+          {
+          equation[i] /= norm;
+          }
+        }
+      }
+    }
+
+  double position[3] = { 0.0, 0.0, 0.0 };
+  camera->GetPosition(position);
+  double direction[3] = { 0.0, 0.0, -1.0 };
+  camera->GetDirectionOfProjection(direction);
+  double distance = camera->GetDistance();
+  double nearLimit = this->UseClippingLimits ? distance * this->NearClippingLimit : 0.0;
+  double farLimit = this->UseClippingLimits ? distance * this->FarClippingLimit : VTK_DOUBLE_MAX;
+
+  // Views are shifted perpendicularly to the direction of projection,
+  // the depth of a point is the same in all of them.
+  double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  vtkPropCollection* props = renderer->GetViewProps();
+  vtkCollectionSimpleIterator it;
+  vtkProp* prop = nullptr;
+  for (props->InitTraversal(it); (prop = props->GetNextProp(it));)
+    {
+    if (!prop->GetVisibility())
+      {
+      continue;
+      }
+    const double* bounds = prop->GetBounds();
+    if (!bounds || !vtkMath::AreBoundsInitialized(bounds))
+      {
+      // Props without bounds (e.g. 2D actors) are always rendered
+      ++this->NumberOfVisibleProps;
+      continue;
+      }
+    double center[3] = {
+      (bounds[0] + bounds[1]) / 2.0, (bounds[2] + bounds[3]) / 2.0, (bounds[4] + bounds[5]) / 2.0 };
+    double radius = sqrt((bounds[1] - bounds[0]) * (bounds[1] - bounds[0])
+      + (bounds[3] - bounds[2]) * (bounds[3] - bounds[2])
+      + (bounds[5] - bounds[4]) * (bounds[5] - bounds[4])) / 2.0;
+
+    bool culled = false;
+    for (int plane = 0; plane < 4 && !culled; ++plane)
+      {
+      const double* leftEquation = planes[0] + 4 * plane;
+      const double* rightEquation = planes[1] + 4 * plane;
+      culled = vtkMath::Dot(leftEquation, center) + leftEquation[3] < -radius
+        && vtkMath::Dot(rightEquation, center) + rightEquation[3] < -radius;
+      }
+    double depth = (center[0] - position[0]) * direction[0]
+      + (center[1] - position[1]) * direction[1]
+      + (center[2] - position[2]) * direction[2];
+    if (!culled && (depth + radius < nearLimit || depth - radius > farLimit))
+      {
+      culled = true;
+      }
+    if (culled)
+      {
+      this->CulledProps.insert(prop);
+      ++this->NumberOfCulledProps;
+      continue;
+      }
+    ++this->NumberOfVisibleProps;
+    range[0] = std::min(range[0], depth - radius);
+    range[1] = std::max(range[1], depth + radius);
+    }
+
+  if (range[0] > range[1] || range[1] <= 0.0)
+    {
+    // No visible prop in front of the camera, keep the current clipping range
+    return;
+    }
+  // Same margins as vtkRenderer::ResetCameraClippingRange
+  double expansion = (range[1] - range[0]) * renderer->GetClippingRangeExpansion();
+  range[0] = 0.99 * range[0] - expansion;
+  range[1] = 1.01 * range[1] + expansion;
+  double tolerance = renderer->GetNearClippingPlaneTolerance() > 0.0 ? renderer->GetNearClippingPlaneTolerance() : 0.001;
+  range[0] = std::max(range[0], tolerance * range[1]);
+  range[0] = std::max(range[0], nearLimit);
+  range[1] = std::min(range[1], farLimit);
+  if (range[0] < range[1])
+    {
+    camera->SetClippingRange(range);
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerLookingGlassQuiltCuller::Cull(vtkRenderer* vtkNotUsed(ren), vtkProp** propList, int& listLength,
+  int& vtkNotUsed(initialized))
+{
+  if (!this->CulledProps.empty())
+    {
+    int numberOfVisibleProps = 0;
+    for (int i = 0; i < listLength; ++i)
+      {
+      if (this->CulledProps.find(propList[i]) == this->CulledProps.end())
+        {
+        propList[numberOfVisibleProps++] = propList[i];
+        }
+      }
+    listLength = numberOfVisibleProps;
+    }
+  // Render time is evenly distributed among the props
+  return static_cast<double>(listLength);
+}
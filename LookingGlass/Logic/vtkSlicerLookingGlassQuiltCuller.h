@@ -0,0 +1,105 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerLookingGlassQuiltCuller_h
+#define __vtkSlicerLookingGlassQuiltCuller_h
+
+// VTK includes
+#include <vtkCuller.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkSlicerLookingGlassModuleLogicExport.h"
+
+// STD includes
+#include <unordered_set>
+
+class vtkCamera;
+class vtkProp;
+class vtkRenderer;
+
+/// \brief Cull props once for all the views of a looking glass quilt.
+///
+/// The renderer is rendered once per quilt view, and by default culling
+/// (including the computation of the bounds of every prop) is done for each
+/// of them although all the views share nearly the same frustum.
+/// BeginQuilt() culls the props against the frustum enclosing all the views,
+/// which are the center camera shifted horizontally within the view cone,
+/// and computes the clipping range of the visible props. This range is the
+/// same for all the views, as views are shifted perpendicularly to the
+/// direction of projection. Cull() then only removes the props culled by
+/// BeginQuilt() from the list of props of each view.
+///
+/// The culler replaces the default frustum coverage culler of the renderer.
+class VTK_SLICER_LOOKINGGLASS_MODULE_LOGIC_EXPORT vtkSlicerLookingGlassQuiltCuller : public vtkCuller
+{
+public:
+  static vtkSlicerLookingGlassQuiltCuller* New();
+  vtkTypeMacro(vtkSlicerLookingGlassQuiltCuller, vtkCuller);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Horizontal angle (in degrees) covered by the views.
+  vtkSetMacro(ViewCone, double);
+  vtkGetMacro(ViewCone, double);
+
+  /// Width/height ratio of the views.
+  vtkSetMacro(DisplayAspect, double);
+  vtkGetMacro(DisplayAspect, double);
+
+  /// Limit the clipping range to a ratio of the focal distance.
+  /// Props outside of the limits are culled.
+  vtkSetMacro(UseClippingLimits, bool);
+  vtkGetMacro(UseClippingLimits, bool);
+  vtkSetMacro(NearClippingLimit, double);
+  vtkGetMacro(NearClippingLimit, double);
+  vtkSetMacro(FarClippingLimit, double);
+  vtkGetMacro(FarClippingLimit, double);
+
+  /// Cull the props of the \a renderer for all the views of the quilt
+  /// centered on the renderer active camera, and set the clipping range of
+  /// the active camera to enclose the visible props.
+  /// Must be called before rendering each quilt.
+  void BeginQuilt(vtkRenderer* renderer);
+
+  /// Remove the props culled by BeginQuilt() from \a propList.
+  double Cull(vtkRenderer* ren, vtkProp** propList, int& listLength, int& initialized) override;
+
+  /// Number of props visible and culled by the last BeginQuilt().
+  vtkGetMacro(NumberOfVisibleProps, int);
+  vtkGetMacro(NumberOfCulledProps, int);
+
+protected:
+  vtkSlicerLookingGlassQuiltCuller();
+  ~vtkSlicerLookingGlassQuiltCuller() override;
+
+  double ViewCone;
+  double DisplayAspect;
+  bool UseClippingLimits;
+  double NearClippingLimit;
+  double FarClippingLimit;
+
+  int NumberOfVisibleProps;
+  int NumberOfCulledProps;
+  std::unordered_set<vtkProp*> CulledProps;
+  vtkSmartPointer<vtkCamera> LeftCamera;
+  vtkSmartPointer<vtkCamera> RightCamera;
+
+private:
+  vtkSlicerLookingGlassQuiltCuller(const vtkSlicerLookingGlassQuiltCuller&); // Not implemented
+  void operator=(const vtkSlicerLookingGlassQuiltCuller&); // Not implemented
+};
+
+#endif
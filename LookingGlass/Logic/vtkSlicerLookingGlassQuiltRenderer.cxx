@@ -0,0 +1,756 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// LookingGlass Logic includes
+#include "vtkSlicerLookingGlassQuiltRenderer.h"
+#include "vtkSlicerLookingGlassMultiViewCuller.h"
+
+// VTK includes
+#include <vtkCamera.h>
+#include <vtkCullerCollection.h>
+#include <vtkFrustumCoverageCuller.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderTimerLog.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkTimerLog.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkVersionMacros.h>
+
+// STD includes
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerLookingGlassQuiltRenderer);
+vtkCxxSetObjectMacro(vtkSlicerLookingGlassQuiltRenderer, RenderWindow, vtkRenderWindow);
+vtkCxxSetObjectMacro(vtkSlicerLookingGlassQuiltRenderer, Renderer, vtkRenderer);
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassQuiltRenderer::vtkSlicerLookingGlassQuiltRenderer()
+  : RenderWindow(nullptr)
+  , Renderer(nullptr)
+  , QuiltColumns(8)
+  , QuiltRows(6)
+  , DisplayAspect(0.75)
+  , ViewCone(40.0)
+  , UseClippingLimits(false)
+  , NearClippingLimit(0.8)
+  , FarClippingLimit(1.2)
+  , KeyViewInterval(1)
+  , MaximumDisocclusionRatio(0.02)
+  , NumberOfSynthesizedTiles(0)
+  , TemporalAccumulation(false)
+  , NumberOfAccumulatedQuilts(0)
+  , MultiViewRendering(false)
+  , NumberOfMultiViewPasses(0)
+  , NextTile(0)
+  , QuiltRead(true)
+  , NextSynthesizedTile(0)
+{
+  this->TileSize[0] = 420;
+  this->TileSize[1] = 560;
+  this->Jitter[0] = 0.0;
+  this->Jitter[1] = 0.0;
+  this->KeyViewClippingRange[0] = 0.1;
+  this->KeyViewClippingRange[1] = 1000.0;
+  this->QuiltCamera = vtkSmartPointer<vtkCamera>::New();
+  this->TileCamera = vtkSmartPointer<vtkCamera>::New();
+  this->QuiltImage = vtkSmartPointer<vtkImageData>::New();
+  this->TilePixels = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  this->MultiViewCuller = vtkSmartPointer<vtkSlicerLookingGlassMultiViewCuller>::New();
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassQuiltRenderer::~vtkSlicerLookingGlassQuiltRenderer()
+{
+  this->SetRenderWindow(nullptr);
+  this->SetRenderer(nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassQuiltRenderer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "RenderWindow: " << this->RenderWindow << "\n";
+  os << indent << "Renderer: " << this->Renderer << "\n";
+  os << indent << "QuiltColumns: " << this->QuiltColumns << "\n";
+  os << indent << "QuiltRows: " << this->QuiltRows << "\n";
+  os << indent << "TileSize: " << this->TileSize[0] << " " << this->TileSize[1] << "\n";
+  os << indent << "DisplayAspect: " << this->DisplayAspect << "\n";
+  os << indent << "ViewCone: " << this->ViewCone << "\n";
+  os << indent << "UseClippingLimits: " << (this->UseClippingLimits ? "true" : "false") << "\n";
+  os << indent << "NearClippingLimit: " << this->NearClippingLimit << "\n";
+  os << indent << "FarClippingLimit: " << this->FarClippingLimit << "\n";
+  os << indent << "KeyViewInterval: " << this->KeyViewInterval << "\n";
+  os << indent << "MaximumDisocclusionRatio: " << this->MaximumDisocclusionRatio << "\n";
+  os << indent << "NumberOfSynthesizedTiles: " << this->NumberOfSynthesizedTiles << "\n";
+  os << indent << "TemporalAccumulation: " << (this->TemporalAccumulation ? "true" : "false") << "\n";
+  os << indent << "NumberOfAccumulatedQuilts: " << this->NumberOfAccumulatedQuilts << "\n";
+  os << indent << "Jitter: " << this->Jitter[0] << " " << this->Jitter[1] << "\n";
+  os << indent << "MultiViewRendering: " << (this->MultiViewRendering ? "true" : "false") << "\n";
+  os << indent << "NumberOfMultiViewPasses: " << this->NumberOfMultiViewPasses << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassQuiltRenderer::SetMultiViewRendering(bool multiViewRendering)
+{
+  if (this->MultiViewRendering == multiViewRendering)
+    {
+    return;
+    }
+  this->MultiViewRendering = multiViewRendering;
+  if (!multiViewRendering)
+    {
+    // Actors are rendered by other renderers as well
+    this->MultiViewCuller->RemoveMultiViewShaders();
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerLookingGlassQuiltRenderer::GetNumberOfTiles()
+{
+  return this->QuiltColumns * this->QuiltRows;
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkSlicerLookingGlassQuiltRenderer::GetQuiltImage()
+{
+  return this->QuiltImage;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerLookingGlassQuiltRenderer::GetTileOffset(int tile, double distance)
+{
+  int numberOfTiles = this->GetNumberOfTiles();
+  // Views are evenly distributed in the view cone, from left to right
+  double angle = numberOfTiles > 1 ? (tile / (numberOfTiles - 1.0) - 0.5) * this->ViewCone : 0.0;
+  return distance * tan(vtkMath::RadiansFromDegrees(angle));
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassQuiltRenderer::ComputeTileCamera(int tile, vtkCamera* centerCamera, vtkCamera* tileCamera)
+{
+  if (!centerCamera || !tileCamera)
+    {
+    vtkErrorMacro("ComputeTileCamera: invalid camera");
+    return;
+    }
+  int numberOfTiles = this->GetNumberOfTiles();
+  double angle = numberOfTiles > 1 ? (tile / (numberOfTiles - 1.0) - 0.5) * this->ViewCone : 0.0;
+  vtkSlicerLookingGlassQuiltRenderer::ComputeViewCamera(centerCamera, angle, this->DisplayAspect, tileCamera);
+
+  if ((this->Jitter[0] != 0.0 || this->Jitter[1] != 0.0) && this->TileSize[0] > 0 && this->TileSize[1] > 0)
+    {
+    // Window center is in normalized viewport coordinates, a pixel is 2/size
+    double windowCenter[2] = { 0.0, 0.0 };
+    tileCamera->GetWindowCenter(windowCenter);
+    tileCamera->SetWindowCenter(windowCenter[0] + 2.0 * this->Jitter[0] / this->TileSize[0],
+      windowCenter[1] + 2.0 * this->Jitter[1] / this->TileSize[1]);
+    }
+
+  if (this->UseClippingLimits)
+    {
+    double distance = centerCamera->GetDistance();
+    double clippingRange[2] = { 0.0, 0.0 };
+    centerCamera->GetClippingRange(clippingRange);
+    double nearClipping = std::max(clippingRange[0], distance * this->NearClippingLimit);
+    double farClipping = std::min(clippingRange[1], distance * this->FarClippingLimit);
+    if (nearClipping < farClipping)
+      {
+      tileCamera->SetClippingRange(nearClipping, farClipping);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassQuiltRenderer::ComputeViewCamera(vtkCamera* centerCamera, double angle, double displayAspect,
+  vtkCamera* viewCamera)
+{
+  viewCamera->DeepCopy(centerCamera);
+
+#if VTK_VERSION_NUMBER >= VTK_VERSION_CHECK(9, 2, 0)
+  // Tiles are stretched to the display aspect ratio when displayed
+  viewCamera->SetUseExplicitAspectRatio(true);
+  viewCamera->SetExplicitAspectRatio(displayAspect);
+#endif
+
+  double distance = centerCamera->GetDistance();
+  double offset = distance * tan(vtkMath::RadiansFromDegrees(angle));
+
+  double direction[3] = { 0.0, 0.0, -1.0 };
+  centerCamera->GetDirectionOfProjection(direction);
+  double viewUp[3] = { 0.0, 1.0, 0.0 };
+  centerCamera->GetViewUp(viewUp);
+  double right[3] = { 1.0, 0.0, 0.0 };
+  vtkMath::Cross(direction, viewUp, right);
+  vtkMath::Normalize(right);
+
+  double position[3] = { 0.0, 0.0, 0.0 };
+  double focalPoint[3] = { 0.0, 0.0, 0.0 };
+  centerCamera->GetPosition(position);
+  centerCamera->GetFocalPoint(focalPoint);
+  for (int i = 0; i < 3; ++i)
+    {
+    position[i] += offset * right[i];
+    focalPoint[i] += offset * right[i];
+    }
+  viewCamera->SetPosition(position);
+  viewCamera->SetFocalPoint(focalPoint);
+
+  // Shear the projection so that the focal plane is displayed at the same
+  // place in all the views.
+  double halfWidth = displayAspect * (centerCamera->GetParallelProjection()
+    ? centerCamera->GetParallelScale()
+    : distance * tan(vtkMath::RadiansFromDegrees(centerCamera->GetViewAngle() / 2.0)));
+  if (halfWidth > 0.0)
+    {
+    double windowCenter[2] = { 0.0, 0.0 };
+    centerCamera->GetWindowCenter(windowCenter);
+    viewCamera->SetWindowCenter(windowCenter[0] - offset / halfWidth, windowCenter[1]);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassQuiltRenderer::Render()
+{
+  if (!this->BeginQuilt())
+    {
+    return false;
+    }
+  return this->RenderNextTiles(VTK_DOUBLE_MAX);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassQuiltRenderer::BeginQuilt()
+{
+  // An empty queue is a complete quilt
+  this->TileQueue.clear();
+  this->SynthesizedTiles.clear();
+  this->KeyViews.clear();
+  this->NextTile = 0;
+  this->NextSynthesizedTile = 0;
+  this->QuiltRead = true;
+  this->NumberOfSynthesizedTiles = 0;
+  this->NumberOfMultiViewPasses = 0;
+  if (!this->RenderWindow || !this->Renderer)
+    {
+    vtkErrorMacro("BeginQuilt: render window or renderer is not set");
+    return false;
+    }
+  vtkCamera* centerCamera = this->Renderer->GetActiveCamera();
+  if (!centerCamera)
+    {
+    vtkErrorMacro("BeginQuilt: renderer has no active camera");
+    return false;
+    }
+  this->QuiltCamera->DeepCopy(centerCamera);
+
+  int quiltWidth = this->QuiltColumns * this->TileSize[0];
+  int quiltHeight = this->QuiltRows * this->TileSize[1];
+  int* windowSize = this->RenderWindow->GetSize();
+  if (windowSize[0] != quiltWidth || windowSize[1] != quiltHeight)
+    {
+    this->RenderWindow->SetSize(quiltWidth, quiltHeight);
+    }
+
+  int* dimensions = this->QuiltImage->GetDimensions();
+  if (dimensions[0] != quiltWidth || dimensions[1] != quiltHeight
+    || !this->QuiltImage->GetPointData()->GetScalars())
+    {
+    this->QuiltImage->SetDimensions(quiltWidth, quiltHeight, 1);
+    this->QuiltImage->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+    }
+
+  int numberOfTiles = this->GetNumberOfTiles();
+  bool synthesizeViews = this->KeyViewInterval > 1 && numberOfTiles > 2
+    && this->MaximumDisocclusionRatio > 0.0
+    && !this->QuiltCamera->GetParallelProjection();
+  for (int tile = 0; tile < numberOfTiles; ++tile)
+    {
+    if (!synthesizeViews || tile % this->KeyViewInterval == 0 || tile == numberOfTiles - 1)
+      {
+      this->TileQueue.push_back(tile);
+      this->KeyViews.push_back(tile);
+      }
+    else
+      {
+      this->SynthesizedTiles.push_back(tile);
+      }
+    }
+  this->QuiltRead = false;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassQuiltRenderer::IsQuiltComplete()
+{
+  return this->NextTile >= static_cast<int>(this->TileQueue.size())
+    && this->QuiltRead
+    && this->NextSynthesizedTile >= static_cast<int>(this->SynthesizedTiles.size());
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassQuiltRenderer::RenderNextTiles(double timeBudget)
+{
+  if (this->IsQuiltComplete())
+    {
+    return true;
+    }
+  if (!this->RenderWindow || !this->Renderer)
+    {
+    vtkErrorMacro("RenderNextTiles: render window or renderer is not set");
+    return false;
+    }
+  double startTime = vtkTimerLog::GetUniversalTime();
+
+  // Tiles are accumulated in the back buffer, which is read back
+  // when the key views are rendered, as vtkWindowToImageFilter does.
+  vtkTypeBool swapBuffers = this->RenderWindow->GetSwapBuffers();
+  this->RenderWindow->SwapBuffersOff();
+
+  // The active camera is left untouched so that it is not synchronized
+  // with the camera node for each tile.
+  vtkSmartPointer<vtkCamera> activeCamera = this->Renderer->GetActiveCamera();
+  this->Renderer->SetActiveCamera(this->TileCamera);
+  double viewport[4] = { 0.0, 0.0, 1.0, 1.0 };
+  this->Renderer->GetViewport(viewport);
+  if (this->MultiViewRendering)
+    {
+    this->Renderer->AddCuller(this->MultiViewCuller);
+    }
+  bool success = true;
+  while (success && !this->IsQuiltComplete())
+    {
+    if (this->NextTile < static_cast<int>(this->TileQueue.size()))
+      {
+      if (this->MultiViewRendering && !this->QuiltRead)
+        {
+        this->RenderMultiViewTiles();
+        }
+      else
+        {
+        int tile = this->TileQueue[this->NextTile];
+        this->RenderTile(tile);
+        ++this->NextTile;
+        if (this->QuiltRead)
+          {
+          // Synthesized view with too many disoccluded pixels
+          success = this->ReadTile(tile);
+          }
+        }
+      }
+    else if (!this->QuiltRead)
+      {
+      // Read back the whole quilt at once instead of stalling the pipeline for each tile
+      success = this->ReadQuilt();
+      this->QuiltRead = true;
+      }
+    else
+      {
+      int tile = this->SynthesizedTiles[this->NextSynthesizedTile];
+      ++this->NextSynthesizedTile;
+      if (this->SynthesizeTile(tile) > this->MaximumDisocclusionRatio)
+        {
+        this->TileQueue.push_back(tile);
+        }
+      else
+        {
+        ++this->NumberOfSynthesizedTiles;
+        }
+      }
+    if (vtkTimerLog::GetUniversalTime() - startTime > timeBudget)
+      {
+      break;
+      }
+    }
+  if (this->MultiViewRendering)
+    {
+    this->Renderer->RemoveCuller(this->MultiViewCuller);
+    }
+  this->Renderer->SetViewport(viewport);
+  this->Renderer->SetActiveCamera(activeCamera);
+  this->RenderWindow->SetSwapBuffers(swapBuffers);
+
+  if (!success)
+    {
+    // Abort the quilt
+    this->TileQueue.clear();
+    this->SynthesizedTiles.clear();
+    this->NextTile = 0;
+    this->NextSynthesizedTile = 0;
+    this->QuiltRead = true;
+    }
+  else if (this->IsQuiltComplete())
+    {
+    this->AccumulateQuilt();
+    this->QuiltImage->Modified();
+    }
+  return success;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassQuiltRenderer::RenderTile(int tile)
+{
+  int column = tile % this->QuiltColumns;
+  int row = tile / this->QuiltColumns;
+  // The renderer only clears its viewport, other tiles are preserved
+  this->Renderer->SetViewport(
+    static_cast<double>(column) / this->QuiltColumns, static_cast<double>(row) / this->QuiltRows,
+    static_cast<double>(column + 1) / this->QuiltColumns, static_cast<double>(row + 1) / this->QuiltRows);
+  this->ComputeTileCamera(tile, this->QuiltCamera, this->TileCamera);
+  this->RenderWindow->Render();
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassQuiltRenderer::HasMultiViewProps()
+{
+  vtkPropCollection* props = this->Renderer->GetViewProps();
+  vtkCollectionSimpleIterator it;
+  props->InitTraversal(it);
+  while (vtkProp* prop = props->GetNextProp(it))
+    {
+    if (prop->GetVisibility() && this->MultiViewCuller->IsMultiViewProp(prop))
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassQuiltRenderer::RenderMultiViewTiles()
+{
+  typedef vtkSlicerLookingGlassMultiViewCuller Culler;
+  int maximumNumberOfViews = this->MultiViewCuller->GetMaximumNumberOfViews();
+  if (maximumNumberOfViews <= 0 || !this->HasMultiViewProps())
+    {
+    this->MultiViewCuller->SetPass(Culler::PassAllProps);
+    this->RenderTile(this->TileQueue[this->NextTile]);
+    ++this->NextTile;
+    if (maximumNumberOfViews < 0)
+      {
+      // The OpenGL context is created by the first render
+      this->MultiViewCuller->Initialize(this->RenderWindow);
+      }
+    return;
+    }
+  int numberOfViews = std::min(maximumNumberOfViews, static_cast<int>(this->TileQueue.size()) - this->NextTile);
+  std::vector<int> tiles(this->TileQueue.begin() + this->NextTile,
+    this->TileQueue.begin() + this->NextTile + numberOfViews);
+  this->NextTile += numberOfViews;
+
+  // Clear each tile to the background of the renderer
+  this->MultiViewCuller->SetPass(Culler::PassBackground);
+  for (int tile : tiles)
+    {
+    this->RenderTile(tile);
+    }
+
+  // Views of the multi-view pass, relative to the quilt camera rendered in
+  // the whole render window
+  double tileAspect = static_cast<double>(this->TileSize[0]) / this->TileSize[1];
+  double quiltAspect = static_cast<double>(this->QuiltColumns * this->TileSize[0])
+    / (this->QuiltRows * this->TileSize[1]);
+  vtkNew<vtkMatrix4x4> inverseQuiltProjection;
+  inverseQuiltProjection->DeepCopy(this->QuiltCamera->GetCompositeProjectionTransformMatrix(quiltAspect, -1.0, 1.0));
+  inverseQuiltProjection->Invert();
+  vtkNew<vtkMatrix4x4> correction;
+  std::vector<float> corrections(16 * static_cast<size_t>(numberOfViews));
+  std::vector<float> viewports(4 * static_cast<size_t>(numberOfViews));
+  for (int view = 0; view < numberOfViews; ++view)
+    {
+    int tile = tiles[view];
+    this->ComputeTileCamera(tile, this->QuiltCamera, this->TileCamera);
+    vtkMatrix4x4::Multiply4x4(this->TileCamera->GetCompositeProjectionTransformMatrix(tileAspect, -1.0, 1.0),
+      inverseQuiltProjection, correction);
+    // Column-major, as expected by OpenGL
+    for (int column = 0; column < 4; ++column)
+      {
+      for (int row = 0; row < 4; ++row)
+        {
+        corrections[16 * view + 4 * column + row] = static_cast<float>(correction->GetElement(row, column));
+        }
+      }
+    viewports[4 * view + 0] = static_cast<float>((tile % this->QuiltColumns) * this->TileSize[0]);
+    viewports[4 * view + 1] = static_cast<float>((tile / this->QuiltColumns) * this->TileSize[1]);
+    viewports[4 * view + 2] = static_cast<float>(this->TileSize[0]);
+    viewports[4 * view + 3] = static_cast<float>(this->TileSize[1]);
+    }
+  this->MultiViewCuller->SetViews(numberOfViews, corrections.data(), viewports.data());
+
+  // The frustum of the quilt camera does not cover the side views, frustum
+  // coverage cullers would remove the props only visible in them.
+  vtkCullerCollection* cullers = this->Renderer->GetCullers();
+  std::vector<vtkSmartPointer<vtkCuller> > rendererCullers;
+  vtkCollectionSimpleIterator it;
+  cullers->InitTraversal(it);
+  while (vtkCuller* culler = cullers->GetNextCuller(it))
+    {
+    rendererCullers.push_back(culler);
+    }
+  cullers->RemoveAllItems();
+  for (vtkCuller* culler : rendererCullers)
+    {
+    if (!vtkFrustumCoverageCuller::SafeDownCast(culler))
+      {
+      cullers->AddItem(culler);
+      }
+    }
+
+  // Draw the opaque poly data of all the views on top of the backgrounds
+  vtkTypeBool erase = this->Renderer->GetErase();
+  this->Renderer->EraseOff();
+  this->Renderer->SetViewport(0.0, 0.0, 1.0, 1.0);
+  this->TileCamera->DeepCopy(this->QuiltCamera);
+  this->MultiViewCuller->SetPass(Culler::PassMultiView);
+  this->RenderWindow->Render();
+  this->MultiViewCuller->EndMultiViewPass();
+  if (this->MultiViewCuller->GetNumberOfMultiViewProps() > 0)
+    {
+    ++this->NumberOfMultiViewPasses;
+    }
+
+  cullers->RemoveAllItems();
+  for (vtkCuller* culler : rendererCullers)
+    {
+    cullers->AddItem(culler);
+    }
+
+  // Render the other props in each tile, depth tested against the multi-view pass
+  if (this->MultiViewCuller->GetNumberOfTileProps() > 0)
+    {
+    this->MultiViewCuller->SetPass(Culler::PassTiles);
+    for (int tile : tiles)
+      {
+      this->RenderTile(tile);
+      }
+    }
+  else
+    {
+    // The clipping range of the last tile is used to synthesize views
+    this->ComputeTileCamera(tiles.back(), this->QuiltCamera, this->TileCamera);
+    }
+  this->Renderer->SetErase(erase);
+  this->MultiViewCuller->SetPass(Culler::PassAllProps);
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassQuiltRenderer::ResetAccumulation()
+{
+  this->NumberOfAccumulatedQuilts = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassQuiltRenderer::AccumulateQuilt()
+{
+  if (!this->TemporalAccumulation)
+    {
+    this->NumberOfAccumulatedQuilts = 0;
+    this->AccumulatedQuilt.clear();
+    return;
+    }
+  unsigned char* quiltPixels = static_cast<unsigned char*>(this->QuiltImage->GetScalarPointer());
+  size_t size = static_cast<size_t>(this->QuiltImage->GetNumberOfPoints()) * 3;
+  if (this->NumberOfAccumulatedQuilts == 0 || this->AccumulatedQuilt.size() != size)
+    {
+    // First quilt of the accumulation, or the quilt size changed
+    this->AccumulatedQuilt.assign(quiltPixels, quiltPixels + size);
+    this->NumberOfAccumulatedQuilts = 1;
+    return;
+    }
+  ++this->NumberOfAccumulatedQuilts;
+  float weight = 1.0f / this->NumberOfAccumulatedQuilts;
+  for (size_t i = 0; i < size; ++i)
+    {
+    float& accumulatedValue = this->AccumulatedQuilt[i];
+    accumulatedValue += (quiltPixels[i] - accumulatedValue) * weight;
+    quiltPixels[i] = static_cast<unsigned char>(accumulatedValue + 0.5f);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassQuiltRenderer::ReadQuilt()
+{
+  VTK_SCOPED_RENDER_EVENT("vtkSlicerLookingGlassQuiltRenderer::ReadQuilt", this->RenderWindow->GetRenderTimer());
+  vtkUnsignedCharArray* quiltPixels = vtkUnsignedCharArray::SafeDownCast(
+    this->QuiltImage->GetPointData()->GetScalars());
+  int* dimensions = this->QuiltImage->GetDimensions();
+  if (!quiltPixels
+    || this->RenderWindow->GetPixelData(0, 0, dimensions[0] - 1, dimensions[1] - 1,
+      /* front= */ 0, quiltPixels) != 1)
+    {
+    vtkErrorMacro("ReadQuilt: failed to read quilt pixels");
+    return false;
+    }
+
+  if (this->SynthesizedTiles.empty())
+    {
+    return true;
+    }
+  // All the views share the clipping range of the quilt camera
+  this->TileCamera->GetClippingRange(this->KeyViewClippingRange);
+  int width = this->TileSize[0];
+  int height = this->TileSize[1];
+  this->KeyViewDepths.resize(this->KeyViews.size());
+  for (size_t keyView = 0; keyView < this->KeyViews.size(); ++keyView)
+    {
+    int column = this->KeyViews[keyView] % this->QuiltColumns;
+    int row = this->KeyViews[keyView] / this->QuiltColumns;
+    std::vector<float>& depth = this->KeyViewDepths[keyView];
+    depth.resize(static_cast<size_t>(width) * height);
+    if (this->RenderWindow->GetZbufferData(column * width, row * height,
+      (column + 1) * width - 1, (row + 1) * height - 1, depth.data()) != 1)
+      {
+      vtkErrorMacro("ReadQuilt: failed to read depth of view " << this->KeyViews[keyView]);
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassQuiltRenderer::ReadTile(int tile)
+{
+  VTK_SCOPED_RENDER_EVENT("vtkSlicerLookingGlassQuiltRenderer::ReadTile", this->RenderWindow->GetRenderTimer());
+  int width = this->TileSize[0];
+  int height = this->TileSize[1];
+  int column = tile % this->QuiltColumns;
+  int row = tile / this->QuiltColumns;
+  if (this->RenderWindow->GetPixelData(column * width, row * height,
+    (column + 1) * width - 1, (row + 1) * height - 1, /* front= */ 0, this->TilePixels) != 1)
+    {
+    vtkErrorMacro("ReadTile: failed to read pixels of view " << tile);
+    return false;
+    }
+  unsigned char* quiltPixels = static_cast<unsigned char*>(this->QuiltImage->GetScalarPointer());
+  size_t quiltRowSize = static_cast<size_t>(this->QuiltColumns) * width * 3;
+  size_t tileRowSize = static_cast<size_t>(width) * 3;
+  for (int y = 0; y < height; ++y)
+    {
+    memcpy(quiltPixels + (static_cast<size_t>(row) * height + y) * quiltRowSize + column * tileRowSize,
+      this->TilePixels->GetPointer(0) + y * tileRowSize, tileRowSize);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerLookingGlassQuiltRenderer::SynthesizeTile(int tile)
+{
+  const int width = this->TileSize[0];
+  const int height = this->TileSize[1];
+  unsigned char* quiltPixels = static_cast<unsigned char*>(this->QuiltImage->GetScalarPointer());
+  const size_t quiltRowSize = static_cast<size_t>(this->QuiltColumns) * width * 3;
+  auto pixel = [&](int quiltTile, int x, int y)
+    {
+    int column = quiltTile % this->QuiltColumns;
+    int row = quiltTile / this->QuiltColumns;
+    return quiltPixels + (static_cast<size_t>(row) * height + y) * quiltRowSize + (static_cast<size_t>(column) * width + x) * 3;
+    };
+
+  // A point at distance z from the camera is shifted horizontally by
+  // (offset difference) * (1/distance - 1/z) / halfWidth in normalized
+  // device coordinates, the focal plane stays in place.
+  double distance = this->QuiltCamera->GetDistance();
+  double halfWidth = this->DisplayAspect * tan(vtkMath::RadiansFromDegrees(this->QuiltCamera->GetViewAngle() / 2.0));
+  double nearZ = this->KeyViewClippingRange[0];
+  double farZ = this->KeyViewClippingRange[1];
+  double tileOffset = this->GetTileOffset(tile, distance);
+
+  std::vector<float> tileDepth(static_cast<size_t>(width) * height, FLT_MAX);
+  // Key views surrounding the tile
+  size_t leftKeyView = tile / this->KeyViewInterval;
+  for (size_t keyView = leftKeyView; keyView <= leftKeyView + 1 && keyView < this->KeyViews.size(); ++keyView)
+    {
+    int keyTile = this->KeyViews[keyView];
+    double scale = (tileOffset - this->GetTileOffset(keyTile, distance)) / halfWidth * width / 2.0;
+    const float* keyDepth = this->KeyViewDepths[keyView].data();
+    for (int y = 0; y < height; ++y)
+      {
+      for (int x = 0; x < width; ++x)
+        {
+        // Depth buffer value to distance from the camera
+        double z = nearZ * farZ / (farZ - keyDepth[y * width + x] * (farZ - nearZ));
+        double shiftedX = x + scale * (1.0 / distance - 1.0 / z);
+        // Each pixel covers two target pixels to close cracks
+        int targetX = static_cast<int>(std::floor(shiftedX));
+        for (int splatX = targetX; splatX <= targetX + 1; ++splatX)
+          {
+          if (splatX < 0 || splatX >= width || z >= tileDepth[y * width + splatX])
+            {
+            continue;
+            }
+          tileDepth[y * width + splatX] = static_cast<float>(z);
+          memcpy(pixel(tile, splatX, y), pixel(keyTile, x, y), 3);
+          }
+        }
+      }
+    }
+
+  // Fill disocclusion holes with the background side of the hole
+  int numberOfHolePixels = 0;
+  for (int y = 0; y < height; ++y)
+    {
+    const float* rowDepth = tileDepth.data() + y * width;
+    int x = 0;
+    while (x < width)
+      {
+      if (rowDepth[x] < FLT_MAX)
+        {
+        ++x;
+        continue;
+        }
+      int holeStart = x;
+      while (x < width && rowDepth[x] == FLT_MAX)
+        {
+        ++x;
+        }
+      numberOfHolePixels += x - holeStart;
+      int left = holeStart - 1;
+      int right = x;
+      int sourceX = -1;
+      if (left >= 0 && right < width)
+        {
+        sourceX = rowDepth[left] > rowDepth[right] ? left : right;
+        }
+      else if (left >= 0)
+        {
+        sourceX = left;
+        }
+      else if (right < width)
+        {
+        sourceX = right;
+        }
+      for (int holeX = holeStart; holeX < x; ++holeX)
+        {
+        // Empty rows are copied from the left key view
+        memcpy(pixel(tile, holeX, y),
+          sourceX >= 0 ? pixel(tile, sourceX, y) : pixel(this->KeyViews[leftKeyView], holeX, y), 3);
+        }
+      }
+    }
+  return static_cast<double>(numberOfHolePixels) / (static_cast<double>(width) * height);
+}
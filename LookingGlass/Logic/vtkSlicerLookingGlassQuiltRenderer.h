@@ -0,0 +1,274 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerLookingGlassQuiltRenderer_h
+#define __vtkSlicerLookingGlassQuiltRenderer_h
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkSlicerLookingGlassModuleLogicExport.h"
+
+// STD includes
+#include <vector>
+
+class vtkCamera;
+class vtkImageData;
+class vtkSlicerLookingGlassMultiViewCuller;
+class vtkRenderer;
+class vtkRenderWindow;
+class vtkUnsignedCharArray;
+
+/// \brief Render a looking glass quilt without a looking glass device.
+///
+/// Each tile of the quilt is rendered with the renderer active camera
+/// shifted horizontally within the view cone and an off-axis projection
+/// that keeps the focal plane fixed, similarly to what the looking glass
+/// render window does for the device. Tiles are rendered in the viewport
+/// of the tile in the render window, which is expected to be an offscreen
+/// window of the quilt size, and the whole quilt is read back at once.
+/// View 0 is the leftmost view and is stored in the bottom-left tile of
+/// the quilt.
+///
+/// By default each rendered tile is a full render of the render window. If
+/// MultiViewRendering is enabled then the opaque poly data actors (models,
+/// segmentations) are drawn once for up to 32 key views: a geometry shader
+/// emits each triangle in the viewport of every view with the projection of
+/// the view (see vtkSlicerLookingGlassMultiViewCuller). The other props,
+/// such as volumes and translucent models, are then rendered in each tile.
+/// Shading is computed for the center camera in the multi-view pass.
+///
+/// Neighbouring views only differ by a horizontal camera shift. If
+/// KeyViewInterval is larger than 1 then only every KeyViewInterval-th view
+/// (and the last one) is rendered, the views in between are synthesized by
+/// reprojecting the color and depth of the two surrounding key views.
+/// Disocclusion holes are filled with the farthest neighbouring pixel, and
+/// views with more holes than MaximumDisocclusionRatio are rendered.
+///
+/// If TemporalAccumulation is enabled then each completed quilt is averaged
+/// with the quilts completed since the last ResetAccumulation(). Rendering
+/// the same scene with a different sub-pixel Jitter for each quilt converges
+/// to a supersampled quilt.
+class VTK_SLICER_LOOKINGGLASS_MODULE_LOGIC_EXPORT vtkSlicerLookingGlassQuiltRenderer : public vtkObject
+{
+public:
+  static vtkSlicerLookingGlassQuiltRenderer* New();
+  vtkTypeMacro(vtkSlicerLookingGlassQuiltRenderer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Render window the tiles are rendered into.
+  /// Its size is set to the quilt size when rendering.
+  void SetRenderWindow(vtkRenderWindow* renderWindow);
+  vtkGetObjectMacro(RenderWindow, vtkRenderWindow);
+
+  /// Renderer containing the displayed props, its active camera defines
+  /// the center view of the quilt.
+  void SetRenderer(vtkRenderer* renderer);
+  vtkGetObjectMacro(Renderer, vtkRenderer);
+
+  /// Number of tile columns and rows of the quilt.
+  vtkSetClampMacro(QuiltColumns, int, 1, 64);
+  vtkGetMacro(QuiltColumns, int);
+  vtkSetClampMacro(QuiltRows, int, 1, 64);
+  vtkGetMacro(QuiltRows, int);
+
+  /// Size of a tile in pixels.
+  vtkSetVector2Macro(TileSize, int);
+  vtkGetVector2Macro(TileSize, int);
+
+  /// Width/height ratio of the display. Tiles are stretched to this
+  /// aspect ratio when the quilt is displayed.
+  vtkSetClampMacro(DisplayAspect, double, 0.01, 100.0);
+  vtkGetMacro(DisplayAspect, double);
+
+  /// Horizontal angle (in degrees) covered by the views.
+  vtkSetClampMacro(ViewCone, double, 0.0, 170.0);
+  vtkGetMacro(ViewCone, double);
+
+  /// Limit the clipping range to a ratio of the focal distance,
+  /// as the looking glass render window does.
+  vtkSetMacro(UseClippingLimits, bool);
+  vtkGetMacro(UseClippingLimits, bool);
+  vtkSetMacro(NearClippingLimit, double);
+  vtkGetMacro(NearClippingLimit, double);
+  vtkSetMacro(FarClippingLimit, double);
+  vtkGetMacro(FarClippingLimit, double);
+
+  /// Number of views of the quilt.
+  int GetNumberOfTiles();
+
+  /// Interval between the rendered key views, the other views are
+  /// synthesized from the key views. 1 means all views are rendered,
+  /// which is the default.
+  /// View synthesis is not used with parallel projection, as all the views
+  /// are identical.
+  vtkSetClampMacro(KeyViewInterval, int, 1, 16);
+  vtkGetMacro(KeyViewInterval, int);
+
+  /// Maximum ratio of pixels of a synthesized view that are not visible in
+  /// the key views. Views with more disoccluded pixels are rendered.
+  /// 0 means all views are rendered. Default is 0.02.
+  vtkSetClampMacro(MaximumDisocclusionRatio, double, 0.0, 1.0);
+  vtkGetMacro(MaximumDisocclusionRatio, double);
+
+  /// Number of views of the last quilt that were synthesized
+  /// instead of rendered.
+  vtkGetMacro(NumberOfSynthesizedTiles, int);
+
+  /// Average the completed quilts with the previous ones.
+  /// Default is false.
+  vtkSetMacro(TemporalAccumulation, bool);
+  vtkGetMacro(TemporalAccumulation, bool);
+  vtkBooleanMacro(TemporalAccumulation, bool);
+
+  /// Draw the opaque poly data actors for several views in one pass instead
+  /// of once per view. Falls back to rendering each view if the OpenGL
+  /// context does not support geometry shader invocations and viewport
+  /// arrays. Default is false.
+  void SetMultiViewRendering(bool multiViewRendering);
+  vtkGetMacro(MultiViewRendering, bool);
+  vtkBooleanMacro(MultiViewRendering, bool);
+
+  /// Number of multi-view passes of the last quilt that drew props.
+  vtkGetMacro(NumberOfMultiViewPasses, int);
+
+  /// Start a new accumulation from the next completed quilt. Must be called
+  /// when the scene or the camera changes.
+  void ResetAccumulation();
+
+  /// Number of quilts averaged in the quilt image.
+  vtkGetMacro(NumberOfAccumulatedQuilts, int);
+
+  /// Sub-pixel offset (in tile pixels) of the projection of all the tiles.
+  /// Default is (0, 0).
+  vtkSetVector2Macro(Jitter, double);
+  vtkGetVector2Macro(Jitter, double);
+
+  /// Set the camera used for rendering the tile \a tile, computed
+  /// from the \a centerCamera and jittered by Jitter.
+  void ComputeTileCamera(int tile, vtkCamera* centerCamera, vtkCamera* tileCamera);
+
+  /// Set \a viewCamera to the \a centerCamera shifted horizontally by the
+  /// \a angle (in degrees) with an off-axis projection that keeps the focal
+  /// plane fixed. Clipping range is copied from the center camera.
+  static void ComputeViewCamera(vtkCamera* centerCamera, double angle, double displayAspect,
+    vtkCamera* viewCamera);
+
+  /// Render all the tiles and update the quilt image.
+  /// Return false if rendering failed.
+  bool Render();
+
+  /// Render the quilt in several steps, so that the application can process
+  /// events between them.
+  /// BeginQuilt() takes a snapshot of the renderer active camera, which is
+  /// used for all the tiles of the quilt even if the camera is modified
+  /// before the quilt is completed.
+  /// RenderNextTiles() renders tiles until \a timeBudget (in seconds) is
+  /// exceeded, at least one tile is rendered. Return false if rendering failed.
+  /// The quilt image is updated when the last tile is rendered.
+  bool BeginQuilt();
+  bool RenderNextTiles(double timeBudget);
+  bool IsQuiltComplete();
+
+  /// Quilt image, RGB unsigned char scalars.
+  /// It is updated by Render().
+  vtkImageData* GetQuiltImage();
+
+protected:
+  vtkSlicerLookingGlassQuiltRenderer();
+  ~vtkSlicerLookingGlassQuiltRenderer() override;
+
+  /// Read the quilt from the render window into the quilt image.
+  /// Depth of the key views is read as well if views are synthesized.
+  bool ReadQuilt();
+
+  /// Read a single tile from the render window into the quilt image.
+  bool ReadTile(int tile);
+
+  /// Render the tile \a tile in its viewport of the render window.
+  void RenderTile(int tile);
+
+  /// Render the next tiles of the queue with a multi-view pass, or the next
+  /// tile if multi-view rendering is not supported.
+  void RenderMultiViewTiles();
+
+  /// Return true if a visible prop of the renderer can be drawn by the
+  /// multi-view pass.
+  bool HasMultiViewProps();
+
+  /// Synthesize the view \a tile from the surrounding key views.
+  /// Return the ratio of disoccluded pixels.
+  double SynthesizeTile(int tile);
+
+  /// Average the completed quilt image with the accumulated quilts
+  /// if TemporalAccumulation is enabled.
+  void AccumulateQuilt();
+
+  /// Horizontal camera offset of the view \a tile.
+  double GetTileOffset(int tile, double distance);
+
+  vtkRenderWindow* RenderWindow;
+  vtkRenderer* Renderer;
+
+  int QuiltColumns;
+  int QuiltRows;
+  int TileSize[2];
+  double DisplayAspect;
+  double ViewCone;
+  bool UseClippingLimits;
+  double NearClippingLimit;
+  double FarClippingLimit;
+
+  int KeyViewInterval;
+  double MaximumDisocclusionRatio;
+  int NumberOfSynthesizedTiles;
+
+  bool TemporalAccumulation;
+  int NumberOfAccumulatedQuilts;
+  double Jitter[2];
+  /// Running average of the accumulated quilts
+  std::vector<float> AccumulatedQuilt;
+
+  bool MultiViewRendering;
+  int NumberOfMultiViewPasses;
+  vtkSmartPointer<vtkSlicerLookingGlassMultiViewCuller> MultiViewCuller;
+
+  vtkSmartPointer<vtkCamera> QuiltCamera;
+  vtkSmartPointer<vtkCamera> TileCamera;
+  vtkSmartPointer<vtkImageData> QuiltImage;
+  vtkSmartPointer<vtkUnsignedCharArray> TilePixels;
+
+  /// Tiles to render: the key views, then the synthesized views
+  /// that have too many disoccluded pixels.
+  std::vector<int> TileQueue;
+  int NextTile;
+  bool QuiltRead;
+  /// Tiles to synthesize, in the order of SynthesizedTiles
+  std::vector<int> SynthesizedTiles;
+  int NextSynthesizedTile;
+  /// Key views and their depth buffer
+  std::vector<int> KeyViews;
+  std::vector<std::vector<float> > KeyViewDepths;
+  double KeyViewClippingRange[2];
+
+private:
+  vtkSlicerLookingGlassQuiltRenderer(const vtkSlicerLookingGlassQuiltRenderer&); // Not implemented
+  void operator=(const vtkSlicerLookingGlassQuiltRenderer&); // Not implemented
+};
+
+#endif
@@ -0,0 +1,285 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// LookingGlass Logic includes
+#include "vtkSlicerLookingGlassShaderCache.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkShader.h>
+#include <vtkShaderProgram.h>
+#include <vtkVersionMacros.h>
+#include <vtk_glew.h>
+#if VTK_VERSION_NUMBER >= VTK_VERSION_CHECK(9, 1, 0)
+#include <vtkOpenGLState.h>
+#endif
+
+// vtksys includes
+#include <vtksys/MD5.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+/// The program handle and link state are set by vtkShaderProgram when it
+/// links the shaders, programs linked from a binary set them here.
+struct ShaderProgramAccess : public vtkShaderProgram
+{
+  static int vtkShaderProgram::* HandleMember() { return &ShaderProgramAccess::Handle; }
+  static bool vtkShaderProgram::* LinkedMember() { return &ShaderProgramAccess::Linked; }
+};
+
+#if VTK_VERSION_NUMBER >= VTK_VERSION_CHECK(9, 1, 0)
+/// The shader cache is owned by the OpenGL state of the render window,
+/// which has no setter for it.
+struct OpenGLStateAccess : public vtkOpenGLState
+{
+  static vtkOpenGLShaderCache* vtkOpenGLState::* ShaderCacheMember() { return &OpenGLStateAccess::ShaderCache; }
+};
+#endif
+
+//----------------------------------------------------------------------------
+void appendToHash(vtksysMD5* md5, const std::string& text)
+{
+  // Separate the strings so that moving text from one to the next changes the hash
+  vtksysMD5_Append(md5, reinterpret_cast<const unsigned char*>(text.c_str()), static_cast<int>(text.size()) + 1);
+}
+
+//----------------------------------------------------------------------------
+std::string glString(GLenum name)
+{
+  const GLubyte* value = glGetString(name);
+  return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+//----------------------------------------------------------------------------
+void clearGLErrors()
+{
+  while (glGetError() != GL_NO_ERROR)
+    {
+    }
+}
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerLookingGlassShaderCache);
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassShaderCache::vtkSlicerLookingGlassShaderCache()
+  : NumberOfLoadedPrograms(0)
+  , NumberOfSavedPrograms(0)
+  , DriverKeyInitialized(false)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassShaderCache::~vtkSlicerLookingGlassShaderCache()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerLookingGlassShaderCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "CacheDirectory: " << this->CacheDirectory << "\n";
+  os << indent << "NumberOfLoadedPrograms: " << this->NumberOfLoadedPrograms << "\n";
+  os << indent << "NumberOfSavedPrograms: " << this->NumberOfSavedPrograms << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerLookingGlassShaderCache* vtkSlicerLookingGlassShaderCache::Install(
+  vtkOpenGLRenderWindow* renderWindow, const std::string& cacheDirectory)
+{
+#if VTK_VERSION_NUMBER >= VTK_VERSION_CHECK(9, 1, 0)
+  vtkOpenGLState* state = renderWindow ? renderWindow->GetState() : nullptr;
+  if (!state)
+    {
+    return nullptr;
+    }
+  vtkOpenGLShaderCache*& shaderCache = state->*OpenGLStateAccess::ShaderCacheMember();
+  vtkSlicerLookingGlassShaderCache* programBinaryCache = vtkSlicerLookingGlassShaderCache::SafeDownCast(shaderCache);
+  if (!programBinaryCache)
+    {
+    // The state releases its shader cache when it is destroyed
+    programBinaryCache = vtkSlicerLookingGlassShaderCache::New();
+    if (shaderCache)
+      {
+      shaderCache->ReleaseGraphicsResources(renderWindow);
+      shaderCache->Delete();
+      }
+    shaderCache = programBinaryCache;
+    }
+  programBinaryCache->SetCacheDirectory(cacheDirectory);
+  return programBinaryCache;
+#else
+  // The shader cache is owned by the render window before VTK 9.1
+  (void)renderWindow;
+  (void)cacheDirectory;
+  return nullptr;
+#endif
+}
+
+//----------------------------------------------------------------------------
+vtkShaderProgram* vtkSlicerLookingGlassShaderCache::ReadyShaderProgram(
+  vtkShaderProgram* program, vtkTransformFeedback* cap)
+{
+  if (!program || program->GetCompiled() || cap || this->CacheDirectory.empty()
+    || this->GetDriverKey().empty())
+    {
+    return this->Superclass::ReadyShaderProgram(program, cap);
+    }
+
+  std::string path = this->GetProgramBinaryPath(program);
+  bool loaded = this->LoadProgramBinary(program, path);
+  vtkShaderProgram* readyProgram = this->Superclass::ReadyShaderProgram(program, cap);
+  if (readyProgram && !loaded)
+    {
+    this->SaveProgramBinary(readyProgram, path);
+    }
+  return readyProgram;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerLookingGlassShaderCache::GetDriverKey()
+{
+  if (this->DriverKeyInitialized)
+    {
+    return this->DriverKey;
+    }
+  this->DriverKeyInitialized = true;
+  GLint numberOfBinaryFormats = 0;
+  if (glGetProgramBinary && glProgramBinary)
+    {
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numberOfBinaryFormats);
+    }
+  clearGLErrors();
+  if (numberOfBinaryFormats <= 0)
+    {
+    vtkDebugMacro("GetDriverKey: program binaries are not supported, programs are not cached");
+    return this->DriverKey;
+    }
+  // Binaries are only valid for the driver that created them
+  this->DriverKey = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+  return this->DriverKey;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerLookingGlassShaderCache::GetProgramBinaryPath(vtkShaderProgram* program)
+{
+  vtksysMD5* md5 = vtksysMD5_New();
+  vtksysMD5_Initialize(md5);
+  appendToHash(md5, this->DriverKey);
+  appendToHash(md5, program->GetVertexShader()->GetSource());
+  appendToHash(md5, program->GetGeometryShader()->GetSource());
+  appendToHash(md5, program->GetFragmentShader()->GetSource());
+  char hash[32];
+  vtksysMD5_FinalizeHex(md5, hash);
+  vtksysMD5_Delete(md5);
+  return this->CacheDirectory + "/" + std::string(hash, 32) + ".bin";
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassShaderCache::LoadProgramBinary(vtkShaderProgram* program, const std::string& path)
+{
+  std::ifstream file(path.c_str(), std::ios::binary);
+  if (!file)
+    {
+    return false;
+    }
+  GLenum format = 0;
+  file.read(reinterpret_cast<char*>(&format), sizeof(format));
+  std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (binary.empty())
+    {
+    return false;
+    }
+
+  GLuint handle = glCreateProgram();
+  glProgramBinary(handle, format, binary.data(), static_cast<GLsizei>(binary.size()));
+  GLint linked = GL_FALSE;
+  glGetProgramiv(handle, GL_LINK_STATUS, &linked);
+  // Unknown formats are reported as errors, which must not be reported
+  // by the next error check of VTK.
+  clearGLErrors();
+  if (linked != GL_TRUE)
+    {
+    // The driver rejects binaries of another driver build, e.g. after an
+    // update that kept the version string. The program is linked from its
+    // shaders and saved again.
+    glDeleteProgram(handle);
+    vtkDebugMacro("LoadProgramBinary: binary " << path << " rejected by the driver");
+    return false;
+    }
+  program->*ShaderProgramAccess::HandleMember() = static_cast<int>(handle);
+  program->*ShaderProgramAccess::LinkedMember() = true;
+  program->SetCompiled(true);
+  ++this->NumberOfLoadedPrograms;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerLookingGlassShaderCache::SaveProgramBinary(vtkShaderProgram* program, const std::string& path)
+{
+  GLuint handle = static_cast<GLuint>(program->GetHandle());
+  GLint length = 0;
+  glGetProgramiv(handle, GL_PROGRAM_BINARY_LENGTH, &length);
+  std::vector<char> binary(length > 0 ? length : 0);
+  GLsizei writtenLength = 0;
+  GLenum format = 0;
+  if (length > 0)
+    {
+    glGetProgramBinary(handle, length, &writtenLength, &format, binary.data());
+    }
+  clearGLErrors();
+  if (writtenLength <= 0)
+    {
+    return false;
+    }
+
+  if (!vtksys::SystemTools::MakeDirectory(this->CacheDirectory))
+    {
+    vtkWarningMacro("SaveProgramBinary: failed to create shader cache directory " << this->CacheDirectory);
+    this->CacheDirectory.clear();
+    return false;
+    }
+  // Another application instance may read the binary while it is written
+  std::string temporaryPath = path + ".tmp";
+  {
+    std::ofstream file(temporaryPath.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+    file.write(binary.data(), writtenLength);
+    if (!file)
+      {
+      vtkWarningMacro("SaveProgramBinary: failed to write " << temporaryPath);
+      return false;
+      }
+  }
+  vtksys::SystemTools::RemoveFile(path);
+  if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+    vtksys::SystemTools::RemoveFile(temporaryPath);
+    return false;
+    }
+  ++this->NumberOfSavedPrograms;
+  return true;
+}
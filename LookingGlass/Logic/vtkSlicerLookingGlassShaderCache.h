@@ -0,0 +1,102 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerLookingGlassShaderCache_h
+#define __vtkSlicerLookingGlassShaderCache_h
+
+// VTK includes
+#include <vtkOpenGLShaderCache.h>
+
+// STD includes
+#include <string>
+
+#include "vtkSlicerLookingGlassModuleLogicExport.h"
+
+class vtkOpenGLRenderWindow;
+
+/// \brief Shader cache storing the linked programs on disk.
+///
+/// Volume rendering, depth peeling and segmentations use many shader
+/// programs, which are compiled and linked again each time a looking glass
+/// render window is created. This cache saves the binary of each program
+/// it links (glGetProgramBinary) to CacheDirectory, and loads it
+/// (glProgramBinary) instead of compiling the shaders when the same program
+/// is requested again, e.g. after the application is restarted.
+///
+/// Binaries are keyed by the hash of the shader sources and of the OpenGL
+/// vendor, renderer and version strings, so that binaries of another driver
+/// are never loaded. Binaries the driver rejects are compiled and saved
+/// again. Programs using transform feedback are not cached. The cache is
+/// disabled if the driver supports no program binary format.
+class VTK_SLICER_LOOKINGGLASS_MODULE_LOGIC_EXPORT vtkSlicerLookingGlassShaderCache : public vtkOpenGLShaderCache
+{
+public:
+  static vtkSlicerLookingGlassShaderCache* New();
+  vtkTypeMacro(vtkSlicerLookingGlassShaderCache, vtkOpenGLShaderCache);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Directory the program binaries are stored in, created if needed.
+  /// Programs are not cached if empty, which is the default.
+  vtkSetMacro(CacheDirectory, std::string);
+  vtkGetMacro(CacheDirectory, std::string);
+
+  /// Number of programs loaded from and saved to the cache directory.
+  vtkGetMacro(NumberOfLoadedPrograms, int);
+  vtkGetMacro(NumberOfSavedPrograms, int);
+
+  /// Make sure the program is linked and bound, loading its binary from
+  /// the cache directory if it has been saved before.
+  vtkShaderProgram* ReadyShaderProgram(vtkShaderProgram* program, vtkTransformFeedback* cap = nullptr) override;
+  using vtkOpenGLShaderCache::ReadyShaderProgram;
+
+  /// Replace the shader cache of \a renderWindow with a program binary cache
+  /// storing its binaries in \a cacheDirectory. Must be called before the
+  /// window is first rendered. Return the installed cache, nullptr if the
+  /// shader cache of the window cannot be replaced.
+  static vtkSlicerLookingGlassShaderCache* Install(vtkOpenGLRenderWindow* renderWindow,
+    const std::string& cacheDirectory);
+
+protected:
+  vtkSlicerLookingGlassShaderCache();
+  ~vtkSlicerLookingGlassShaderCache() override;
+
+  /// Key of the driver of the current context, empty if the driver supports
+  /// no program binary format.
+  std::string GetDriverKey();
+
+  /// Path of the binary of \a program in the cache directory.
+  std::string GetProgramBinaryPath(vtkShaderProgram* program);
+
+  /// Link \a program from its binary. Return false if there is no binary
+  /// or if the driver rejects it.
+  bool LoadProgramBinary(vtkShaderProgram* program, const std::string& path);
+  /// Save the binary of the linked \a program.
+  bool SaveProgramBinary(vtkShaderProgram* program, const std::string& path);
+
+  std::string CacheDirectory;
+  int NumberOfLoadedPrograms;
+  int NumberOfSavedPrograms;
+  /// Computed once from the first context the cache is used in
+  bool DriverKeyInitialized;
+  std::string DriverKey;
+
+private:
+  vtkSlicerLookingGlassShaderCache(const vtkSlicerLookingGlassShaderCache&); // Not implemented
+  void operator=(const vtkSlicerLookingGlassShaderCache&); // Not implemented
+};
+
+#endif
@@ -0,0 +1,473 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// LookingGlass MRML includes
+#include "vtkMRMLLookingGlassRenderStatistics.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+const int RENDER_STATISTICS_BUFFER_SIZE = 120;
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLLookingGlassRenderStatistics);
+
+//----------------------------------------------------------------------------
+vtkMRMLLookingGlassRenderStatistics::vtkMRMLLookingGlassRenderStatistics()
+  : NextFrameIndex(0)
+  , NumberOfRenderedFrames(0)
+  , NumberOfSkippedFrames(0)
+  , NextGPUFrameIndex(0)
+  , NumberOfGPUFrames(0)
+  , NextPublishIndex(0)
+  , NumberOfPublishedFrames(0)
+  , UploadedGraphicsMemory(0.0)
+  , SharedGraphicsMemory(0.0)
+  , NumberOfAdaptiveAdjustments(0)
+  , AdaptiveGeometryQuality(1.0)
+  , AdaptiveVolumeQuality(1.0)
+  , AdaptiveViewFraction(1.0)
+  , AdaptiveTileScale(1.0)
+{
+  this->Frames.reserve(RENDER_STATISTICS_BUFFER_SIZE);
+  this->GPUFrames.reserve(RENDER_STATISTICS_BUFFER_SIZE);
+  this->PublishLatencies.reserve(RENDER_STATISTICS_BUFFER_SIZE);
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLLookingGlassRenderStatistics::~vtkMRMLLookingGlassRenderStatistics()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassRenderStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfFrames: " << this->GetNumberOfFrames() << "\n";
+  os << indent << "NumberOfRenderedFrames: " << this->NumberOfRenderedFrames << "\n";
+  os << indent << "NumberOfSkippedFrames: " << this->NumberOfSkippedFrames << "\n";
+  os << indent << "LastFrameTime: " << this->GetLastFrameTime() << "\n";
+  os << indent << "MeanFrameTime: " << this->GetMeanFrameTime() << "\n";
+  os << indent << "P95FrameTime: " << this->GetPercentileFrameTime(95.0) << "\n";
+  os << indent << "MaximumFrameTime: " << this->GetMaximumFrameTime() << "\n";
+  os << indent << "FrameRate: " << this->GetFrameRate() << "\n";
+  for (int phase = 0; phase < Phase_Last; ++phase)
+    {
+    os << indent << "Mean" << GetPhaseAsString(phase) << "Time: " << this->GetMeanPhaseTime(phase) << "\n";
+    }
+  os << indent << "NumberOfGPUFrames: " << this->NumberOfGPUFrames << "\n";
+  for (int pass = 0; pass < GPUPass_Last; ++pass)
+    {
+    os << indent << "Mean" << GetGPUPassAsString(pass) << "GPUTime: " << this->GetMeanGPUPassTime(pass) << "\n";
+    }
+  os << indent << "NumberOfPublishedFrames: " << this->NumberOfPublishedFrames << "\n";
+  os << indent << "MeanPublishLatency: " << this->GetMeanPublishLatency() << "\n";
+  os << indent << "MaximumPublishLatency: " << this->GetMaximumPublishLatency() << "\n";
+  os << indent << "UploadedGraphicsMemory: " << this->UploadedGraphicsMemory << "\n";
+  os << indent << "SharedGraphicsMemory: " << this->SharedGraphicsMemory << "\n";
+  os << indent << "NumberOfAdaptiveAdjustments: " << this->NumberOfAdaptiveAdjustments << "\n";
+  os << indent << "LastAdaptiveAdjustment: " << this->LastAdaptiveAdjustment << "\n";
+  os << indent << "AdaptiveGeometryQuality: " << this->AdaptiveGeometryQuality << "\n";
+  os << indent << "AdaptiveVolumeQuality: " << this->AdaptiveVolumeQuality << "\n";
+  os << indent << "AdaptiveViewFraction: " << this->AdaptiveViewFraction << "\n";
+  os << indent << "AdaptiveTileScale: " << this->AdaptiveTileScale << "\n";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLLookingGlassRenderStatistics::GetPhaseAsString(int id)
+{
+  switch (id)
+  {
+  case PhaseCameraSync: return "CameraSync";
+  case PhaseDisplayableManagerUpdate: return "DisplayableManagerUpdate";
+  case PhaseQuiltRender: return "QuiltRender";
+  case PhaseDeviceSubmit: return "DeviceSubmit";
+  default:
+    // invalid id
+    return "";
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLLookingGlassRenderStatistics::GetPhaseFromString(const char* name)
+{
+  if (name == nullptr)
+  {
+    // invalid name
+    return -1;
+  }
+  for (int ii = 0; ii < Phase_Last; ii++)
+  {
+    if (strcmp(name, GetPhaseAsString(ii)) == 0)
+    {
+      // found a matching name
+      return ii;
+    }
+  }
+  // unknown name
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLLookingGlassRenderStatistics::GetGPUPassAsString(int id)
+{
+  switch (id)
+  {
+  case GPUPassTiles: return "Tiles";
+  case GPUPassVolume: return "Volume";
+  case GPUPassTranslucent: return "Translucent";
+  case GPUPassComposition: return "Composition";
+  default:
+    // invalid id
+    return "";
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLLookingGlassRenderStatistics::GetGPUPassFromString(const char* name)
+{
+  if (name == nullptr)
+  {
+    // invalid name
+    return -1;
+  }
+  for (int ii = 0; ii < GPUPass_Last; ii++)
+  {
+    if (strcmp(name, GetGPUPassAsString(ii)) == 0)
+    {
+      // found a matching name
+      return ii;
+    }
+  }
+  // unknown name
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLLookingGlassRenderStatistics::GetBufferSize()
+{
+  return RENDER_STATISTICS_BUFFER_SIZE;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassRenderStatistics::AddFrame(const double* phaseTimes)
+{
+  FrameRecord frame;
+  frame.Timestamp = vtkTimerLog::GetUniversalTime();
+  frame.FrameTime = 0.0;
+  for (int phase = 0; phase < Phase_Last; ++phase)
+    {
+    frame.PhaseTimes[phase] = phaseTimes[phase];
+    frame.FrameTime += phaseTimes[phase];
+    }
+
+  if (static_cast<int>(this->Frames.size()) < RENDER_STATISTICS_BUFFER_SIZE)
+    {
+    this->Frames.push_back(frame);
+    }
+  else
+    {
+    this->Frames[this->NextFrameIndex] = frame;
+    }
+  this->NextFrameIndex = (this->NextFrameIndex + 1) % RENDER_STATISTICS_BUFFER_SIZE;
+  ++this->NumberOfRenderedFrames;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassRenderStatistics::AddGPUFrame(const double* passTimes)
+{
+  GPUFrameRecord frame;
+  for (int pass = 0; pass < GPUPass_Last; ++pass)
+    {
+    frame.PassTimes[pass] = passTimes[pass];
+    }
+
+  if (static_cast<int>(this->GPUFrames.size()) < RENDER_STATISTICS_BUFFER_SIZE)
+    {
+    this->GPUFrames.push_back(frame);
+    }
+  else
+    {
+    this->GPUFrames[this->NextGPUFrameIndex] = frame;
+    }
+  this->NextGPUFrameIndex = (this->NextGPUFrameIndex + 1) % RENDER_STATISTICS_BUFFER_SIZE;
+  ++this->NumberOfGPUFrames;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassRenderStatistics::AddSkippedFrame()
+{
+  ++this->NumberOfSkippedFrames;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassRenderStatistics::AddPublishedFrame(double latency)
+{
+  if (static_cast<int>(this->PublishLatencies.size()) < RENDER_STATISTICS_BUFFER_SIZE)
+    {
+    this->PublishLatencies.push_back(latency);
+    }
+  else
+    {
+    this->PublishLatencies[this->NextPublishIndex] = latency;
+    }
+  this->NextPublishIndex = (this->NextPublishIndex + 1) % RENDER_STATISTICS_BUFFER_SIZE;
+  ++this->NumberOfPublishedFrames;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassRenderStatistics::SetGraphicsMemory(double uploadedSize, double sharedSize)
+{
+  if (this->UploadedGraphicsMemory == uploadedSize && this->SharedGraphicsMemory == sharedSize)
+    {
+    return;
+    }
+  this->UploadedGraphicsMemory = uploadedSize;
+  this->SharedGraphicsMemory = sharedSize;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassRenderStatistics::AddAdaptiveAdjustment(const std::string& description,
+  double geometryQuality, double volumeQuality, double viewFraction, double tileScale)
+{
+  ++this->NumberOfAdaptiveAdjustments;
+  this->LastAdaptiveAdjustment = description;
+  this->AdaptiveGeometryQuality = geometryQuality;
+  this->AdaptiveVolumeQuality = volumeQuality;
+  this->AdaptiveViewFraction = viewFraction;
+  this->AdaptiveTileScale = tileScale;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassRenderStatistics::Reset()
+{
+  this->Frames.clear();
+  this->NextFrameIndex = 0;
+  this->NumberOfRenderedFrames = 0;
+  this->NumberOfSkippedFrames = 0;
+  this->GPUFrames.clear();
+  this->NextGPUFrameIndex = 0;
+  this->NumberOfGPUFrames = 0;
+  this->PublishLatencies.clear();
+  this->NextPublishIndex = 0;
+  this->NumberOfPublishedFrames = 0;
+  this->UploadedGraphicsMemory = 0.0;
+  this->SharedGraphicsMemory = 0.0;
+  this->NumberOfAdaptiveAdjustments = 0;
+  this->LastAdaptiveAdjustment.clear();
+  this->AdaptiveGeometryQuality = 1.0;
+  this->AdaptiveVolumeQuality = 1.0;
+  this->AdaptiveViewFraction = 1.0;
+  this->AdaptiveTileScale = 1.0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLLookingGlassRenderStatistics::GetNumberOfFrames() const
+{
+  return static_cast<int>(this->Frames.size());
+}
+
+//----------------------------------------------------------------------------
+const vtkMRMLLookingGlassRenderStatistics::FrameRecord& vtkMRMLLookingGlassRenderStatistics::GetRecentFrame(int n) const
+{
+  int numberOfFrames = this->GetNumberOfFrames();
+  int index = ((this->NextFrameIndex - 1 - n) % numberOfFrames + numberOfFrames) % numberOfFrames;
+  return this->Frames[index];
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetLastFrameTime() const
+{
+  if (this->Frames.empty())
+    {
+    return 0.0;
+    }
+  return this->GetRecentFrame(0).FrameTime;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetMeanFrameTime() const
+{
+  if (this->Frames.empty())
+    {
+    return 0.0;
+    }
+  double sum = 0.0;
+  for (const FrameRecord& frame : this->Frames)
+    {
+    sum += frame.FrameTime;
+    }
+  return sum / this->Frames.size();
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetMaximumFrameTime() const
+{
+  double maximum = 0.0;
+  for (const FrameRecord& frame : this->Frames)
+    {
+    maximum = std::max(maximum, frame.FrameTime);
+    }
+  return maximum;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetPercentileFrameTime(double percentile) const
+{
+  if (this->Frames.empty())
+    {
+    return 0.0;
+    }
+  std::vector<double> frameTimes;
+  frameTimes.reserve(this->Frames.size());
+  for (const FrameRecord& frame : this->Frames)
+    {
+    frameTimes.push_back(frame.FrameTime);
+    }
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  // Nearest-rank method
+  size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * frameTimes.size()));
+  size_t index = rank > 0 ? rank - 1 : 0;
+  std::nth_element(frameTimes.begin(), frameTimes.begin() + index, frameTimes.end());
+  return frameTimes[index];
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetLastPhaseTime(int phase) const
+{
+  if (this->Frames.empty() || phase < 0 || phase >= Phase_Last)
+    {
+    return 0.0;
+    }
+  return this->GetRecentFrame(0).PhaseTimes[phase];
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetMeanPhaseTime(int phase) const
+{
+  if (this->Frames.empty() || phase < 0 || phase >= Phase_Last)
+    {
+    return 0.0;
+    }
+  double sum = 0.0;
+  for (const FrameRecord& frame : this->Frames)
+    {
+    sum += frame.PhaseTimes[phase];
+    }
+  return sum / this->Frames.size();
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetLastGPUPassTime(int pass) const
+{
+  if (this->GPUFrames.empty() || pass < 0 || pass >= GPUPass_Last)
+    {
+    return 0.0;
+    }
+  int numberOfFrames = static_cast<int>(this->GPUFrames.size());
+  return this->GPUFrames[(this->NextGPUFrameIndex - 1 + numberOfFrames) % numberOfFrames].PassTimes[pass];
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetMeanGPUPassTime(int pass) const
+{
+  if (this->GPUFrames.empty() || pass < 0 || pass >= GPUPass_Last)
+    {
+    return 0.0;
+    }
+  double sum = 0.0;
+  for (const GPUFrameRecord& frame : this->GPUFrames)
+    {
+    sum += frame.PassTimes[pass];
+    }
+  return sum / this->GPUFrames.size();
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetFrameRate() const
+{
+  int numberOfFrames = this->GetNumberOfFrames();
+  if (numberOfFrames < 2)
+    {
+    return 0.0;
+    }
+  double elapsedTime = this->GetRecentFrame(0).Timestamp - this->GetRecentFrame(numberOfFrames - 1).Timestamp;
+  if (elapsedTime <= 0.0)
+    {
+    return 0.0;
+    }
+  return (numberOfFrames - 1) / elapsedTime;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetLastPublishLatency() const
+{
+  if (this->PublishLatencies.empty())
+    {
+    return 0.0;
+    }
+  int numberOfLatencies = static_cast<int>(this->PublishLatencies.size());
+  return this->PublishLatencies[(this->NextPublishIndex - 1 + numberOfLatencies) % numberOfLatencies];
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetMeanPublishLatency() const
+{
+  if (this->PublishLatencies.empty())
+    {
+    return 0.0;
+    }
+  double sum = 0.0;
+  for (double latency : this->PublishLatencies)
+    {
+    sum += latency;
+    }
+  return sum / this->PublishLatencies.size();
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLLookingGlassRenderStatistics::GetMaximumPublishLatency() const
+{
+  double maximum = 0.0;
+  for (double latency : this->PublishLatencies)
+    {
+    maximum = std::max(maximum, latency);
+    }
+  return maximum;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLLookingGlassRenderStatistics::GetLastAdaptiveAdjustment() const
+{
+  return this->LastAdaptiveAdjustment;
+}
@@ -0,0 +1,224 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLLookingGlassRenderStatistics_h
+#define __vtkMRMLLookingGlassRenderStatistics_h
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <string>
+#include <vector>
+
+#include "vtkSlicerLookingGlassModuleMRMLExport.h"
+
+/// \brief Render timing statistics of a looking glass view.
+///
+/// Timing of the most recent frames is kept in a fixed-size ring buffer.
+/// Frames are recorded by the looking glass view widget after each render,
+/// other classes are expected to only query the statistics.
+/// All times are in seconds.
+///
+/// \sa vtkMRMLLookingGlassViewNode::GetRenderStatistics
+class VTK_SLICER_LOOKINGGLASS_MODULE_MRML_EXPORT vtkMRMLLookingGlassRenderStatistics : public vtkObject
+{
+public:
+  static vtkMRMLLookingGlassRenderStatistics* New();
+  vtkTypeMacro(vtkMRMLLookingGlassRenderStatistics, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Rendering phases timed for each frame
+  enum
+  {
+    PhaseCameraSync = 0,
+    PhaseDisplayableManagerUpdate,
+    PhaseQuiltRender,
+    PhaseDeviceSubmit,
+    Phase_Last
+  };
+
+  /// Convert between phase ID and name
+  static const char* GetPhaseAsString(int id);
+  static int GetPhaseFromString(const char* name);
+
+  /// Render passes timed on the GPU for each quilt
+  /// Tiles: renderer passes of all the quilt tiles, volume and translucent
+  ///   passes included
+  /// Volume: volume rendering within the tiles
+  /// Translucent: translucent geometry within the tiles, volumes excluded
+  /// Composition: rendering outside of the tiles, i.e. light field
+  ///   composition for devices and quilt read back for the virtual device
+  enum
+  {
+    GPUPassTiles = 0,
+    GPUPassVolume,
+    GPUPassTranslucent,
+    GPUPassComposition,
+    GPUPass_Last
+  };
+
+  /// Convert between GPU pass ID and name
+  static const char* GetGPUPassAsString(int id);
+  static int GetGPUPassFromString(const char* name);
+
+  /// Maximum number of frames used for computing the statistics.
+  static int GetBufferSize();
+
+  /// Record timing of a rendered frame.
+  /// \a phaseTimes must contain Phase_Last values.
+  void AddFrame(const double* phaseTimes);
+
+  /// Record GPU timing of a rendered quilt, available a few frames after
+  /// the quilt has been rendered. \a passTimes must contain GPUPass_Last values.
+  /// \sa vtkMRMLLookingGlassViewNode::GetGPUTiming
+  void AddGPUFrame(const double* passTimes);
+
+  /// Record a render request that has been skipped because nothing changed.
+  void AddSkippedFrame();
+
+  /// Record a frame published to external consumers, \a latency is the time
+  /// from the end of the quilt rendering to the frame being available.
+  void AddPublishedFrame(double latency);
+
+  /// Record the estimated GPU memory (in MB) used by the data rendered in
+  /// the view: \a uploadedSize is uploaded for the view, \a sharedSize is
+  /// shared with the reference view and not uploaded again.
+  /// \sa vtkMRMLLookingGlassViewNode::GetShareReferenceViewContext
+  void SetGraphicsMemory(double uploadedSize, double sharedSize);
+
+  /// Record an adjustment of the Adaptive rendering mode controller and the
+  /// resulting quality levels, in the [0, 1] range.
+  /// \sa vtkMRMLLookingGlassViewNode::RenderingModeAdaptive
+  void AddAdaptiveAdjustment(const std::string& description, double geometryQuality,
+    double volumeQuality, double viewFraction, double tileScale);
+
+  /// Clear all recorded frames and counters.
+  void Reset();
+
+  /// Number of frames currently in the buffer.
+  int GetNumberOfFrames() const;
+
+  /// Total number of frames rendered since last reset.
+  vtkGetMacro(NumberOfRenderedFrames, unsigned long);
+
+  /// Total number of frames skipped since last reset.
+  vtkGetMacro(NumberOfSkippedFrames, unsigned long);
+
+  /// Frame time statistics. A frame time is the sum of all its phases.
+  /// Return 0 if no frame has been recorded.
+  double GetLastFrameTime() const;
+  double GetMeanFrameTime() const;
+  double GetMaximumFrameTime() const;
+  /// \a percentile is in the [0, 100] range.
+  double GetPercentileFrameTime(double percentile) const;
+
+  /// Phase time statistics.
+  double GetLastPhaseTime(int phase) const;
+  double GetMeanPhaseTime(int phase) const;
+
+  /// Number of frames per second actually rendered, computed from the
+  /// timestamps of the buffered frames.
+  /// Return 0 if less than two frames have been recorded.
+  double GetFrameRate() const;
+
+  /// Total number of frames timed on the GPU since last reset.
+  vtkGetMacro(NumberOfGPUFrames, unsigned long);
+
+  /// GPU pass time statistics of the buffered GPU frames.
+  /// Return 0 if no frame has been timed.
+  double GetLastGPUPassTime(int pass) const;
+  double GetMeanGPUPassTime(int pass) const;
+
+  /// Total number of frames published since last reset.
+  vtkGetMacro(NumberOfPublishedFrames, unsigned long);
+
+  /// Publish latency statistics of the buffered published frames.
+  /// Return 0 if no frame has been published.
+  double GetLastPublishLatency() const;
+  double GetMeanPublishLatency() const;
+  double GetMaximumPublishLatency() const;
+
+  /// Estimated GPU memory (in MB) uploaded for the data rendered in the view.
+  vtkGetMacro(UploadedGraphicsMemory, double);
+
+  /// Estimated GPU memory (in MB) of the data rendered in the view that is
+  /// shared with the reference view. It is the memory and upload size saved
+  /// by sharing the context of the reference view.
+  vtkGetMacro(SharedGraphicsMemory, double);
+
+  /// Total number of adjustments of the Adaptive rendering mode since last reset.
+  vtkGetMacro(NumberOfAdaptiveAdjustments, unsigned long);
+
+  /// Description of the last adaptive adjustment, e.g. "Reduced Volume from
+  /// 1 to 0.5". Empty if none.
+  std::string GetLastAdaptiveAdjustment() const;
+
+  /// Quality levels set by the last adaptive adjustment, 1 if none.
+  vtkGetMacro(AdaptiveGeometryQuality, double);
+  vtkGetMacro(AdaptiveVolumeQuality, double);
+  vtkGetMacro(AdaptiveViewFraction, double);
+  vtkGetMacro(AdaptiveTileScale, double);
+
+protected:
+  vtkMRMLLookingGlassRenderStatistics();
+  ~vtkMRMLLookingGlassRenderStatistics() override;
+
+  struct FrameRecord
+  {
+    double Timestamp;
+    double FrameTime;
+    double PhaseTimes[Phase_Last];
+  };
+
+  /// Return the n-th most recent frame, 0 is the last one.
+  const FrameRecord& GetRecentFrame(int n) const;
+
+  std::vector<FrameRecord> Frames;
+  int NextFrameIndex;
+  unsigned long NumberOfRenderedFrames;
+  unsigned long NumberOfSkippedFrames;
+
+  struct GPUFrameRecord
+  {
+    double PassTimes[GPUPass_Last];
+  };
+
+  std::vector<GPUFrameRecord> GPUFrames;
+  int NextGPUFrameIndex;
+  unsigned long NumberOfGPUFrames;
+
+  std::vector<double> PublishLatencies;
+  int NextPublishIndex;
+  unsigned long NumberOfPublishedFrames;
+
+  double UploadedGraphicsMemory;
+  double SharedGraphicsMemory;
+
+  unsigned long NumberOfAdaptiveAdjustments;
+  std::string LastAdaptiveAdjustment;
+  double AdaptiveGeometryQuality;
+  double AdaptiveVolumeQuality;
+  double AdaptiveViewFraction;
+  double AdaptiveTileScale;
+
+private:
+  vtkMRMLLookingGlassRenderStatistics(const vtkMRMLLookingGlassRenderStatistics&); // Not implemented
+  void operator=(const vtkMRMLLookingGlassRenderStatistics&); // Not implemented
+};
+
+#endif
@@ -15,12 +15,14 @@ Version:   $Revision: 1.3 $
 // MRML includes
 #include "vtkMRMLScene.h"
 #include "vtkMRMLViewNode.h"
+#include "vtkMRMLLookingGlassRenderStatistics.h"
 #include "vtkMRMLLookingGlassViewNode.h"
 
 // VTK includes
 #include <vtkObjectFactory.h>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
 
 const char* vtkMRMLLookingGlassViewNode::ReferenceViewNodeReferenceRole = "ReferenceViewNodeRef";
@@ -32,10 +34,39 @@ vtkMRMLNodeNewMacro(vtkMRMLLookingGlassViewNode);
 vtkMRMLLookingGlassViewNode::vtkMRMLLookingGlassViewNode()
   : RenderingMode(vtkMRMLLookingGlassViewNode::RenderingModeOnlyStillRenders)
   , DesiredUpdateRate(60.0)
+  , ReduceQualityDuringInteraction(true)
+  , InteractiveTriangleBudget(20000000)
+  , TransparencyMode(vtkMRMLLookingGlassViewNode::TransparencyModeDefault)
+  , MaximumNumberOfPeels(4)
+  , AdaptiveMinimumGeometryQuality(0.1)
+  , AdaptiveMinimumVolumeQuality(0.25)
+  , AdaptiveMinimumViewFraction(0.25)
+  , AdaptiveMinimumTileScale(0.5)
+  , TemporalAccumulation(false)
+  , MaximumNumberOfAccumulatedFrames(16)
+  , MultiViewRendering(false)
+  , GPUTiming(false)
+  , GPUTimingOverlay(false)
+  , VolumeRenderingStillOversamplingFactor(1.0)
+  , VolumeRenderingInteractiveOversamplingFactor(0.5)
+  , VolumeRenderingAutoDownsampling(true)
   , UseClippingLimits(false)
   , NearClippingLimit(0.8)
   , FarClippingLimit(1.2)
-
+  , VirtualDevice(false)
+  , VirtualDeviceProfile(vtkMRMLLookingGlassViewNode::VirtualDeviceProfilePortrait)
+  , QuiltColumns(8)
+  , QuiltRows(6)
+  , DisplayAspect(0.75)
+  , ViewCone(40.0)
+  , QuiltRenderTimeSlice(0.016)
+  , SuspendedResourcesTimeout(300.0)
+  , SuspendedResourcesMemoryLimit(2048)
+  , QuiltPublishing(false)
+  , QuiltPublishingKey("SlicerLookingGlassQuilt")
+  , DeviceIndex(0)
+  , ShareReferenceViewContext(false)
+  , RenderStatistics(vtkMRMLLookingGlassRenderStatistics::New())
 {
   this->Visibility = 0; // hidden by default to not connect to the headset until it is needed
   this->BackgroundColor[0] = this->defaultBackgroundColor()[0];
@@ -44,11 +75,15 @@ vtkMRMLLookingGlassViewNode::vtkMRMLLookingGlassViewNode()
   this->BackgroundColor2[0] = this->defaultBackgroundColor2()[0];
   this->BackgroundColor2[1] = this->defaultBackgroundColor2()[1];
   this->BackgroundColor2[2] = this->defaultBackgroundColor2()[2];
+  this->TileSize[0] = 420;
+  this->TileSize[1] = 560;
+  this->DisplayableManagers = vtkMRMLLookingGlassViewNode::GetDefaultDisplayableManagers();
 }
 
 //----------------------------------------------------------------------------
 vtkMRMLLookingGlassViewNode::~vtkMRMLLookingGlassViewNode()
 {
+  this->RenderStatistics->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -65,9 +100,40 @@ void vtkMRMLLookingGlassViewNode::WriteXML(ostream& of, int nIndent)
   vtkMRMLWriteXMLBeginMacro(of);
   vtkMRMLWriteXMLEnumMacro(renderingMode, RenderingMode);
   vtkMRMLWriteXMLFloatMacro(desiredUpdateRate, DesiredUpdateRate);
+  vtkMRMLWriteXMLBooleanMacro(reduceQualityDuringInteraction, ReduceQualityDuringInteraction);
+  vtkMRMLWriteXMLIntMacro(interactiveTriangleBudget, InteractiveTriangleBudget);
+  vtkMRMLWriteXMLEnumMacro(transparencyMode, TransparencyMode);
+  vtkMRMLWriteXMLIntMacro(maximumNumberOfPeels, MaximumNumberOfPeels);
+  vtkMRMLWriteXMLFloatMacro(adaptiveMinimumGeometryQuality, AdaptiveMinimumGeometryQuality);
+  vtkMRMLWriteXMLFloatMacro(adaptiveMinimumVolumeQuality, AdaptiveMinimumVolumeQuality);
+  vtkMRMLWriteXMLFloatMacro(adaptiveMinimumViewFraction, AdaptiveMinimumViewFraction);
+  vtkMRMLWriteXMLFloatMacro(adaptiveMinimumTileScale, AdaptiveMinimumTileScale);
+  vtkMRMLWriteXMLBooleanMacro(temporalAccumulation, TemporalAccumulation);
+  vtkMRMLWriteXMLIntMacro(maximumNumberOfAccumulatedFrames, MaximumNumberOfAccumulatedFrames);
+  vtkMRMLWriteXMLBooleanMacro(multiViewRendering, MultiViewRendering);
+  vtkMRMLWriteXMLBooleanMacro(gpuTiming, GPUTiming);
+  vtkMRMLWriteXMLBooleanMacro(gpuTimingOverlay, GPUTimingOverlay);
+  vtkMRMLWriteXMLFloatMacro(volumeRenderingStillOversamplingFactor, VolumeRenderingStillOversamplingFactor);
+  vtkMRMLWriteXMLFloatMacro(volumeRenderingInteractiveOversamplingFactor, VolumeRenderingInteractiveOversamplingFactor);
+  vtkMRMLWriteXMLBooleanMacro(volumeRenderingAutoDownsampling, VolumeRenderingAutoDownsampling);
   vtkMRMLWriteXMLBooleanMacro(useClippingLimits, UseClippingLimits);
   vtkMRMLWriteXMLFloatMacro(nearClippingLimit, NearClippingLimit);
   vtkMRMLWriteXMLFloatMacro(farClippingLimit, FarClippingLimit);
+  vtkMRMLWriteXMLBooleanMacro(virtualDevice, VirtualDevice);
+  vtkMRMLWriteXMLEnumMacro(virtualDeviceProfile, VirtualDeviceProfile);
+  vtkMRMLWriteXMLIntMacro(quiltColumns, QuiltColumns);
+  vtkMRMLWriteXMLIntMacro(quiltRows, QuiltRows);
+  vtkMRMLWriteXMLVectorMacro(tileSize, TileSize, int, 2);
+  vtkMRMLWriteXMLFloatMacro(displayAspect, DisplayAspect);
+  vtkMRMLWriteXMLFloatMacro(viewCone, ViewCone);
+  vtkMRMLWriteXMLFloatMacro(quiltRenderTimeSlice, QuiltRenderTimeSlice);
+  vtkMRMLWriteXMLStdStringMacro(displayableManagers, DisplayableManagersAsString);
+  vtkMRMLWriteXMLFloatMacro(suspendedResourcesTimeout, SuspendedResourcesTimeout);
+  vtkMRMLWriteXMLIntMacro(suspendedResourcesMemoryLimit, SuspendedResourcesMemoryLimit);
+  vtkMRMLWriteXMLBooleanMacro(quiltPublishing, QuiltPublishing);
+  vtkMRMLWriteXMLStdStringMacro(quiltPublishingKey, QuiltPublishingKey);
+  vtkMRMLWriteXMLIntMacro(deviceIndex, DeviceIndex);
+  vtkMRMLWriteXMLBooleanMacro(shareReferenceViewContext, ShareReferenceViewContext);
   vtkMRMLWriteXMLEndMacro();
 }
 
@@ -81,9 +147,41 @@ void vtkMRMLLookingGlassViewNode::ReadXMLAttributes(const char** atts)
   vtkMRMLReadXMLBeginMacro(atts);
   vtkMRMLReadXMLEnumMacro(renderingMode, RenderingMode);
   vtkMRMLReadXMLFloatMacro(desiredUpdateRate, DesiredUpdateRate);
+  vtkMRMLReadXMLBooleanMacro(reduceQualityDuringInteraction, ReduceQualityDuringInteraction);
+  vtkMRMLReadXMLIntMacro(interactiveTriangleBudget, InteractiveTriangleBudget);
+  vtkMRMLReadXMLEnumMacro(transparencyMode, TransparencyMode);
+  vtkMRMLReadXMLIntMacro(maximumNumberOfPeels, MaximumNumberOfPeels);
+  vtkMRMLReadXMLFloatMacro(adaptiveMinimumGeometryQuality, AdaptiveMinimumGeometryQuality);
+  vtkMRMLReadXMLFloatMacro(adaptiveMinimumVolumeQuality, AdaptiveMinimumVolumeQuality);
+  vtkMRMLReadXMLFloatMacro(adaptiveMinimumViewFraction, AdaptiveMinimumViewFraction);
+  vtkMRMLReadXMLFloatMacro(adaptiveMinimumTileScale, AdaptiveMinimumTileScale);
+  vtkMRMLReadXMLBooleanMacro(temporalAccumulation, TemporalAccumulation);
+  vtkMRMLReadXMLIntMacro(maximumNumberOfAccumulatedFrames, MaximumNumberOfAccumulatedFrames);
+  vtkMRMLReadXMLBooleanMacro(multiViewRendering, MultiViewRendering);
+  vtkMRMLReadXMLBooleanMacro(gpuTiming, GPUTiming);
+  vtkMRMLReadXMLBooleanMacro(gpuTimingOverlay, GPUTimingOverlay);
+  vtkMRMLReadXMLFloatMacro(volumeRenderingStillOversamplingFactor, VolumeRenderingStillOversamplingFactor);
+  vtkMRMLReadXMLFloatMacro(volumeRenderingInteractiveOversamplingFactor, VolumeRenderingInteractiveOversamplingFactor);
+  vtkMRMLReadXMLBooleanMacro(volumeRenderingAutoDownsampling, VolumeRenderingAutoDownsampling);
   vtkMRMLReadXMLBooleanMacro(useClippingLimits, UseClippingLimits);
   vtkMRMLReadXMLFloatMacro(nearClippingLimit, NearClippingLimit);
   vtkMRMLReadXMLFloatMacro(farClippingLimit, FarClippingLimit);
+  vtkMRMLReadXMLBooleanMacro(virtualDevice, VirtualDevice);
+  // Profile sets the quilt layout, it must be read before the layout
+  vtkMRMLReadXMLEnumMacro(virtualDeviceProfile, VirtualDeviceProfile);
+  vtkMRMLReadXMLIntMacro(quiltColumns, QuiltColumns);
+  vtkMRMLReadXMLIntMacro(quiltRows, QuiltRows);
+  vtkMRMLReadXMLVectorMacro(tileSize, TileSize, int, 2);
+  vtkMRMLReadXMLFloatMacro(displayAspect, DisplayAspect);
+  vtkMRMLReadXMLFloatMacro(viewCone, ViewCone);
+  vtkMRMLReadXMLFloatMacro(quiltRenderTimeSlice, QuiltRenderTimeSlice);
+  vtkMRMLReadXMLStdStringMacro(displayableManagers, DisplayableManagersAsString);
+  vtkMRMLReadXMLFloatMacro(suspendedResourcesTimeout, SuspendedResourcesTimeout);
+  vtkMRMLReadXMLIntMacro(suspendedResourcesMemoryLimit, SuspendedResourcesMemoryLimit);
+  vtkMRMLReadXMLBooleanMacro(quiltPublishing, QuiltPublishing);
+  vtkMRMLReadXMLStdStringMacro(quiltPublishingKey, QuiltPublishingKey);
+  vtkMRMLReadXMLIntMacro(deviceIndex, DeviceIndex);
+  vtkMRMLReadXMLBooleanMacro(shareReferenceViewContext, ShareReferenceViewContext);
   vtkMRMLReadXMLEndMacro();
 
   this->EndModify(disabledModify);
@@ -101,9 +199,40 @@ void vtkMRMLLookingGlassViewNode::Copy(vtkMRMLNode* anode)
   vtkMRMLCopyBeginMacro(anode);
   vtkMRMLCopyEnumMacro(RenderingMode);
   vtkMRMLCopyFloatMacro(DesiredUpdateRate);
+  vtkMRMLCopyBooleanMacro(ReduceQualityDuringInteraction);
+  vtkMRMLCopyIntMacro(InteractiveTriangleBudget);
+  vtkMRMLCopyEnumMacro(TransparencyMode);
+  vtkMRMLCopyIntMacro(MaximumNumberOfPeels);
+  vtkMRMLCopyFloatMacro(AdaptiveMinimumGeometryQuality);
+  vtkMRMLCopyFloatMacro(AdaptiveMinimumVolumeQuality);
+  vtkMRMLCopyFloatMacro(AdaptiveMinimumViewFraction);
+  vtkMRMLCopyFloatMacro(AdaptiveMinimumTileScale);
+  vtkMRMLCopyBooleanMacro(TemporalAccumulation);
+  vtkMRMLCopyIntMacro(MaximumNumberOfAccumulatedFrames);
+  vtkMRMLCopyBooleanMacro(MultiViewRendering);
+  vtkMRMLCopyBooleanMacro(GPUTiming);
+  vtkMRMLCopyBooleanMacro(GPUTimingOverlay);
+  vtkMRMLCopyFloatMacro(VolumeRenderingStillOversamplingFactor);
+  vtkMRMLCopyFloatMacro(VolumeRenderingInteractiveOversamplingFactor);
+  vtkMRMLCopyBooleanMacro(VolumeRenderingAutoDownsampling);
   vtkMRMLCopyBooleanMacro(UseClippingLimits);
   vtkMRMLCopyFloatMacro(NearClippingLimit);
   vtkMRMLCopyFloatMacro(FarClippingLimit);
+  vtkMRMLCopyBooleanMacro(VirtualDevice);
+  vtkMRMLCopyEnumMacro(VirtualDeviceProfile);
+  vtkMRMLCopyIntMacro(QuiltColumns);
+  vtkMRMLCopyIntMacro(QuiltRows);
+  vtkMRMLCopyVectorMacro(TileSize, int, 2);
+  vtkMRMLCopyFloatMacro(DisplayAspect);
+  vtkMRMLCopyFloatMacro(ViewCone);
+  vtkMRMLCopyFloatMacro(QuiltRenderTimeSlice);
+  vtkMRMLCopyStdStringMacro(DisplayableManagersAsString);
+  vtkMRMLCopyFloatMacro(SuspendedResourcesTimeout);
+  vtkMRMLCopyIntMacro(SuspendedResourcesMemoryLimit);
+  vtkMRMLCopyBooleanMacro(QuiltPublishing);
+  vtkMRMLCopyStdStringMacro(QuiltPublishingKey);
+  vtkMRMLCopyIntMacro(DeviceIndex);
+  vtkMRMLCopyBooleanMacro(ShareReferenceViewContext);
   vtkMRMLCopyEndMacro();
 
   this->EndModify(disabledModify);
@@ -117,9 +246,40 @@ void vtkMRMLLookingGlassViewNode::PrintSelf(ostream& os, vtkIndent indent)
   vtkMRMLPrintBeginMacro(os, indent);
   vtkMRMLPrintEnumMacro(RenderingMode);
   vtkMRMLPrintFloatMacro(DesiredUpdateRate);
+  vtkMRMLPrintBooleanMacro(ReduceQualityDuringInteraction);
+  vtkMRMLPrintIntMacro(InteractiveTriangleBudget);
+  vtkMRMLPrintEnumMacro(TransparencyMode);
+  vtkMRMLPrintIntMacro(MaximumNumberOfPeels);
+  vtkMRMLPrintFloatMacro(AdaptiveMinimumGeometryQuality);
+  vtkMRMLPrintFloatMacro(AdaptiveMinimumVolumeQuality);
+  vtkMRMLPrintFloatMacro(AdaptiveMinimumViewFraction);
+  vtkMRMLPrintFloatMacro(AdaptiveMinimumTileScale);
+  vtkMRMLPrintBooleanMacro(TemporalAccumulation);
+  vtkMRMLPrintIntMacro(MaximumNumberOfAccumulatedFrames);
+  vtkMRMLPrintBooleanMacro(MultiViewRendering);
+  vtkMRMLPrintBooleanMacro(GPUTiming);
+  vtkMRMLPrintBooleanMacro(GPUTimingOverlay);
+  vtkMRMLPrintFloatMacro(VolumeRenderingStillOversamplingFactor);
+  vtkMRMLPrintFloatMacro(VolumeRenderingInteractiveOversamplingFactor);
+  vtkMRMLPrintBooleanMacro(VolumeRenderingAutoDownsampling);
   vtkMRMLPrintBooleanMacro(UseClippingLimits);
   vtkMRMLPrintFloatMacro(NearClippingLimit);
   vtkMRMLPrintFloatMacro(FarClippingLimit);
+  vtkMRMLPrintBooleanMacro(VirtualDevice);
+  vtkMRMLPrintEnumMacro(VirtualDeviceProfile);
+  vtkMRMLPrintIntMacro(QuiltColumns);
+  vtkMRMLPrintIntMacro(QuiltRows);
+  vtkMRMLPrintVectorMacro(TileSize, int, 2);
+  vtkMRMLPrintFloatMacro(DisplayAspect);
+  vtkMRMLPrintFloatMacro(ViewCone);
+  vtkMRMLPrintFloatMacro(QuiltRenderTimeSlice);
+  vtkMRMLPrintStdStringMacro(DisplayableManagersAsString);
+  vtkMRMLPrintFloatMacro(SuspendedResourcesTimeout);
+  vtkMRMLPrintIntMacro(SuspendedResourcesMemoryLimit);
+  vtkMRMLPrintBooleanMacro(QuiltPublishing);
+  vtkMRMLPrintStdStringMacro(QuiltPublishingKey);
+  vtkMRMLPrintIntMacro(DeviceIndex);
+  vtkMRMLPrintBooleanMacro(ShareReferenceViewContext);
   vtkMRMLPrintEndMacro();
 }
 
@@ -199,6 +359,7 @@ const char* vtkMRMLLookingGlassViewNode::GetRenderingModeAsString(int id)
   case RenderingModeOnlyWhenRequested: return "OnlyWhenRequested";
   case RenderingModeOnlyStillRenders: return "OnlyStillRenders";
   case RenderingModeAlways: return "Always";
+  case RenderingModeAdaptive: return "Adaptive";
   default:
     // invalid id
     return "";
@@ -225,6 +386,252 @@ int vtkMRMLLookingGlassViewNode::GetRenderingModeFromString(const char* name)
   return -1;
 }
 
+//----------------------------------------------------------------------------
+std::string vtkMRMLLookingGlassViewNode::GetTransparencyModeAsString()
+{
+  return vtkMRMLLookingGlassViewNode::GetTransparencyModeAsString(this->TransparencyMode);
+}
+
+//-----------------------------------------------------------
+const char* vtkMRMLLookingGlassViewNode::GetTransparencyModeAsString(int id)
+{
+  switch (id)
+  {
+  case TransparencyModeDefault: return "Default";
+  case TransparencyModeDualDepthPeeling: return "DualDepthPeeling";
+  case TransparencyModeWeightedBlended: return "WeightedBlended";
+  default:
+    // invalid id
+    return "";
+  }
+}
+
+//-----------------------------------------------------------
+int vtkMRMLLookingGlassViewNode::GetTransparencyModeFromString(const char* name)
+{
+  if (name == nullptr)
+  {
+    // invalid name
+    return -1;
+  }
+  for (int ii = 0; ii < TransparencyMode_Last; ii++)
+  {
+    if (strcmp(name, GetTransparencyModeAsString(ii)) == 0)
+    {
+      // found a matching name
+      return ii;
+    }
+  }
+  // unknown name
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassViewNode::SetTileSize(int width, int height)
+{
+  // Larger tiles exceed the texture size limit of most GPUs
+  const int maximumTileSize = 8192;
+  width = std::min(std::max(width, 1), maximumTileSize);
+  height = std::min(std::max(height, 1), maximumTileSize);
+  if (this->TileSize[0] == width && this->TileSize[1] == height)
+  {
+    return;
+  }
+  this->TileSize[0] = width;
+  this->TileSize[1] = height;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassViewNode::SetTileSize(const int size[2])
+{
+  this->SetTileSize(size[0], size[1]);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassViewNode::SetVirtualDeviceProfile(int profile)
+{
+  if (profile < 0 || profile >= VirtualDeviceProfile_Last)
+  {
+    vtkErrorMacro("SetVirtualDeviceProfile: invalid profile " << profile);
+    return;
+  }
+  int disabledModify = this->StartModify();
+  if (this->VirtualDeviceProfile != profile)
+  {
+    this->VirtualDeviceProfile = profile;
+    this->Modified();
+  }
+  switch (profile)
+  {
+  case VirtualDeviceProfilePortrait:
+    this->SetQuiltColumns(8);
+    this->SetQuiltRows(6);
+    this->SetTileSize(420, 560);
+    this->SetDisplayAspect(0.75);
+    this->SetViewCone(40.0);
+    break;
+  case VirtualDeviceProfileStandard:
+    this->SetQuiltColumns(5);
+    this->SetQuiltRows(9);
+    this->SetTileSize(819, 455);
+    this->SetDisplayAspect(1.6);
+    this->SetViewCone(40.0);
+    break;
+  case VirtualDeviceProfileLarge:
+    this->SetQuiltColumns(5);
+    this->SetQuiltRows(9);
+    this->SetTileSize(819, 455);
+    this->SetDisplayAspect(16.0 / 9.0);
+    this->SetViewCone(40.0);
+    break;
+  default:
+    // custom layout is left unchanged
+    break;
+  }
+  this->EndModify(disabledModify);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLLookingGlassViewNode::GetVirtualDeviceProfileAsString()
+{
+  return vtkMRMLLookingGlassViewNode::GetVirtualDeviceProfileAsString(this->VirtualDeviceProfile);
+}
+
+//-----------------------------------------------------------
+const char* vtkMRMLLookingGlassViewNode::GetVirtualDeviceProfileAsString(int id)
+{
+  switch (id)
+  {
+  case VirtualDeviceProfilePortrait: return "Portrait";
+  case VirtualDeviceProfileStandard: return "Standard";
+  case VirtualDeviceProfileLarge: return "Large";
+  case VirtualDeviceProfileCustom: return "Custom";
+  default:
+    // invalid id
+    return "";
+  }
+}
+
+//-----------------------------------------------------------
+int vtkMRMLLookingGlassViewNode::GetVirtualDeviceProfileFromString(const char* name)
+{
+  if (name == nullptr)
+  {
+    // invalid name
+    return -1;
+  }
+  for (int ii = 0; ii < VirtualDeviceProfile_Last; ii++)
+  {
+    if (strcmp(name, GetVirtualDeviceProfileAsString(ii)) == 0)
+    {
+      // found a matching name
+      return ii;
+    }
+  }
+  // unknown name
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+std::vector<std::string> vtkMRMLLookingGlassViewNode::GetDefaultDisplayableManagers()
+{
+  std::vector<std::string> displayableManagers;
+  displayableManagers.push_back("vtkMRMLCameraDisplayableManager");
+  displayableManagers.push_back("vtkMRMLModelDisplayableManager");
+  displayableManagers.push_back("vtkMRMLThreeDReformatDisplayableManager");
+  displayableManagers.push_back("vtkMRMLCrosshairDisplayableManager3D");
+  displayableManagers.push_back("vtkMRMLOrientationMarkerDisplayableManager");
+  displayableManagers.push_back("vtkMRMLRulerDisplayableManager");
+  displayableManagers.push_back("vtkMRMLAnnotationDisplayableManager");
+  displayableManagers.push_back("vtkMRMLMarkupsDisplayableManager");
+  displayableManagers.push_back("vtkMRMLSegmentationsDisplayableManager3D");
+  displayableManagers.push_back("vtkMRMLTransformsDisplayableManager3D");
+  displayableManagers.push_back("vtkMRMLLinearTransformsDisplayableManager3D");
+  displayableManagers.push_back("vtkMRMLVolumeRenderingDisplayableManager");
+  return displayableManagers;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassViewNode::SetDisplayableManagers(const std::vector<std::string>& displayableManagers)
+{
+  if (this->DisplayableManagers == displayableManagers)
+  {
+    return;
+  }
+  this->DisplayableManagers = displayableManagers;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+const std::vector<std::string>& vtkMRMLLookingGlassViewNode::GetDisplayableManagers()
+{
+  return this->DisplayableManagers;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassViewNode::AddDisplayableManager(const std::string& displayableManager)
+{
+  if (displayableManager.empty() || this->HasDisplayableManager(displayableManager))
+  {
+    return;
+  }
+  this->DisplayableManagers.push_back(displayableManager);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassViewNode::RemoveDisplayableManager(const std::string& displayableManager)
+{
+  std::vector<std::string>::iterator it =
+    std::find(this->DisplayableManagers.begin(), this->DisplayableManagers.end(), displayableManager);
+  if (it == this->DisplayableManagers.end())
+  {
+    return;
+  }
+  this->DisplayableManagers.erase(it);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLLookingGlassViewNode::HasDisplayableManager(const std::string& displayableManager)
+{
+  return std::find(this->DisplayableManagers.begin(), this->DisplayableManagers.end(), displayableManager)
+    != this->DisplayableManagers.end();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLLookingGlassViewNode::GetDisplayableManagersAsString()
+{
+  std::string displayableManagers;
+  for (const std::string& displayableManager : this->DisplayableManagers)
+  {
+    if (!displayableManagers.empty())
+    {
+      displayableManagers += " ";
+    }
+    displayableManagers += displayableManager;
+  }
+  return displayableManagers;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLLookingGlassViewNode::SetDisplayableManagersAsString(const std::string& displayableManagers)
+{
+  std::vector<std::string> displayableManagerList;
+  std::stringstream ss(displayableManagers);
+  std::string displayableManager;
+  while (ss >> displayableManager)
+  {
+    if (std::find(displayableManagerList.begin(), displayableManagerList.end(), displayableManager)
+      == displayableManagerList.end())
+    {
+      displayableManagerList.push_back(displayableManager);
+    }
+  }
+  this->SetDisplayableManagers(displayableManagerList);
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLLookingGlassViewNode::HasError()
 {
@@ -254,3 +661,9 @@ std::string vtkMRMLLookingGlassViewNode::GetError() const
 {
   return this->LastErrorMessage;
 }
+
+//----------------------------------------------------------------------------
+vtkMRMLLookingGlassRenderStatistics* vtkMRMLLookingGlassViewNode::GetRenderStatistics()
+{
+  return this->RenderStatistics;
+}
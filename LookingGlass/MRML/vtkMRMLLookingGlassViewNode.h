@@ -24,6 +24,12 @@
 
 #include "vtkSlicerLookingGlassModuleMRMLExport.h"
 
+// STD includes
+#include <string>
+#include <vector>
+
+class vtkMRMLLookingGlassRenderStatistics;
+
 /// \brief MRML node to represent a 3D view.
 ///
 /// View node contains view parameters.
@@ -76,11 +82,15 @@ public:
   /// OnlyWhenRequested
   /// OnlyStillRenders
   /// Always
+  /// Adaptive: render as in Always mode, and continuously adjust the
+  ///   rendering quality from the measured frame times to hold the desired
+  ///   update rate, down to the Adaptive* quality floors
   enum
   {
     RenderingModeOnlyWhenRequested = 0,
     RenderingModeOnlyStillRenders = 1,
     RenderingModeAlways = 2,
+    RenderingModeAdaptive = 3,
     RenderingMode_Last
   };
 
@@ -99,6 +109,136 @@ public:
   vtkGetMacro(DesiredUpdateRate, double);
   vtkSetMacro(DesiredUpdateRate, double);
 
+  /// Reduce rendering quality while the reference view is interacted with,
+  /// so that the desired update rate is met even for heavy scenes.
+  /// The quality level is adapted from the measured frame times and full
+  /// quality is restored when the interaction ends.
+  /// Only used in RenderingModeAlways.
+  vtkGetMacro(ReduceQualityDuringInteraction, bool);
+  vtkSetMacro(ReduceQualityDuringInteraction, bool);
+  vtkBooleanMacro(ReduceQualityDuringInteraction, bool);
+
+  /// Maximum number of triangles rendered per quilt for reduced quality
+  /// renders, scaled by the quality level. Large models and segmentations
+  /// are rendered with decimated proxies to fit the budget, full detail is
+  /// used for full quality renders. 0 disables the proxies.
+  /// Default is 20000000.
+  vtkGetMacro(InteractiveTriangleBudget, int);
+  vtkSetMacro(InteractiveTriangleBudget, int);
+
+  /// Transparency mode options
+  /// Default: depth peeling if UseDepthPeeling is enabled, as other 3D views
+  /// DualDepthPeeling: depth peeling of translucent geometry and volumes,
+  ///   using dual depth peeling if supported by the graphics driver
+  /// WeightedBlended: single pass weighted blended order independent
+  ///   transparency, approximate but much faster as it is done for every tile
+  enum
+  {
+    TransparencyModeDefault = 0,
+    TransparencyModeDualDepthPeeling = 1,
+    TransparencyModeWeightedBlended = 2,
+    TransparencyMode_Last
+  };
+
+  /// Get/Set how translucent geometry is rendered in each quilt tile.
+  /// Default is TransparencyModeDefault.
+  vtkSetClampMacro(TransparencyMode, int, 0, vtkMRMLLookingGlassViewNode::TransparencyMode_Last - 1);
+  vtkGetMacro(TransparencyMode, int);
+  std::string GetTransparencyModeAsString();
+
+  /// Convert between transparency mode ID and name
+  static const char* GetTransparencyModeAsString(int id);
+  static int GetTransparencyModeFromString(const char* name);
+
+  /// Maximum number of depth peeling passes per quilt tile for full quality
+  /// renders, fewer passes are used for reduced quality renders.
+  /// Default is 4.
+  vtkSetClampMacro(MaximumNumberOfPeels, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfPeels, int);
+
+  /// Quality floors of the Adaptive rendering mode, in the [0, 1] range.
+  /// A floor of 1 prevents the corresponding quality from being reduced.
+  /// The knobs are reduced in this order and restored in the reverse order.
+  /// \sa vtkSlicerLookingGlassFrameTimeController
+  ///
+  /// Lowest fraction of InteractiveTriangleBudget used for large models.
+  /// Default is 0.1.
+  vtkSetClampMacro(AdaptiveMinimumGeometryQuality, double, 0.0, 1.0);
+  vtkGetMacro(AdaptiveMinimumGeometryQuality, double);
+  /// Lowest fraction of VolumeRenderingInteractiveOversamplingFactor used
+  /// for volumes, if VolumeRenderingAutoDownsampling is enabled.
+  /// Default is 0.25.
+  vtkSetClampMacro(AdaptiveMinimumVolumeQuality, double, 0.0, 1.0);
+  vtkGetMacro(AdaptiveMinimumVolumeQuality, double);
+  /// Lowest fraction of the quilt views actually rendered, the other views
+  /// are synthesized. Only used with a virtual device.
+  /// Default is 0.25.
+  vtkSetClampMacro(AdaptiveMinimumViewFraction, double, 0.0, 1.0);
+  vtkGetMacro(AdaptiveMinimumViewFraction, double);
+  /// Lowest scale of TileSize. Only used with a virtual device.
+  /// Default is 0.5.
+  vtkSetClampMacro(AdaptiveMinimumTileScale, double, 0.0, 1.0);
+  vtkGetMacro(AdaptiveMinimumTileScale, double);
+
+  /// Anti-alias the quilt of still scenes by temporal accumulation: while
+  /// the camera and the scene are unchanged, the quilt is rendered again
+  /// with a different sub-pixel jitter when the application is idle and
+  /// averaged with the previous ones, up to MaximumNumberOfAccumulatedFrames.
+  /// Any change restarts the accumulation. Devices, whose quilt is not read
+  /// back, use fast approximate anti-aliasing for full quality renders instead.
+  /// Default is false.
+  vtkGetMacro(TemporalAccumulation, bool);
+  vtkSetMacro(TemporalAccumulation, bool);
+  vtkBooleanMacro(TemporalAccumulation, bool);
+
+  /// Number of jittered frames averaged by the temporal accumulation.
+  /// Default is 16.
+  vtkSetClampMacro(MaximumNumberOfAccumulatedFrames, int, 1, 1024);
+  vtkGetMacro(MaximumNumberOfAccumulatedFrames, int);
+
+  /// Draw the opaque models and segmentations of the quilt for several views
+  /// in one pass, instead of once per view. Only used by the virtual device,
+  /// if the graphics card supports it. Default is false.
+  vtkGetMacro(MultiViewRendering, bool);
+  vtkSetMacro(MultiViewRendering, bool);
+  vtkBooleanMacro(MultiViewRendering, bool);
+
+  /// Measure the GPU time of the render passes (tiles, volumes, translucent
+  /// geometry, composition) with timer queries. The times are added to the
+  /// render statistics a few frames after each quilt is rendered.
+  /// Default is false.
+  /// \sa vtkMRMLLookingGlassRenderStatistics::GetMeanGPUPassTime
+  vtkGetMacro(GPUTiming, bool);
+  vtkSetMacro(GPUTiming, bool);
+  vtkBooleanMacro(GPUTiming, bool);
+
+  /// Display the GPU pass times in the reference view.
+  /// Only used if GPUTiming is enabled.
+  /// Default is false.
+  vtkGetMacro(GPUTimingOverlay, bool);
+  vtkSetMacro(GPUTimingOverlay, bool);
+  vtkBooleanMacro(GPUTimingOverlay, bool);
+
+  /// Volume rendering oversampling factor used for full quality renders.
+  /// The sample distance is the minimum volume spacing divided by this factor.
+  /// The looking glass view applies it to its volume mappers while rendering,
+  /// unless VolumeRenderingQuality is Adaptive, so that the looking glass
+  /// view quality is independent of the other 3D views.
+  /// \sa vtkSlicerLookingGlassLogic::GetVolumeRenderingOversamplingFactor
+  vtkGetMacro(VolumeRenderingStillOversamplingFactor, double);
+  vtkSetMacro(VolumeRenderingStillOversamplingFactor, double);
+
+  /// Volume rendering oversampling factor used for reduced quality renders,
+  /// i.e. during interaction or before progressive refinement.
+  vtkGetMacro(VolumeRenderingInteractiveOversamplingFactor, double);
+  vtkSetMacro(VolumeRenderingInteractiveOversamplingFactor, double);
+
+  /// Scale down the interactive oversampling factor by the quality level
+  /// computed from the measured frame times of the view.
+  vtkGetMacro(VolumeRenderingAutoDownsampling, bool);
+  vtkSetMacro(VolumeRenderingAutoDownsampling, bool);
+  vtkBooleanMacro(VolumeRenderingAutoDownsampling, bool);
+
   /// Turn on/off use of near and far clipping limits.
   vtkGetMacro(UseClippingLimits, bool);
   vtkSetMacro(UseClippingLimits, bool);
@@ -119,6 +259,130 @@ public:
   vtkGetMacro(FarClippingLimit, double);
   vtkSetMacro(FarClippingLimit, double);
 
+  /// Render into an offscreen framebuffer instead of the looking glass device.
+  /// The quilt is rendered using the layout of the virtual device profile,
+  /// which allows rendering, testing and benchmarking without a device.
+  /// If VTK is built with OSMesa or EGL then no display or GPU is needed.
+  vtkGetMacro(VirtualDevice, bool);
+  vtkSetMacro(VirtualDevice, bool);
+  vtkBooleanMacro(VirtualDevice, bool);
+
+  /// Virtual device profile options
+  /// Portrait: 8x6 tiles of 420x560 pixels
+  /// Standard: 5x9 tiles of 819x455 pixels (8.9" display)
+  /// Large: 5x9 tiles of 819x455 pixels (15.6" display)
+  /// Custom: quilt layout is set by the user
+  enum
+  {
+    VirtualDeviceProfilePortrait = 0,
+    VirtualDeviceProfileStandard,
+    VirtualDeviceProfileLarge,
+    VirtualDeviceProfileCustom,
+    VirtualDeviceProfile_Last
+  };
+
+  /// Get/Set virtual device profile.
+  /// Setting a profile other than Custom sets the quilt layout
+  /// (QuiltColumns, QuiltRows, TileSize, DisplayAspect and ViewCone).
+  void SetVirtualDeviceProfile(int profile);
+  vtkGetMacro(VirtualDeviceProfile, int);
+  std::string GetVirtualDeviceProfileAsString();
+
+  /// Convert between virtual device profile ID and name
+  static const char* GetVirtualDeviceProfileAsString(int id);
+  static int GetVirtualDeviceProfileFromString(const char* name);
+
+  /// Number of tile columns and rows in the quilt of the virtual device.
+  vtkGetMacro(QuiltColumns, int);
+  vtkSetClampMacro(QuiltColumns, int, 1, 64);
+  vtkGetMacro(QuiltRows, int);
+  vtkSetClampMacro(QuiltRows, int, 1, 64);
+
+  /// Size of a tile of the virtual device quilt in pixels.
+  /// Width and height are clamped to the [1, 8192] range.
+  vtkGetVector2Macro(TileSize, int);
+  void SetTileSize(int width, int height);
+  void SetTileSize(const int size[2]);
+
+  /// Width/height ratio of the virtual device display.
+  vtkGetMacro(DisplayAspect, double);
+  vtkSetClampMacro(DisplayAspect, double, 0.01, 100.0);
+
+  /// Horizontal angle (in degrees) covered by the views of the virtual device.
+  /// The views are sheared perspectives, the angle must be less than 180 degrees.
+  vtkGetMacro(ViewCone, double);
+  vtkSetClampMacro(ViewCone, double, 0.0, 170.0);
+
+  /// Maximum time (in seconds) spent rendering the quilt of the virtual
+  /// device before letting the application process pending events. The
+  /// remaining tiles are rendered in the next slices, using the camera of
+  /// the first slice. 0 renders the quilt at once.
+  /// The device renders its quilt at once, this setting has no effect on it.
+  /// Default is 0.016 seconds (one frame of a 60 Hz display).
+  vtkGetMacro(QuiltRenderTimeSlice, double);
+  vtkSetClampMacro(QuiltRenderTimeSlice, double, 0.0, VTK_DOUBLE_MAX);
+
+  /// Class names of the displayable managers of the looking glass view.
+  /// A displayable manager is only instantiated once a node it displays
+  /// is in the scene, therefore unused displayable managers do not slow
+  /// down the view creation and updates.
+  /// Default is GetDefaultDisplayableManagers().
+  void SetDisplayableManagers(const std::vector<std::string>& displayableManagers);
+  const std::vector<std::string>& GetDisplayableManagers();
+  void AddDisplayableManager(const std::string& displayableManager);
+  void RemoveDisplayableManager(const std::string& displayableManager);
+  bool HasDisplayableManager(const std::string& displayableManager);
+  static std::vector<std::string> GetDefaultDisplayableManagers();
+
+  /// Get/Set displayable managers as a space separated list of class names.
+  std::string GetDisplayableManagersAsString();
+  void SetDisplayableManagersAsString(const std::string& displayableManagers);
+
+  /// Time (in seconds) the render resources of the view are kept after
+  /// the view is hidden (disconnected). Showing the view again within this
+  /// time reuses the render window, displayable managers and GPU resources
+  /// instead of recreating them. 0 releases the resources immediately.
+  /// Default is 300 seconds.
+  vtkGetMacro(SuspendedResourcesTimeout, double);
+  vtkSetMacro(SuspendedResourcesTimeout, double);
+
+  /// Maximum estimated size (in MB) of the data rendered in the view for
+  /// keeping its render resources after the view is hidden. Resources of
+  /// larger scenes are released immediately. Default is 2048 MB.
+  vtkGetMacro(SuspendedResourcesMemoryLimit, int);
+  vtkSetMacro(SuspendedResourcesMemoryLimit, int);
+
+  /// Publish every rendered quilt to the shared memory segment
+  /// QuiltPublishingKey, so that other processes can read the frames live.
+  /// \sa qMRMLLookingGlassQuiltPublisher
+  vtkGetMacro(QuiltPublishing, bool);
+  vtkSetMacro(QuiltPublishing, bool);
+  vtkBooleanMacro(QuiltPublishing, bool);
+
+  /// Key of the shared memory segment the quilts are published to, mapped to
+  /// a native key by qMRMLLookingGlassQuiltPublisher::nativeKey().
+  /// Default is "SlicerLookingGlassQuilt".
+  vtkGetMacro(QuiltPublishingKey, std::string);
+  vtkSetMacro(QuiltPublishingKey, std::string);
+
+  /// Index of the looking glass device displaying the view, in the order
+  /// the devices are enumerated by the looking glass driver. Each device
+  /// is displayed by its own view node. Default is 0.
+  vtkGetMacro(DeviceIndex, int);
+  vtkSetMacro(DeviceIndex, int);
+
+  /// Create the render window in the OpenGL context share group of the
+  /// reference view, so that the models and volumes displayed in both views
+  /// are uploaded to the GPU once. Takes effect when the render window is
+  /// created, the shared memory is reported by the render statistics.
+  /// The context of the reference view can only be shared if the application
+  /// shares its OpenGL contexts (Qt::AA_ShareOpenGLContexts), a private
+  /// context is used if the contexts cannot be shared.
+  /// Default is off.
+  vtkGetMacro(ShareReferenceViewContext, bool);
+  vtkSetMacro(ShareReferenceViewContext, bool);
+  vtkBooleanMacro(ShareReferenceViewContext, bool);
+
   /// Return true if an error has occurred.
   /// "Connected" member requests connection but this method can tell if the
   /// hardware connection has been actually successfully established.
@@ -133,15 +397,58 @@ public:
   /// Get error message. Non-empty string means that an error has occurred.
   std::string GetError() const;
 
+  /// Get render timing statistics of the view displaying this node.
+  /// Statistics are updated by the view after each render, they are neither
+  /// saved in the scene nor copied.
+  vtkMRMLLookingGlassRenderStatistics* GetRenderStatistics();
+
 protected:
   int RenderingMode;
   double DesiredUpdateRate;
+  bool ReduceQualityDuringInteraction;
+  int InteractiveTriangleBudget;
+  int TransparencyMode;
+  int MaximumNumberOfPeels;
+  double AdaptiveMinimumGeometryQuality;
+  double AdaptiveMinimumVolumeQuality;
+  double AdaptiveMinimumViewFraction;
+  double AdaptiveMinimumTileScale;
+  bool TemporalAccumulation;
+  int MaximumNumberOfAccumulatedFrames;
+  bool MultiViewRendering;
+  bool GPUTiming;
+  bool GPUTimingOverlay;
+  double VolumeRenderingStillOversamplingFactor;
+  double VolumeRenderingInteractiveOversamplingFactor;
+  bool VolumeRenderingAutoDownsampling;
   bool UseClippingLimits;
   double NearClippingLimit;
   double FarClippingLimit;
 
+  bool VirtualDevice;
+  int VirtualDeviceProfile;
+  int QuiltColumns;
+  int QuiltRows;
+  int TileSize[2];
+  double DisplayAspect;
+  double ViewCone;
+  double QuiltRenderTimeSlice;
+
+  std::vector<std::string> DisplayableManagers;
+
+  double SuspendedResourcesTimeout;
+  int SuspendedResourcesMemoryLimit;
+
+  bool QuiltPublishing;
+  std::string QuiltPublishingKey;
+
+  int DeviceIndex;
+  bool ShareReferenceViewContext;
+
   std::string LastErrorMessage;
 
+  vtkMRMLLookingGlassRenderStatistics* RenderStatistics;
+
   vtkMRMLLookingGlassViewNode();
   ~vtkMRMLLookingGlassViewNode();
   vtkMRMLLookingGlassViewNode(const vtkMRMLLookingGlassViewNode&);
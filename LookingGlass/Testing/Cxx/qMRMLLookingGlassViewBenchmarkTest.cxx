@@ -0,0 +1,301 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Slicer includes
+#include <qSlicerApplication.h>
+#include <vtkSlicerApplicationLogic.h>
+#include <vtkSlicerCamerasModuleLogic.h>
+#include <vtkSlicerMarkupsLogic.h>
+#include <vtkSlicerVolumeRenderingLogic.h>
+
+// LookingGlass includes
+#include "qMRMLLookingGlassView.h"
+#include "vtkMRMLLookingGlassRenderStatistics.h"
+#include "vtkMRMLLookingGlassViewNode.h"
+#include "vtkSlicerLookingGlassLogic.h"
+
+// MRML includes
+#include <vtkMRMLMarkupsFiducialNode.h>
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSegmentationDisplayNode.h>
+#include <vtkMRMLSegmentationNode.h>
+#include <vtkMRMLVolumeRenderingDisplayNode.h>
+
+// VTK includes
+#include <vtkAutoInit.h>
+#include <vtkCamera.h>
+#include <vtkImageEllipsoidSource.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkRenderer.h>
+#include <vtkSphereSource.h>
+
+// Displayable managers of Slicer modules are instantiated by name
+VTK_MODULE_INIT(vtkSlicerMarkupsModuleMRMLDisplayableManager);
+VTK_MODULE_INIT(vtkSlicerSegmentationsModuleMRMLDisplayableManager);
+VTK_MODULE_INIT(vtkSlicerVolumeRenderingModuleMRMLDisplayableManager);
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+void addSurfaceModel(vtkMRMLScene* scene)
+{
+  // 2 * 1000 * (502 - 2) = 1M triangles
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(100.0);
+  sphere->SetThetaResolution(1000);
+  sphere->SetPhiResolution(502);
+  sphere->Update();
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLModelNode", "Sphere1M"));
+  modelNode->SetAndObservePolyData(sphere->GetOutput());
+  modelNode->CreateDefaultDisplayNodes();
+}
+
+//-----------------------------------------------------------------------------
+void addVolume(vtkMRMLScene* scene, vtkSlicerVolumeRenderingLogic* volumeRenderingLogic)
+{
+  vtkNew<vtkImageEllipsoidSource> ellipsoid;
+  ellipsoid->SetWholeExtent(0, 511, 0, 511, 0, 511);
+  ellipsoid->SetCenter(255.5, 255.5, 255.5);
+  ellipsoid->SetRadius(200.0, 150.0, 100.0);
+  ellipsoid->SetOutputScalarTypeToShort();
+  ellipsoid->SetInValue(1000);
+  ellipsoid->SetOutValue(-1000);
+  ellipsoid->Update();
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode", "Volume512"));
+  volumeNode->SetOrigin(-256.0, -256.0, -256.0);
+  volumeNode->SetAndObserveImageData(ellipsoid->GetOutput());
+
+  volumeRenderingLogic->SetDefaultRenderingMethod("vtkMRMLGPURayCastVolumeRenderingDisplayNode");
+  vtkMRMLVolumeRenderingDisplayNode* displayNode =
+    volumeRenderingLogic->CreateDefaultVolumeRenderingNodes(volumeNode);
+  displayNode->SetVisibility(true);
+}
+
+//-----------------------------------------------------------------------------
+void addSegmentation(vtkMRMLScene* scene)
+{
+  vtkMRMLSegmentationNode* segmentationNode = vtkMRMLSegmentationNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLSegmentationNode", "Segmentation50"));
+  segmentationNode->CreateDefaultDisplayNodes();
+  const int numberOfSegments = 50;
+  for (int i = 0; i < numberOfSegments; ++i)
+    {
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetCenter((i % 5) * 40.0 - 80.0, ((i / 5) % 5) * 40.0 - 80.0, (i / 25) * 40.0 - 20.0);
+    sphere->SetRadius(15.0);
+    sphere->SetThetaResolution(64);
+    sphere->SetPhiResolution(64);
+    sphere->Update();
+    double color[3] = { (i % 5) / 4.0, ((i / 5) % 5) / 4.0, (i / 25) * 1.0 };
+    segmentationNode->AddSegmentFromClosedSurfaceRepresentation(
+      sphere->GetOutput(), "Segment_" + std::to_string(i), color);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addTransparentSegmentation(vtkMRMLScene* scene)
+{
+  addSegmentation(scene);
+  vtkMRMLSegmentationNode* segmentationNode = vtkMRMLSegmentationNode::SafeDownCast(
+    scene->GetFirstNodeByClass("vtkMRMLSegmentationNode"));
+  vtkMRMLSegmentationDisplayNode::SafeDownCast(segmentationNode->GetDisplayNode())->SetOpacity3D(0.5);
+}
+
+//-----------------------------------------------------------------------------
+void addMarkups(vtkMRMLScene* scene)
+{
+  vtkMRMLMarkupsFiducialNode* markupsNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLMarkupsFiducialNode", "Markups10k"));
+  markupsNode->CreateDefaultDisplayNodes();
+  vtkNew<vtkPoints> points;
+  const int numberOfPoints = 10000;
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    // Points on a spiral
+    double angle = i * 0.05;
+    points->InsertNextPoint(100.0 * cos(angle), 100.0 * sin(angle), i * 0.02 - 100.0);
+    }
+  markupsNode->SetControlPointPositionsWorld(points);
+}
+
+//-----------------------------------------------------------------------------
+double percentile(std::vector<double> values, double p)
+{
+  // Nearest-rank method
+  std::sort(values.begin(), values.end());
+  size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+  return values[rank > 0 ? rank - 1 : 0];
+}
+
+//-----------------------------------------------------------------------------
+void reportMeasurement(const std::string& name, double value)
+{
+  std::cout << "<DartMeasurement name=\"" << name << "\" type=\"numeric/double\">"
+            << value << "</DartMeasurement>" << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+bool benchmarkScene(const std::string& name, qMRMLLookingGlassView& view, int numberOfFrames)
+{
+  vtkMRMLLookingGlassRenderStatistics* statistics =
+    view.mrmlLookingGlassViewNode()->GetRenderStatistics();
+  vtkCamera* camera = view.renderer()->GetActiveCamera();
+
+  // First render uploads data to the GPU, it is not part of the measurements
+  view.renderer()->ResetCamera();
+  view.forceRender();
+  statistics->Reset();
+
+  std::vector<double> frameTimes;
+  for (int frame = 0; frame < numberOfFrames; ++frame)
+    {
+    // Camera motion ensures the frame is not skipped
+    camera->Azimuth(360.0 / numberOfFrames);
+    view.forceRender();
+    if (statistics->GetNumberOfRenderedFrames() != static_cast<unsigned long>(frame + 1))
+      {
+      std::cerr << name << ": frame " << frame << " has not been rendered" << std::endl;
+      return false;
+      }
+    frameTimes.push_back(statistics->GetLastFrameTime());
+    }
+
+  // Frame times are reported in milliseconds
+  reportMeasurement(name + " min frame time", *std::min_element(frameTimes.begin(), frameTimes.end()) * 1000.0);
+  reportMeasurement(name + " median frame time", percentile(frameTimes, 50.0) * 1000.0);
+  reportMeasurement(name + " p95 frame time", percentile(frameTimes, 95.0) * 1000.0);
+
+  // GPU times of the quilts whose timer queries completed, if supported
+  if (statistics->GetNumberOfGPUFrames() > 0)
+    {
+    for (int pass = 0; pass < vtkMRMLLookingGlassRenderStatistics::GPUPass_Last; ++pass)
+      {
+      reportMeasurement(name + " mean " + vtkMRMLLookingGlassRenderStatistics::GetGPUPassAsString(pass)
+        + " GPU time", statistics->GetMeanGPUPassTime(pass) * 1000.0);
+      }
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qMRMLLookingGlassViewBenchmarkTest(int argc, char* argv[])
+{
+  qSlicerApplication app(argc, argv);
+
+  int numberOfFrames = 30;
+  if (argc > 1)
+    {
+    numberOfFrames = std::max(1, atoi(argv[1]));
+    }
+
+  vtkMRMLScene* scene = app.mrmlScene();
+  vtkSlicerApplicationLogic* appLogic = app.applicationLogic();
+
+  vtkNew<vtkSlicerCamerasModuleLogic> camerasLogic;
+  camerasLogic->SetMRMLScene(scene);
+
+  vtkNew<vtkSlicerVolumeRenderingLogic> volumeRenderingLogic;
+  volumeRenderingLogic->SetMRMLApplicationLogic(appLogic);
+  volumeRenderingLogic->SetMRMLScene(scene);
+  appLogic->SetModuleLogic("VolumeRendering", volumeRenderingLogic);
+
+  vtkNew<vtkSlicerMarkupsLogic> markupsLogic;
+  markupsLogic->SetMRMLApplicationLogic(appLogic);
+  markupsLogic->SetMRMLScene(scene);
+  appLogic->SetModuleLogic("Markups", markupsLogic);
+
+  vtkNew<vtkSlicerLookingGlassLogic> lookingGlassLogic;
+  lookingGlassLogic->SetMRMLApplicationLogic(appLogic);
+  lookingGlassLogic->SetMRMLScene(scene);
+
+  vtkMRMLLookingGlassViewNode* viewNode = lookingGlassLogic->AddLookingGlassViewNode();
+  viewNode->SetVirtualDevice(true);
+  viewNode->SetRenderingMode(vtkMRMLLookingGlassViewNode::RenderingModeAlways);
+  // Measure full quality frames
+  viewNode->SetReduceQualityDuringInteraction(false);
+  // Break frame times down into render passes
+  viewNode->SetGPUTiming(true);
+  // Each forceRender() renders a complete quilt
+  viewNode->SetQuiltRenderTimeSlice(0.0);
+
+  qMRMLLookingGlassView view;
+  view.setProgressiveRefinement(false);
+  view.setCamerasLogic(camerasLogic);
+  view.setMRMLLookingGlassViewNode(viewNode);
+  lookingGlassLogic->SetLookingGlassActive(true);
+
+  if (!view.isVirtualDevice())
+    {
+    std::cerr << "Failed to create virtual device render window" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef void (*AddSceneContentFunction)(vtkMRMLScene*);
+  struct Scenario
+  {
+    const char* Name;
+    AddSceneContentFunction AddContent;
+  };
+  const Scenario scenarios[] =
+    {
+    { "SurfaceModel1M", addSurfaceModel },
+    { "Segmentation50", addSegmentation },
+    { "Markups10k", addMarkups },
+    };
+
+  bool success = true;
+  for (const Scenario& scenario : scenarios)
+    {
+    scenario.AddContent(scene);
+    success = benchmarkScene(scenario.Name, view, numberOfFrames) && success;
+    scene->Clear(/* removeSingletons= */ false);
+    }
+
+  // Translucent segments rendered with each transparency mode
+  for (int mode = 0; mode < vtkMRMLLookingGlassViewNode::TransparencyMode_Last; ++mode)
+    {
+    viewNode->SetTransparencyMode(mode);
+    addTransparentSegmentation(scene);
+    success = benchmarkScene(std::string("TransparentSegmentation50")
+      + vtkMRMLLookingGlassViewNode::GetTransparencyModeAsString(mode), view, numberOfFrames) && success;
+    scene->Clear(/* removeSingletons= */ false);
+    }
+  viewNode->SetTransparencyMode(vtkMRMLLookingGlassViewNode::TransparencyModeDefault);
+
+  addVolume(scene, volumeRenderingLogic);
+  success = benchmarkScene("VolumeRendering512", view, numberOfFrames) && success;
+  scene->Clear(/* removeSingletons= */ false);
+
+  lookingGlassLogic->SetLookingGlassActive(false);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,157 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+// Slicer includes
+#include <qSlicerApplication.h>
+#include <vtkSlicerApplicationLogic.h>
+#include <vtkSlicerCamerasModuleLogic.h>
+
+// LookingGlass includes
+#include "qMRMLLookingGlassView.h"
+#include "vtkMRMLLookingGlassRenderStatistics.h"
+#include "vtkMRMLLookingGlassViewNode.h"
+#include "vtkSlicerLookingGlassLogic.h"
+
+// MRML includes
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderer.h>
+#include <vtkSphereSource.h>
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+bool testRenderSkippedWhenUnchanged(qMRMLLookingGlassView& view)
+{
+  vtkMRMLLookingGlassRenderStatistics* statistics =
+    view.mrmlLookingGlassViewNode()->GetRenderStatistics();
+  view.forceRender();
+  unsigned long numberOfRenderedFrames = statistics->GetNumberOfRenderedFrames();
+  unsigned long numberOfSkippedFrames = statistics->GetNumberOfSkippedFrames();
+
+  // Nothing changed since the last render
+  view.forceRender();
+  if (statistics->GetNumberOfRenderedFrames() != numberOfRenderedFrames)
+    {
+    std::cerr << "RenderSkippedWhenUnchanged: the unchanged quilt has been rendered again" << std::endl;
+    return false;
+    }
+  if (statistics->GetNumberOfSkippedFrames() != numberOfSkippedFrames + 1)
+    {
+    std::cerr << "RenderSkippedWhenUnchanged: the skipped frame has not been counted" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool testModelAddedWhileIdle(qMRMLLookingGlassView& view, vtkMRMLScene* scene)
+{
+  vtkMRMLLookingGlassRenderStatistics* statistics =
+    view.mrmlLookingGlassViewNode()->GetRenderStatistics();
+  view.forceRender();
+  // Nothing changed since the last render, the display is idle
+  view.forceRender();
+  unsigned long numberOfRenderedFrames = statistics->GetNumberOfRenderedFrames();
+  int numberOfProps = view.renderer()->GetViewProps()->GetNumberOfItems();
+
+  // The model displayable manager creates the actor of the model in the
+  // renderer StartEvent of the render it requests.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->Update();
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLModelNode", "IdleSphere"));
+  modelNode->SetAndObservePolyData(sphere->GetOutput());
+  modelNode->CreateDefaultDisplayNodes();
+
+  // Requested renders are scheduled by timers
+  QElapsedTimer elapsedTimer;
+  elapsedTimer.start();
+  while (statistics->GetNumberOfRenderedFrames() == numberOfRenderedFrames && elapsedTimer.elapsed() < 5000)
+    {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+    }
+  if (statistics->GetNumberOfRenderedFrames() == numberOfRenderedFrames)
+    {
+    std::cerr << "ModelAddedWhileIdle: no frame has been rendered" << std::endl;
+    return false;
+    }
+  if (view.renderer()->GetViewProps()->GetNumberOfItems() <= numberOfProps)
+    {
+    std::cerr << "ModelAddedWhileIdle: the model is not displayed" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qMRMLLookingGlassViewTest(int argc, char* argv[])
+{
+  qSlicerApplication app(argc, argv);
+
+  vtkMRMLScene* scene = app.mrmlScene();
+  vtkSlicerApplicationLogic* appLogic = app.applicationLogic();
+
+  vtkNew<vtkSlicerCamerasModuleLogic> camerasLogic;
+  camerasLogic->SetMRMLScene(scene);
+
+  vtkNew<vtkSlicerLookingGlassLogic> lookingGlassLogic;
+  lookingGlassLogic->SetMRMLApplicationLogic(appLogic);
+  lookingGlassLogic->SetMRMLScene(scene);
+
+  vtkMRMLLookingGlassViewNode* viewNode = lookingGlassLogic->AddLookingGlassViewNode();
+  viewNode->SetVirtualDevice(true);
+  viewNode->SetRenderingMode(vtkMRMLLookingGlassViewNode::RenderingModeAlways);
+  // Each forceRender() renders a complete quilt
+  viewNode->SetQuiltRenderTimeSlice(0.0);
+
+  qMRMLLookingGlassView view;
+  view.setProgressiveRefinement(false);
+  view.setCamerasLogic(camerasLogic);
+  view.setMRMLLookingGlassViewNode(viewNode);
+  lookingGlassLogic->SetLookingGlassActive(true);
+
+  if (!view.isVirtualDevice())
+    {
+    std::cerr << "Failed to create virtual device render window" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  bool success = true;
+  success = testRenderSkippedWhenUnchanged(view) && success;
+  // Render requested by a displayable manager while nothing else changed
+  success = testModelAddedWhileIdle(view, scene) && success;
+  scene->Clear(/* removeSingletons= */ false);
+
+  lookingGlassLogic->SetLookingGlassActive(false);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,282 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// LookingGlass includes
+#include "vtkSlicerLookingGlassFrameTimeController.h"
+
+// VTK includes
+#include <vtkNew.h>
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+typedef vtkSlicerLookingGlassFrameTimeController Controller;
+
+const double TargetFrameTime = 0.1;
+const double SlowFrameTime = 0.4;
+const double FastFrameTime = 0.01;
+const double MinimumKnobValue = 0.25;
+/// More frames than needed to move all the knobs between their bounds
+const int MaximumNumberOfFrames = 200;
+
+//-----------------------------------------------------------------------------
+/// Add \a frameTime until no knob is adjusted anymore and return the
+/// sequence of adjusted knobs. Return false if a knob leaves its bounds.
+bool addFrameTimes(Controller* controller, double frameTime, std::vector<int>& adjustedKnobs)
+{
+  adjustedKnobs.clear();
+  int framesWithoutAdjustment = 0;
+  for (int frame = 0; frame < MaximumNumberOfFrames && framesWithoutAdjustment < 3; ++frame)
+    {
+    if (!controller->AddFrameTime(frameTime))
+      {
+      ++framesWithoutAdjustment;
+      continue;
+      }
+    framesWithoutAdjustment = 0;
+    adjustedKnobs.push_back(controller->GetLastAdjustedKnob());
+    for (int knob = 0; knob < Controller::Knob_Last; ++knob)
+      {
+      double value = controller->GetKnobValue(knob);
+      if (value < controller->GetMinimumKnobValue(knob) || value > 1.0)
+        {
+        std::cerr << Controller::GetKnobAsString(knob) << " is " << value << ", out of ["
+                  << controller->GetMinimumKnobValue(knob) << ", 1]" << std::endl;
+        return false;
+        }
+      }
+    }
+  if (framesWithoutAdjustment < 3)
+    {
+    std::cerr << "Knobs are still adjusted after " << MaximumNumberOfFrames << " frames" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+/// Return true if \a adjustedKnobs only contains the knobs of \a expectedKnobs,
+/// in the same order, each one adjusted at least once.
+bool checkKnobOrder(const std::vector<int>& adjustedKnobs, const std::vector<int>& expectedKnobs)
+{
+  size_t expected = 0;
+  for (size_t i = 0; i < adjustedKnobs.size(); ++i)
+    {
+    if (i > 0 && adjustedKnobs[i] != expectedKnobs[expected] && expected + 1 < expectedKnobs.size())
+      {
+      // Next knob, once the previous one reached its bound
+      ++expected;
+      }
+    if (adjustedKnobs[i] != expectedKnobs[expected])
+      {
+      std::cerr << "Unexpected adjustment of " << Controller::GetKnobAsString(adjustedKnobs[i])
+                << " (adjustment " << i << ")" << std::endl;
+      return false;
+      }
+    }
+  if (adjustedKnobs.empty() || expected + 1 != expectedKnobs.size())
+    {
+    std::cerr << "Not all the knobs have been adjusted" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool checkKnobValues(Controller* controller, const char* step, bool minimum)
+{
+  bool success = true;
+  for (int knob = 0; knob < Controller::Knob_Last; ++knob)
+    {
+    double expectedValue = minimum ? controller->GetMinimumKnobValue(knob) : 1.0;
+    if (controller->GetKnobValue(knob) != expectedValue)
+      {
+      std::cerr << step << ": " << Controller::GetKnobAsString(knob) << " is "
+                << controller->GetKnobValue(knob) << ", expected " << expectedValue << std::endl;
+      success = false;
+      }
+    }
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool testKnobOrder()
+{
+  vtkNew<Controller> controller;
+  controller->SetTargetFrameTime(TargetFrameTime);
+  for (int knob = 0; knob < Controller::Knob_Last; ++knob)
+    {
+    controller->SetMinimumKnobValue(knob, MinimumKnobValue);
+    }
+
+  // Slow frames reduce the knobs in the order of the Knob enum, each
+  // one down to its minimum before the next one
+  std::vector<int> reductionOrder;
+  for (int knob = 0; knob < Controller::Knob_Last; ++knob)
+    {
+    reductionOrder.push_back(knob);
+    }
+  std::vector<int> adjustedKnobs;
+  if (!addFrameTimes(controller, SlowFrameTime, adjustedKnobs)
+    || !checkKnobOrder(adjustedKnobs, reductionOrder)
+    || !checkKnobValues(controller, "KnobOrder reduction", /* minimum= */ true))
+    {
+    std::cerr << "KnobOrder: failed to reduce the knobs" << std::endl;
+    return false;
+    }
+
+  // Fast frames restore the last reduced knob first
+  std::vector<int> restorationOrder(reductionOrder.rbegin(), reductionOrder.rend());
+  if (!addFrameTimes(controller, FastFrameTime, adjustedKnobs)
+    || !checkKnobOrder(adjustedKnobs, restorationOrder)
+    || !checkKnobValues(controller, "KnobOrder restoration", /* minimum= */ false))
+    {
+    std::cerr << "KnobOrder: failed to restore the knobs" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool testMinimumKnobValues()
+{
+  vtkNew<Controller> controller;
+  controller->SetTargetFrameTime(TargetFrameTime);
+  // Volume is disabled, the other knobs have different minimums
+  controller->SetMinimumKnobValue(Controller::KnobGeometry, 0.1);
+  controller->SetMinimumKnobValue(Controller::KnobVolume, 1.0);
+  controller->SetMinimumKnobValue(Controller::KnobViewCount, 0.5);
+  controller->SetMinimumKnobValue(Controller::KnobTileResolution, 0.6);
+
+  std::vector<int> expectedKnobs;
+  expectedKnobs.push_back(Controller::KnobGeometry);
+  expectedKnobs.push_back(Controller::KnobViewCount);
+  expectedKnobs.push_back(Controller::KnobTileResolution);
+  std::vector<int> adjustedKnobs;
+  if (!addFrameTimes(controller, SlowFrameTime, adjustedKnobs)
+    || !checkKnobOrder(adjustedKnobs, expectedKnobs)
+    || !checkKnobValues(controller, "MinimumKnobValues", /* minimum= */ true))
+    {
+    std::cerr << "MinimumKnobValues: knobs are not reduced down to their minimum" << std::endl;
+    return false;
+    }
+
+  // Raising a minimum raises the knob
+  controller->SetMinimumKnobValue(Controller::KnobGeometry, 0.3);
+  if (controller->GetKnobValue(Controller::KnobGeometry) != 0.3)
+    {
+    std::cerr << "MinimumKnobValues: Geometry is " << controller->GetKnobValue(Controller::KnobGeometry)
+              << " after raising its minimum to 0.3" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool testSettlingAndTolerance()
+{
+  vtkNew<Controller> controller;
+  controller->SetTargetFrameTime(TargetFrameTime);
+  for (int knob = 0; knob < Controller::Knob_Last; ++knob)
+    {
+    controller->SetMinimumKnobValue(knob, MinimumKnobValue);
+    }
+
+  // Invalid frame times are ignored
+  if (controller->AddFrameTime(0.0) || controller->AddFrameTime(-1.0))
+    {
+    std::cerr << "SettlingAndTolerance: invalid frame time adjusted a knob" << std::endl;
+    return false;
+    }
+
+  // Frame times within the tolerance band around the target are held
+  const double heldFrameTimes[] = { 0.09, 0.1, 0.11, 0.1, 0.09, 0.11 };
+  for (int frame = 0; frame < 10 * 6; ++frame)
+    {
+    if (controller->AddFrameTime(heldFrameTimes[frame % 6]))
+      {
+      std::cerr << "SettlingAndTolerance: adjusted " << controller->GetLastAdjustmentAsString()
+                << " for frame times within tolerance" << std::endl;
+      return false;
+      }
+    }
+  if (controller->GetNumberOfAdjustments() != 0)
+    {
+    std::cerr << "SettlingAndTolerance: knobs adjusted within tolerance" << std::endl;
+    return false;
+    }
+
+  // Frames slower than the tolerance band are adjusted
+  controller->Reset();
+  if (!controller->AddFrameTime(SlowFrameTime))
+    {
+    std::cerr << "SettlingAndTolerance: slow frame did not reduce the quality" << std::endl;
+    return false;
+    }
+  // The frame rendered right after an adjustment is not measured
+  if (controller->AddFrameTime(SlowFrameTime))
+    {
+    std::cerr << "SettlingAndTolerance: settling frame adjusted "
+              << controller->GetLastAdjustmentAsString() << std::endl;
+    return false;
+    }
+  if (!controller->AddFrameTime(SlowFrameTime) || controller->GetNumberOfAdjustments() != 2)
+    {
+    std::cerr << "SettlingAndTolerance: slow frame after the settling frame did not reduce the quality" << std::endl;
+    return false;
+    }
+
+  // Frames faster than the tolerance band are adjusted as well
+  controller->Reset();
+  controller->AddFrameTime(SlowFrameTime);
+  controller->AddFrameTime(FastFrameTime);
+  double reducedValue = controller->GetKnobValue(Controller::KnobGeometry);
+  if (!controller->AddFrameTime(FastFrameTime)
+    || controller->GetKnobValue(Controller::KnobGeometry) <= reducedValue)
+    {
+    std::cerr << "SettlingAndTolerance: fast frame did not restore the quality" << std::endl;
+    return false;
+    }
+
+  // Reset restores full quality
+  controller->AddFrameTime(SlowFrameTime);
+  controller->Reset();
+  if (!checkKnobValues(controller, "SettlingAndTolerance reset", /* minimum= */ false)
+    || controller->GetNumberOfAdjustments() != 0 || controller->GetLastAdjustedKnob() != -1)
+    {
+    std::cerr << "SettlingAndTolerance: Reset did not restore full quality" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkSlicerLookingGlassFrameTimeControllerTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  bool success = true;
+  success = testKnobOrder() && success;
+  success = testMinimumKnobValues() && success;
+  success = testSettlingAndTolerance() && success;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,247 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// LookingGlass includes
+#include "vtkSlicerLookingGlassQuiltRenderer.h"
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkShaderProperty.h>
+#include <vtkSphereSource.h>
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+const int QuiltColumns = 4;
+const int QuiltRows = 2;
+const int TileWidth = 80;
+const int TileHeight = 100;
+
+/// A pixel differs if one of its channels differs by more than this value
+const int PixelDifferenceThreshold = 32;
+/// Ratio of the pixels of a synthesized tile that may differ from the
+/// rendered tile, mostly along the silhouette of the sphere
+const double MaximumDifferentPixelRatio = 0.05;
+/// Ratio of the pixels of a multi-view tile that may differ from the
+/// rendered tile, shading is computed for the center view
+const double MaximumMultiViewDifferentPixelRatio = 0.01;
+
+//-----------------------------------------------------------------------------
+bool renderQuilt(vtkSlicerLookingGlassQuiltRenderer* quiltRenderer,
+  int keyViewInterval, double maximumDisocclusionRatio, std::vector<unsigned char>& quilt)
+{
+  quiltRenderer->SetKeyViewInterval(keyViewInterval);
+  quiltRenderer->SetMaximumDisocclusionRatio(maximumDisocclusionRatio);
+  if (!quiltRenderer->Render() || !quiltRenderer->IsQuiltComplete())
+    {
+    std::cerr << "Failed to render quilt with key view interval " << keyViewInterval << std::endl;
+    return false;
+    }
+  vtkImageData* quiltImage = quiltRenderer->GetQuiltImage();
+  unsigned char* pixels = static_cast<unsigned char*>(quiltImage->GetScalarPointer());
+  quilt.assign(pixels, pixels + static_cast<size_t>(quiltImage->GetNumberOfPoints()) * 3);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+/// Return the ratio of the pixels of the tile \a tile that differ
+/// between the quilts \a quilt and \a referenceQuilt.
+double differentPixelRatio(const std::vector<unsigned char>& quilt,
+  const std::vector<unsigned char>& referenceQuilt, int tile)
+{
+  int column = tile % QuiltColumns;
+  int row = tile / QuiltColumns;
+  int numberOfDifferentPixels = 0;
+  for (int y = 0; y < TileHeight; ++y)
+    {
+    for (int x = 0; x < TileWidth; ++x)
+      {
+      size_t index = ((static_cast<size_t>(row) * TileHeight + y) * QuiltColumns * TileWidth
+        + static_cast<size_t>(column) * TileWidth + x) * 3;
+      for (int component = 0; component < 3; ++component)
+        {
+        if (std::abs(quilt[index + component] - referenceQuilt[index + component]) > PixelDifferenceThreshold)
+          {
+          ++numberOfDifferentPixels;
+          break;
+          }
+        }
+      }
+    }
+  return static_cast<double>(numberOfDifferentPixels) / (TileWidth * TileHeight);
+}
+
+//-----------------------------------------------------------------------------
+bool testSynthesizedViews(vtkSlicerLookingGlassQuiltRenderer* quiltRenderer,
+  const std::vector<unsigned char>& renderedQuilt)
+{
+  // Every view is accepted, the synthesized views are compared to the rendered ones
+  std::vector<unsigned char> quilt;
+  if (!renderQuilt(quiltRenderer, 2, 1.0, quilt))
+    {
+    return false;
+    }
+  // Views 1, 3 and 5 are synthesized, 0, 2, 4, 6 and the last one are rendered
+  int expectedNumberOfSynthesizedTiles = (QuiltColumns * QuiltRows - 1) / 2;
+  if (quiltRenderer->GetNumberOfSynthesizedTiles() != expectedNumberOfSynthesizedTiles)
+    {
+    std::cerr << "SynthesizedViews: " << quiltRenderer->GetNumberOfSynthesizedTiles()
+              << " synthesized views, expected " << expectedNumberOfSynthesizedTiles << std::endl;
+    return false;
+    }
+  bool success = true;
+  for (int tile = 0; tile < QuiltColumns * QuiltRows; ++tile)
+    {
+    double ratio = differentPixelRatio(quilt, renderedQuilt, tile);
+    if (ratio > MaximumDifferentPixelRatio)
+      {
+      std::cerr << "SynthesizedViews: " << ratio * 100.0 << "% of the pixels of view " << tile
+                << " differ from the rendered view" << std::endl;
+      success = false;
+      }
+    }
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool testNoDisocclusionAllowed(vtkSlicerLookingGlassQuiltRenderer* quiltRenderer,
+  const std::vector<unsigned char>& renderedQuilt)
+{
+  std::vector<unsigned char> quilt;
+  if (!renderQuilt(quiltRenderer, 2, 0.0, quilt))
+    {
+    return false;
+    }
+  if (quiltRenderer->GetNumberOfSynthesizedTiles() != 0)
+    {
+    std::cerr << "NoDisocclusionAllowed: " << quiltRenderer->GetNumberOfSynthesizedTiles()
+              << " views are synthesized, all the views must be rendered" << std::endl;
+    return false;
+    }
+  bool success = true;
+  for (int tile = 0; tile < QuiltColumns * QuiltRows; ++tile)
+    {
+    if (differentPixelRatio(quilt, renderedQuilt, tile) > 0.0)
+      {
+      std::cerr << "NoDisocclusionAllowed: view " << tile << " differs from the rendered view" << std::endl;
+      success = false;
+      }
+    }
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool testMultiViewRendering(vtkSlicerLookingGlassQuiltRenderer* quiltRenderer, vtkActor* actor,
+  const std::vector<unsigned char>& renderedQuilt)
+{
+  quiltRenderer->MultiViewRenderingOn();
+  std::vector<unsigned char> quilt;
+  bool success = renderQuilt(quiltRenderer, 1, quiltRenderer->GetMaximumDisocclusionRatio(), quilt);
+  if (success && quiltRenderer->GetNumberOfMultiViewPasses() == 0)
+    {
+    // The first tile is rendered before the support is known
+    success = renderQuilt(quiltRenderer, 1, quiltRenderer->GetMaximumDisocclusionRatio(), quilt);
+    }
+  if (success && quiltRenderer->GetNumberOfMultiViewPasses() == 0)
+    {
+    std::cout << "MultiViewRendering: not supported by the OpenGL context, views are rendered one by one" << std::endl;
+    }
+  else if (success && quiltRenderer->GetNumberOfMultiViewPasses() >= QuiltColumns * QuiltRows)
+    {
+    std::cerr << "MultiViewRendering: " << quiltRenderer->GetNumberOfMultiViewPasses()
+              << " multi-view passes for " << QuiltColumns * QuiltRows << " views" << std::endl;
+    success = false;
+    }
+  for (int tile = 0; success && tile < QuiltColumns * QuiltRows; ++tile)
+    {
+    double ratio = differentPixelRatio(quilt, renderedQuilt, tile);
+    if (ratio > MaximumMultiViewDifferentPixelRatio)
+      {
+      std::cerr << "MultiViewRendering: " << ratio * 100.0 << "% of the pixels of view " << tile
+                << " differ from the rendered view" << std::endl;
+      success = false;
+      }
+    }
+
+  // The geometry shader is removed when multi-view rendering is disabled
+  quiltRenderer->MultiViewRenderingOff();
+  if (actor->GetShaderProperty()->HasGeometryShaderCode())
+    {
+    std::cerr << "MultiViewRendering: geometry shader is not removed" << std::endl;
+    success = false;
+    }
+  return success;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkSlicerLookingGlassQuiltRendererTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+  renderer->SetBackground(0.2, 0.3, 0.4);
+  renderer->ResetCamera();
+
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetOffScreenRendering(1);
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkSlicerLookingGlassQuiltRenderer> quiltRenderer;
+  quiltRenderer->SetRenderWindow(renderWindow);
+  quiltRenderer->SetRenderer(renderer);
+  quiltRenderer->SetQuiltColumns(QuiltColumns);
+  quiltRenderer->SetQuiltRows(QuiltRows);
+  quiltRenderer->SetTileSize(TileWidth, TileHeight);
+  quiltRenderer->SetDisplayAspect(static_cast<double>(TileWidth) / TileHeight);
+
+  // Reference quilt, all the views are rendered
+  std::vector<unsigned char> renderedQuilt;
+  if (!renderQuilt(quiltRenderer, 1, quiltRenderer->GetMaximumDisocclusionRatio(), renderedQuilt))
+    {
+    return EXIT_FAILURE;
+    }
+  if (quiltRenderer->GetNumberOfSynthesizedTiles() != 0)
+    {
+    std::cerr << "Views are synthesized with a key view interval of 1" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  bool success = true;
+  success = testSynthesizedViews(quiltRenderer, renderedQuilt) && success;
+  success = testNoDisocclusionAllowed(quiltRenderer, renderedQuilt) && success;
+  success = testMultiViewRendering(quiltRenderer, actor, renderedQuilt) && success;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,350 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "qMRMLLookingGlassQuiltPublisher.h"
+
+// Qt includes
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QSharedMemory>
+
+// CTK includes
+#include <ctkPimpl.h>
+
+// VTK includes
+#include <vtkCamera.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkOpenGLFramebufferObject.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkOpenGLState.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtk_glew.h>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace
+{
+/// Alignment of the slots in the segment
+const quint64 SlotAlignment = 64;
+}
+
+//-----------------------------------------------------------------------------
+class qMRMLLookingGlassQuiltPublisherPrivate
+{
+  Q_DECLARE_PUBLIC(qMRMLLookingGlassQuiltPublisher);
+protected:
+  qMRMLLookingGlassQuiltPublisher* const q_ptr;
+public:
+  qMRMLLookingGlassQuiltPublisherPrivate(qMRMLLookingGlassQuiltPublisher& object);
+
+  /// Create the segment if it is too small for a quilt of \a width x \a height.
+  bool allocate(int width, int height);
+  /// Mark the segment as abandoned and detach from it.
+  void release();
+
+  /// Start writing the next slot, return the pixels of the slot.
+  unsigned char* beginFrame(int width, int height, vtkCamera* camera);
+  /// Make the frame visible to the consumers.
+  void endFrame();
+
+  qMRMLLookingGlassSharedQuiltHeader* header();
+  qMRMLLookingGlassSharedQuiltFrame* slot(int slot);
+
+  QSharedMemory Segment;
+  QString Key;
+  bool Publishing;
+  int NumberOfSlots;
+  int QuiltColumns;
+  int QuiltRows;
+  double ViewCone;
+  double DisplayAspect;
+  quint64 FrameIndex;
+  int CurrentSlot;
+};
+
+//-----------------------------------------------------------------------------
+// qMRMLLookingGlassQuiltPublisherPrivate methods
+
+//-----------------------------------------------------------------------------
+qMRMLLookingGlassQuiltPublisherPrivate::qMRMLLookingGlassQuiltPublisherPrivate(qMRMLLookingGlassQuiltPublisher& object)
+  : q_ptr(&object)
+  , Publishing(false)
+  , NumberOfSlots(3)
+  , QuiltColumns(0)
+  , QuiltRows(0)
+  , ViewCone(0.0)
+  , DisplayAspect(0.0)
+  , FrameIndex(0)
+  , CurrentSlot(-1)
+{
+}
+
+//-----------------------------------------------------------------------------
+qMRMLLookingGlassSharedQuiltHeader* qMRMLLookingGlassQuiltPublisherPrivate::header()
+{
+  return static_cast<qMRMLLookingGlassSharedQuiltHeader*>(this->Segment.data());
+}
+
+//-----------------------------------------------------------------------------
+qMRMLLookingGlassSharedQuiltFrame* qMRMLLookingGlassQuiltPublisherPrivate::slot(int slot)
+{
+  char* slots = static_cast<char*>(this->Segment.data()) + sizeof(qMRMLLookingGlassSharedQuiltHeader);
+  return reinterpret_cast<qMRMLLookingGlassSharedQuiltFrame*>(slots + slot * this->header()->SlotSize);
+}
+
+//-----------------------------------------------------------------------------
+bool qMRMLLookingGlassQuiltPublisherPrivate::allocate(int width, int height)
+{
+  quint64 pixelsSize = static_cast<quint64>(width) * height * 3;
+  quint64 slotSize = sizeof(qMRMLLookingGlassSharedQuiltFrame) + pixelsSize;
+  slotSize = (slotSize + SlotAlignment - 1) / SlotAlignment * SlotAlignment;
+  if (this->Segment.isAttached() && this->header()->SlotSize >= slotSize)
+    {
+    return true;
+    }
+  this->release();
+
+  int segmentSize = static_cast<int>(sizeof(qMRMLLookingGlassSharedQuiltHeader) + this->NumberOfSlots * slotSize);
+  this->Segment.setNativeKey(q_func()->nativeKey());
+  if (!this->Segment.create(segmentSize))
+    {
+    // Segment left by a publisher that did not exit properly
+    if (this->Segment.error() != QSharedMemory::AlreadyExists
+      || !this->Segment.attach() || this->Segment.size() < segmentSize)
+      {
+      qWarning() << Q_FUNC_INFO << ": Failed to create shared memory" << this->Segment.nativeKey() << ":" << this->Segment.errorString();
+      this->Segment.detach();
+      return false;
+      }
+    }
+  memset(this->Segment.data(), 0, segmentSize);
+  qMRMLLookingGlassSharedQuiltHeader* header = this->header();
+  header->Version = qMRMLLookingGlassQuiltPublisher::Version;
+  header->NumberOfSlots = static_cast<quint32>(this->NumberOfSlots);
+  header->SlotSize = slotSize;
+  header->LatestSlot = -1;
+  std::atomic_thread_fence(std::memory_order_release);
+  header->Magic = qMRMLLookingGlassQuiltPublisher::Magic;
+  this->CurrentSlot = -1;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltPublisherPrivate::release()
+{
+  if (!this->Segment.isAttached())
+    {
+    return;
+    }
+  // Consumers still attached to the segment must attach again
+  this->header()->Magic = 0;
+  this->Segment.detach();
+}
+
+//-----------------------------------------------------------------------------
+unsigned char* qMRMLLookingGlassQuiltPublisherPrivate::beginFrame(int width, int height, vtkCamera* camera)
+{
+  if (!this->allocate(width, height))
+    {
+    return nullptr;
+    }
+  this->CurrentSlot = (this->CurrentSlot + 1) % this->NumberOfSlots;
+  qMRMLLookingGlassSharedQuiltFrame* frame = this->slot(this->CurrentSlot);
+  ++frame->Sequence;
+  std::atomic_thread_fence(std::memory_order_release);
+
+  frame->FrameIndex = ++this->FrameIndex;
+  frame->Timestamp = QDateTime::currentMSecsSinceEpoch() * 1e-3;
+  frame->Width = width;
+  frame->Height = height;
+  frame->Columns = this->QuiltColumns;
+  frame->Rows = this->QuiltRows;
+  frame->TileWidth = this->QuiltColumns > 0 ? width / this->QuiltColumns : 0;
+  frame->TileHeight = this->QuiltRows > 0 ? height / this->QuiltRows : 0;
+  frame->ViewCone = this->ViewCone;
+  frame->DisplayAspect = this->DisplayAspect;
+  double aspect = this->DisplayAspect > 0.0 ? this->DisplayAspect : static_cast<double>(width) / height;
+  vtkMatrix4x4* viewMatrix = camera ? camera->GetModelViewTransformMatrix() : nullptr;
+  vtkMatrix4x4* projectionMatrix = camera ? camera->GetProjectionTransformMatrix(aspect, -1.0, 1.0) : nullptr;
+  for (int i = 0; i < 16; ++i)
+    {
+    frame->ViewMatrix[i] = viewMatrix ? viewMatrix->GetData()[i] : (i % 5 == 0 ? 1.0 : 0.0);
+    frame->ProjectionMatrix[i] = projectionMatrix ? projectionMatrix->GetData()[i] : (i % 5 == 0 ? 1.0 : 0.0);
+    }
+  return reinterpret_cast<unsigned char*>(frame + 1);
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltPublisherPrivate::endFrame()
+{
+  qMRMLLookingGlassSharedQuiltFrame* frame = this->slot(this->CurrentSlot);
+  std::atomic_thread_fence(std::memory_order_release);
+  ++frame->Sequence;
+  qMRMLLookingGlassSharedQuiltHeader* header = this->header();
+  header->LatestSlot = this->CurrentSlot;
+  std::atomic_thread_fence(std::memory_order_release);
+  header->LatestFrameIndex = frame->FrameIndex;
+}
+
+//-----------------------------------------------------------------------------
+// qMRMLLookingGlassQuiltPublisher methods
+
+//-----------------------------------------------------------------------------
+qMRMLLookingGlassQuiltPublisher::qMRMLLookingGlassQuiltPublisher(QObject* parent)
+  : Superclass(parent)
+  , d_ptr(new qMRMLLookingGlassQuiltPublisherPrivate(*this))
+{
+}
+
+//-----------------------------------------------------------------------------
+qMRMLLookingGlassQuiltPublisher::~qMRMLLookingGlassQuiltPublisher()
+{
+  this->stop();
+}
+
+//-----------------------------------------------------------------------------
+CTK_GET_CPP(qMRMLLookingGlassQuiltPublisher, int, numberOfSlots, NumberOfSlots);
+CTK_GET_CPP(qMRMLLookingGlassQuiltPublisher, QString, key, Key);
+CTK_GET_CPP(qMRMLLookingGlassQuiltPublisher, bool, isPublishing, Publishing);
+
+//-----------------------------------------------------------------------------
+QString qMRMLLookingGlassQuiltPublisher::nativeKey()const
+{
+  Q_D(const qMRMLLookingGlassQuiltPublisher);
+  if (d->Key.isEmpty())
+    {
+    return QString();
+    }
+#ifdef Q_OS_WIN
+  return d->Key;
+#else
+  // System V keys are ftok()'d from a file: use an absolute path so that
+  // the segment does not depend on the current directory of the processes.
+  if (QDir::isAbsolutePath(d->Key))
+    {
+    return d->Key;
+    }
+  return QDir(QDir::tempPath()).absoluteFilePath(d->Key);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltPublisher::setNumberOfSlots(int slots)
+{
+  Q_D(qMRMLLookingGlassQuiltPublisher);
+  d->NumberOfSlots = std::max(2, slots);
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltPublisher::setQuiltLayout(int columns, int rows, double viewCone, double displayAspect)
+{
+  Q_D(qMRMLLookingGlassQuiltPublisher);
+  d->QuiltColumns = columns;
+  d->QuiltRows = rows;
+  d->ViewCone = viewCone;
+  d->DisplayAspect = displayAspect;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltPublisher::start(const QString& key)
+{
+  Q_D(qMRMLLookingGlassQuiltPublisher);
+  if (d->Publishing && key == d->Key)
+    {
+    return;
+    }
+  this->stop();
+  d->Key = key;
+  d->FrameIndex = 0;
+  d->Publishing = true;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltPublisher::stop()
+{
+  Q_D(qMRMLLookingGlassQuiltPublisher);
+  d->release();
+  d->Publishing = false;
+}
+
+//-----------------------------------------------------------------------------
+bool qMRMLLookingGlassQuiltPublisher::publishImage(vtkImageData* quilt, vtkCamera* camera)
+{
+  Q_D(qMRMLLookingGlassQuiltPublisher);
+  vtkUnsignedCharArray* pixels = quilt ? vtkUnsignedCharArray::SafeDownCast(quilt->GetPointData()->GetScalars()) : nullptr;
+  if (!d->Publishing || !pixels || pixels->GetNumberOfComponents() != 3)
+    {
+    return false;
+    }
+  int* dimensions = quilt->GetDimensions();
+  unsigned char* framePixels = d->beginFrame(dimensions[0], dimensions[1], camera);
+  if (!framePixels)
+    {
+    return false;
+    }
+  memcpy(framePixels, pixels->GetPointer(0), static_cast<size_t>(dimensions[0]) * dimensions[1] * 3);
+  d->endFrame();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool qMRMLLookingGlassQuiltPublisher::publishFramebuffer(vtkOpenGLRenderWindow* renderWindow,
+  vtkOpenGLFramebufferObject* framebuffer, vtkCamera* camera)
+{
+  Q_D(qMRMLLookingGlassQuiltPublisher);
+  if (!d->Publishing || !renderWindow || !framebuffer)
+    {
+    return false;
+    }
+  int size[2] = { 0, 0 };
+  framebuffer->GetLastSize(size);
+  if (size[0] <= 0 || size[1] <= 0)
+    {
+    return false;
+    }
+  unsigned char* framePixels = d->beginFrame(size[0], size[1], camera);
+  if (!framePixels)
+    {
+    return false;
+    }
+
+  // Pixels are read directly into the shared memory
+  renderWindow->MakeCurrent();
+  vtkOpenGLState* state = renderWindow->GetState();
+  state->PushReadFramebufferBinding();
+  framebuffer->Bind(GL_READ_FRAMEBUFFER);
+  framebuffer->ActivateReadBuffer(0);
+  state->vtkglPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, size[0], size[1], GL_RGB, GL_UNSIGNED_BYTE, framePixels);
+  state->PopReadFramebufferBinding();
+
+  d->endFrame();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+int qMRMLLookingGlassQuiltPublisher::publishedFrameCount()const
+{
+  Q_D(const qMRMLLookingGlassQuiltPublisher);
+  return static_cast<int>(d->FrameIndex);
+}
@@ -0,0 +1,149 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qMRMLLookingGlassQuiltPublisher_h
+#define __qMRMLLookingGlassQuiltPublisher_h
+
+// Qt includes
+#include <QObject>
+#include <QString>
+#include <QtGlobal>
+
+#include "qSlicerLookingGlassModuleWidgetsExport.h"
+
+class qMRMLLookingGlassQuiltPublisherPrivate;
+class vtkCamera;
+class vtkImageData;
+class vtkOpenGLFramebufferObject;
+class vtkOpenGLRenderWindow;
+
+/// Header at the beginning of the shared memory segment.
+///
+/// The segment of a publishing key is opened with
+/// QSharedMemory::setNativeKey(qMRMLLookingGlassQuiltPublisher::nativeKey()):
+/// - on Windows, the native key is the key itself, the name of the file mapping;
+/// - on other platforms, the native key is the absolute path
+///   QDir::tempPath()/<key> (or the key if it is already absolute) and the
+///   System V segment is ftok(<native key>, 'Q'). The file is created if needed.
+///
+/// The segment contains NumberOfSlots slots of SlotSize bytes after the
+/// header, each slot is a qMRMLLookingGlassSharedQuiltFrame followed by
+/// the quilt pixels.
+struct qMRMLLookingGlassSharedQuiltHeader
+{
+  /// qMRMLLookingGlassQuiltPublisher::Magic, set to 0 when the segment is
+  /// abandoned (e.g. reallocated for a larger quilt) and must be attached again.
+  quint32 Magic;
+  quint32 Version;
+  quint32 NumberOfSlots;
+  quint32 Reserved;
+  quint64 SlotSize;
+  /// Index of the last published frame, starting at 1. 0 if none.
+  quint64 LatestFrameIndex;
+  /// Slot of the last published frame, -1 if none.
+  qint64 LatestSlot;
+};
+
+/// Header of a published quilt.
+struct qMRMLLookingGlassSharedQuiltFrame
+{
+  /// Odd while the slot is written. Consumers copy or use the slot, then
+  /// check that Sequence is even and unchanged.
+  quint64 Sequence;
+  quint64 FrameIndex;
+  /// Seconds since the epoch when the quilt was published
+  double Timestamp;
+  /// Quilt size in pixels, RGB 8 bits per component, rows from bottom to top
+  qint32 Width;
+  qint32 Height;
+  /// Quilt layout, 0 if unknown. Leftmost view in the bottom-left tile.
+  qint32 Columns;
+  qint32 Rows;
+  qint32 TileWidth;
+  qint32 TileHeight;
+  double ViewCone;
+  double DisplayAspect;
+  /// Center view camera matrices, row-major
+  double ViewMatrix[16];
+  double ProjectionMatrix[16];
+};
+
+/// \brief Publish the rendered quilts to a shared memory ring buffer.
+///
+/// Other processes (recording services, viewers, compositors) attach to the
+/// shared memory segment with the native key of the publisher (see
+/// qMRMLLookingGlassSharedQuiltHeader and nativeKey()) and read the latest frame in place, without
+/// sockets or copies. Frames are written to the slots in turn, so the latest
+/// NumberOfSlots - 1 frames are stable while the next one is written.
+///
+/// Quilts of the device are read from the quilt framebuffer directly into
+/// the shared memory, quilts of the virtual device are copied from the
+/// quilt image.
+class Q_SLICER_MODULE_LOOKINGGLASS_WIDGETS_EXPORT qMRMLLookingGlassQuiltPublisher : public QObject
+{
+  Q_OBJECT
+  Q_PROPERTY(int numberOfSlots READ numberOfSlots WRITE setNumberOfSlots)
+
+public:
+  typedef QObject Superclass;
+  explicit qMRMLLookingGlassQuiltPublisher(QObject* parent = nullptr);
+  virtual ~qMRMLLookingGlassQuiltPublisher();
+
+  /// Value of qMRMLLookingGlassSharedQuiltHeader::Magic ("LGQT")
+  static const quint32 Magic = 0x5451474c;
+  static const quint32 Version = 1;
+
+  /// Number of frames in the ring buffer, 3 by default.
+  /// Only taken into account when the segment is created.
+  void setNumberOfSlots(int slots);
+  int numberOfSlots()const;
+
+  /// Quilt layout published with the frames. Columns and rows are 0 if unknown.
+  void setQuiltLayout(int columns, int rows, double viewCone, double displayAspect);
+
+  /// Publish to the shared memory segment \a key. The segment is created
+  /// when the first frame is published, with the size of the quilt.
+  Q_INVOKABLE void start(const QString& key);
+  Q_INVOKABLE void stop();
+  Q_INVOKABLE bool isPublishing()const;
+  Q_INVOKABLE QString key()const;
+  /// Native key of the shared memory segment of key(), independent of the
+  /// current directory. Empty if there is no key.
+  /// \sa qMRMLLookingGlassSharedQuiltHeader
+  Q_INVOKABLE QString nativeKey()const;
+
+  /// Publish a copy of the \a quilt image (RGB unsigned char) rendered with
+  /// the center \a camera. Return false if the frame could not be published.
+  bool publishImage(vtkImageData* quilt, vtkCamera* camera);
+
+  /// Read the color attachment of the \a framebuffer of \a renderWindow into
+  /// the shared memory. Return false if the frame could not be published.
+  bool publishFramebuffer(vtkOpenGLRenderWindow* renderWindow, vtkOpenGLFramebufferObject* framebuffer,
+    vtkCamera* camera);
+
+  /// Number of frames published since the publishing started.
+  Q_INVOKABLE int publishedFrameCount()const;
+
+protected:
+  QScopedPointer<qMRMLLookingGlassQuiltPublisherPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qMRMLLookingGlassQuiltPublisher);
+  Q_DISABLE_COPY(qMRMLLookingGlassQuiltPublisher);
+};
+
+#endif
@@ -0,0 +1,818 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "qMRMLLookingGlassQuiltRecorder.h"
+
+// Qt includes
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QProcess>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+#include <QWaitCondition>
+
+// CTK includes
+#include <ctkPimpl.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkOpenGLFramebufferObject.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkOpenGLState.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkWeakPointer.h>
+#include <vtk_glew.h>
+
+// STD includes
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+/// Number of quilts that can be transferred from the GPU at the same time
+const int NumberOfReadbackBuffers = 3;
+/// Interval (in milliseconds) of the retrieval of transferred quilts
+/// when no other quilt is captured
+const int ReadbackPollInterval = 10;
+}
+
+//-----------------------------------------------------------------------------
+class qMRMLLookingGlassQuiltRecorderPrivate
+{
+  Q_DECLARE_PUBLIC(qMRMLLookingGlassQuiltRecorder);
+protected:
+  qMRMLLookingGlassQuiltRecorder* const q_ptr;
+public:
+  qMRMLLookingGlassQuiltRecorderPrivate(qMRMLLookingGlassQuiltRecorder& object);
+
+  struct Frame
+  {
+    QByteArray Pixels;
+    int Width;
+    int Height;
+    int Index;
+  };
+
+  /// Pixel buffer object a quilt is transferred into
+  struct Readback
+  {
+    unsigned int Buffer;
+    GLsync Fence;
+    size_t BufferSize;
+    int Width;
+    int Height;
+    double Time;
+    int Sequence;
+  };
+
+  /// Reserve a pending frame for a captured quilt. Wait for the writers or
+  /// return false if too many frames are pending, depending on the drop policy.
+  bool reserveFrame();
+  /// Release a reserved frame that was not written
+  void releaseFrame();
+
+  /// Send a captured frame (already reserved) to the writers
+  void enqueueFrame(const QByteArray& pixels, int width, int height, double time);
+
+  /// Encode and write a frame, called by the writer threads
+  void writeFrame(const Frame& frame);
+  bool writeVideoFrame(const Frame& frame);
+  /// Close the encoder, called by the writer thread
+  void finishVideo();
+
+  /// Retrieve the transferred quilts, in the order they were captured.
+  /// If \a waitForOldest is true then wait for the transfer of the oldest quilt.
+  /// The readback window must be current.
+  void collectReadbacks(bool waitForOldest);
+  bool hasPendingReadbacks()const;
+  /// Delete the pixel buffer objects, the readback window must be current.
+  void releaseReadbacks();
+
+  QString sidecarPath()const;
+  bool writeSidecar()const;
+
+  qMRMLLookingGlassQuiltRecorder::OutputFormat OutputFormat;
+  qMRMLLookingGlassQuiltRecorder::DropPolicy DropPolicy;
+  int MaximumPendingFrames;
+  int NumberOfWriterThreads;
+  double FrameRate;
+  QString EncoderCommand;
+  int QuiltColumns;
+  int QuiltRows;
+  double ViewCone;
+  double DisplayAspect;
+
+  bool Recording;
+  QString OutputPath;
+  QThreadPool WriterPool;
+  QElapsedTimer RecordingTime;
+  QVector<double> FrameTimes;
+  int QuiltSize[2];
+  int CapturedFrames;
+  int DroppedFrames;
+
+  /// Transfer of the quilt framebuffer
+  std::vector<Readback> Readbacks;
+  int ReadbackSequence;
+  vtkWeakPointer<vtkOpenGLRenderWindow> ReadbackWindow;
+  QTimer ReadbackTimer;
+
+  /// Statistics shared with the writer threads
+  mutable QMutex Mutex;
+  QWaitCondition FrameWritten;
+  int PendingFrames;
+  int MaximumPendingFrameCount;
+  int WrittenFrames;
+  double TotalWriteTime;
+
+  /// Only used by the single video writer thread
+  QProcess* Encoder;
+  bool EncoderFailed;
+  int VideoSize[2];
+};
+
+//-----------------------------------------------------------------------------
+class qMRMLLookingGlassQuiltWriteTask : public QRunnable
+{
+public:
+  qMRMLLookingGlassQuiltWriteTask(qMRMLLookingGlassQuiltRecorderPrivate* recorder,
+    const qMRMLLookingGlassQuiltRecorderPrivate::Frame& frame, bool finish = false)
+    : Recorder(recorder)
+    , Frame(frame)
+    , Finish(finish)
+  {
+  }
+
+  void run() override
+  {
+    if (this->Finish)
+      {
+      this->Recorder->finishVideo();
+      return;
+      }
+    this->Recorder->writeFrame(this->Frame);
+  }
+
+protected:
+  qMRMLLookingGlassQuiltRecorderPrivate* Recorder;
+  qMRMLLookingGlassQuiltRecorderPrivate::Frame Frame;
+  bool Finish;
+};
+
+//-----------------------------------------------------------------------------
+// qMRMLLookingGlassQuiltRecorderPrivate methods
+
+//-----------------------------------------------------------------------------
+qMRMLLookingGlassQuiltRecorderPrivate::qMRMLLookingGlassQuiltRecorderPrivate(qMRMLLookingGlassQuiltRecorder& object)
+  : q_ptr(&object)
+  , OutputFormat(qMRMLLookingGlassQuiltRecorder::ImageSequence)
+  , DropPolicy(qMRMLLookingGlassQuiltRecorder::DropNewFrames)
+  , MaximumPendingFrames(8)
+  , NumberOfWriterThreads(2)
+  , FrameRate(30.0)
+  , EncoderCommand("ffmpeg")
+  , QuiltColumns(0)
+  , QuiltRows(0)
+  , ViewCone(0.0)
+  , DisplayAspect(0.0)
+  , Recording(false)
+  , CapturedFrames(0)
+  , DroppedFrames(0)
+  , ReadbackSequence(0)
+  , PendingFrames(0)
+  , MaximumPendingFrameCount(0)
+  , WrittenFrames(0)
+  , TotalWriteTime(0.0)
+  , Encoder(nullptr)
+  , EncoderFailed(false)
+{
+  this->QuiltSize[0] = 0;
+  this->QuiltSize[1] = 0;
+  this->VideoSize[0] = 0;
+  this->VideoSize[1] = 0;
+  Readback readback = { 0, nullptr, 0, 0, 0, 0.0, 0 };
+  this->Readbacks.resize(NumberOfReadbackBuffers, readback);
+}
+
+//-----------------------------------------------------------------------------
+bool qMRMLLookingGlassQuiltRecorderPrivate::reserveFrame()
+{
+  QMutexLocker locker(&this->Mutex);
+  while (this->PendingFrames >= this->MaximumPendingFrames)
+    {
+    if (this->DropPolicy == qMRMLLookingGlassQuiltRecorder::DropNewFrames)
+      {
+      return false;
+      }
+    this->FrameWritten.wait(&this->Mutex);
+    }
+  ++this->PendingFrames;
+  this->MaximumPendingFrameCount = std::max(this->MaximumPendingFrameCount, this->PendingFrames);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorderPrivate::releaseFrame()
+{
+  QMutexLocker locker(&this->Mutex);
+  --this->PendingFrames;
+  this->FrameWritten.wakeAll();
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorderPrivate::enqueueFrame(const QByteArray& pixels, int width, int height, double time)
+{
+  if (this->FrameTimes.isEmpty())
+    {
+    this->QuiltSize[0] = width;
+    this->QuiltSize[1] = height;
+    }
+  Frame frame;
+  frame.Pixels = pixels;
+  frame.Width = width;
+  frame.Height = height;
+  frame.Index = this->FrameTimes.size();
+  this->FrameTimes.append(time);
+  this->WriterPool.start(new qMRMLLookingGlassQuiltWriteTask(this, frame));
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorderPrivate::writeFrame(const Frame& frame)
+{
+  QElapsedTimer timer;
+  timer.start();
+  bool success = false;
+  if (this->OutputFormat == qMRMLLookingGlassQuiltRecorder::Video)
+    {
+    success = this->writeVideoFrame(frame);
+    }
+  else
+    {
+    // Rows are read from the bottom to the top of the quilt
+    QImage image(reinterpret_cast<const uchar*>(frame.Pixels.constData()),
+      frame.Width, frame.Height, frame.Width * 3, QImage::Format_RGB888);
+    QString fileName = QString("%1/quilt_%2.png").arg(this->OutputPath).arg(frame.Index, 6, 10, QChar('0'));
+    success = image.mirrored().save(fileName, "PNG");
+    if (!success)
+      {
+      qWarning() << Q_FUNC_INFO << ": Failed to write" << fileName;
+      }
+    }
+
+  QMutexLocker locker(&this->Mutex);
+  --this->PendingFrames;
+  if (success)
+    {
+    ++this->WrittenFrames;
+    this->TotalWriteTime += timer.nsecsElapsed() * 1e-9;
+    }
+  this->FrameWritten.wakeAll();
+}
+
+//-----------------------------------------------------------------------------
+bool qMRMLLookingGlassQuiltRecorderPrivate::writeVideoFrame(const Frame& frame)
+{
+  if (this->EncoderFailed)
+    {
+    return false;
+    }
+  if (!this->Encoder)
+    {
+    // Lossless RGB encoding, rows are flipped by the encoder
+    QStringList arguments;
+    arguments << "-y" << "-loglevel" << "error"
+      << "-f" << "rawvideo" << "-pixel_format" << "rgb24"
+      << "-video_size" << QString("%1x%2").arg(frame.Width).arg(frame.Height)
+      << "-framerate" << QString::number(this->FrameRate)
+      << "-i" << "-"
+      << "-vf" << "vflip"
+      << "-c:v" << "libx264rgb" << "-qp" << "0" << "-preset" << "ultrafast"
+      << this->OutputPath;
+    this->Encoder = new QProcess;
+    this->Encoder->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    this->Encoder->start(this->EncoderCommand, arguments);
+    if (!this->Encoder->waitForStarted())
+      {
+      qWarning() << Q_FUNC_INFO << ": Failed to start video encoder" << this->EncoderCommand;
+      delete this->Encoder;
+      this->Encoder = nullptr;
+      this->EncoderFailed = true;
+      return false;
+      }
+    this->VideoSize[0] = frame.Width;
+    this->VideoSize[1] = frame.Height;
+    }
+  if (frame.Width != this->VideoSize[0] || frame.Height != this->VideoSize[1])
+    {
+    // Quilt layout changed while recording
+    return false;
+    }
+  if (this->Encoder->write(frame.Pixels) != frame.Pixels.size())
+    {
+    return false;
+    }
+  return this->Encoder->waitForBytesWritten(-1) || this->Encoder->bytesToWrite() == 0;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorderPrivate::finishVideo()
+{
+  if (this->Encoder)
+    {
+    this->Encoder->closeWriteChannel();
+    if (!this->Encoder->waitForFinished(-1) || this->Encoder->exitCode() != 0)
+      {
+      qWarning() << Q_FUNC_INFO << ": Video encoder failed for" << this->OutputPath;
+      }
+    delete this->Encoder;
+    this->Encoder = nullptr;
+    }
+  this->EncoderFailed = false;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorderPrivate::collectReadbacks(bool waitForOldest)
+{
+  std::vector<Readback*> pendingReadbacks;
+  for (Readback& readback : this->Readbacks)
+    {
+    if (readback.Fence)
+      {
+      pendingReadbacks.push_back(&readback);
+      }
+    }
+  std::sort(pendingReadbacks.begin(), pendingReadbacks.end(),
+    [](const Readback* a, const Readback* b) { return a->Sequence < b->Sequence; });
+
+  bool wait = waitForOldest;
+  for (Readback* readback : pendingReadbacks)
+    {
+    GLenum status = glClientWaitSync(readback->Fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+      wait ? static_cast<GLuint64>(1000000000) : 0);
+    wait = false;
+    if (status == GL_TIMEOUT_EXPIRED)
+      {
+      // Keep the capture order, later quilts are retrieved with this one
+      break;
+      }
+    glDeleteSync(readback->Fence);
+    readback->Fence = nullptr;
+    if (status == GL_WAIT_FAILED)
+      {
+      this->releaseFrame();
+      ++this->DroppedFrames;
+      continue;
+      }
+    size_t size = static_cast<size_t>(readback->Width) * readback->Height * 3;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->Buffer);
+    void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (data)
+      {
+      QByteArray pixels(static_cast<const char*>(data), static_cast<int>(size));
+      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      this->enqueueFrame(pixels, readback->Width, readback->Height, readback->Time);
+      }
+    else
+      {
+      this->releaseFrame();
+      ++this->DroppedFrames;
+      }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool qMRMLLookingGlassQuiltRecorderPrivate::hasPendingReadbacks()const
+{
+  for (const Readback& readback : this->Readbacks)
+    {
+    if (readback.Fence)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorderPrivate::releaseReadbacks()
+{
+  for (Readback& readback : this->Readbacks)
+    {
+    if (readback.Fence)
+      {
+      glDeleteSync(readback.Fence);
+      readback.Fence = nullptr;
+      this->releaseFrame();
+      ++this->DroppedFrames;
+      }
+    if (readback.Buffer)
+      {
+      glDeleteBuffers(1, &readback.Buffer);
+      readback.Buffer = 0;
+      readback.BufferSize = 0;
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+QString qMRMLLookingGlassQuiltRecorderPrivate::sidecarPath()const
+{
+  if (this->OutputFormat == qMRMLLookingGlassQuiltRecorder::Video)
+    {
+    return this->OutputPath + ".json";
+    }
+  return this->OutputPath + "/quilt.json";
+}
+
+//-----------------------------------------------------------------------------
+bool qMRMLLookingGlassQuiltRecorderPrivate::writeSidecar()const
+{
+  Q_Q(const qMRMLLookingGlassQuiltRecorder);
+  QJsonObject quilt;
+  quilt["columns"] = this->QuiltColumns;
+  quilt["rows"] = this->QuiltRows;
+  quilt["width"] = this->QuiltSize[0];
+  quilt["height"] = this->QuiltSize[1];
+  if (this->QuiltColumns > 0 && this->QuiltRows > 0)
+    {
+    quilt["tileWidth"] = this->QuiltSize[0] / this->QuiltColumns;
+    quilt["tileHeight"] = this->QuiltSize[1] / this->QuiltRows;
+    }
+  quilt["viewCone"] = this->ViewCone;
+  quilt["displayAspect"] = this->DisplayAspect;
+  quilt["viewOrder"] = QString("Leftmost view in the bottom-left tile, left to right then bottom to top");
+
+  QJsonArray frameTimes;
+  for (double time : this->FrameTimes)
+    {
+    frameTimes.append(time);
+    }
+
+  QJsonObject recording;
+  recording["format"] = QString(this->OutputFormat == qMRMLLookingGlassQuiltRecorder::Video ? "video" : "png");
+  if (this->OutputFormat == qMRMLLookingGlassQuiltRecorder::Video)
+    {
+    recording["frameRate"] = this->FrameRate;
+    }
+  else
+    {
+    recording["filePattern"] = QString("quilt_%06d.png");
+    }
+  recording["capturedFrames"] = this->CapturedFrames;
+  recording["writtenFrames"] = q->writtenFrameCount();
+  recording["droppedFrames"] = this->DroppedFrames;
+  recording["frameTimes"] = frameTimes;
+
+  QJsonObject root;
+  root["quilt"] = quilt;
+  root["recording"] = recording;
+
+  QFile file(this->sidecarPath());
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+    qWarning() << Q_FUNC_INFO << ": Failed to write" << this->sidecarPath();
+    return false;
+    }
+  file.write(QJsonDocument(root).toJson());
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// qMRMLLookingGlassQuiltRecorder methods
+
+//-----------------------------------------------------------------------------
+qMRMLLookingGlassQuiltRecorder::qMRMLLookingGlassQuiltRecorder(QObject* parent)
+  : Superclass(parent)
+  , d_ptr(new qMRMLLookingGlassQuiltRecorderPrivate(*this))
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  d->ReadbackTimer.setInterval(ReadbackPollInterval);
+  connect(&d->ReadbackTimer, SIGNAL(timeout()), this, SLOT(onReadbackTimeout()));
+}
+
+//-----------------------------------------------------------------------------
+qMRMLLookingGlassQuiltRecorder::~qMRMLLookingGlassQuiltRecorder()
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  this->stop();
+  if (d->ReadbackWindow)
+    {
+    this->releaseGraphicsResources(d->ReadbackWindow);
+    }
+}
+
+//-----------------------------------------------------------------------------
+CTK_SET_CPP(qMRMLLookingGlassQuiltRecorder, qMRMLLookingGlassQuiltRecorder::OutputFormat, setOutputFormat, OutputFormat);
+CTK_GET_CPP(qMRMLLookingGlassQuiltRecorder, qMRMLLookingGlassQuiltRecorder::OutputFormat, outputFormat, OutputFormat);
+CTK_SET_CPP(qMRMLLookingGlassQuiltRecorder, qMRMLLookingGlassQuiltRecorder::DropPolicy, setDropPolicy, DropPolicy);
+CTK_GET_CPP(qMRMLLookingGlassQuiltRecorder, qMRMLLookingGlassQuiltRecorder::DropPolicy, dropPolicy, DropPolicy);
+CTK_GET_CPP(qMRMLLookingGlassQuiltRecorder, int, maximumPendingFrames, MaximumPendingFrames);
+CTK_GET_CPP(qMRMLLookingGlassQuiltRecorder, int, numberOfWriterThreads, NumberOfWriterThreads);
+CTK_SET_CPP(qMRMLLookingGlassQuiltRecorder, double, setFrameRate, FrameRate);
+CTK_GET_CPP(qMRMLLookingGlassQuiltRecorder, double, frameRate, FrameRate);
+CTK_SET_CPP(qMRMLLookingGlassQuiltRecorder, const QString&, setEncoderCommand, EncoderCommand);
+CTK_GET_CPP(qMRMLLookingGlassQuiltRecorder, QString, encoderCommand, EncoderCommand);
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorder::setMaximumPendingFrames(int frames)
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  QMutexLocker locker(&d->Mutex);
+  d->MaximumPendingFrames = std::max(1, frames);
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorder::setNumberOfWriterThreads(int threads)
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  d->NumberOfWriterThreads = std::max(1, threads);
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorder::setQuiltLayout(int columns, int rows, double viewCone, double displayAspect)
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  d->QuiltColumns = columns;
+  d->QuiltRows = rows;
+  d->ViewCone = viewCone;
+  d->DisplayAspect = displayAspect;
+}
+
+//-----------------------------------------------------------------------------
+bool qMRMLLookingGlassQuiltRecorder::start(const QString& outputPath)
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  this->stop();
+
+  QString directory = d->OutputFormat == Video ? QFileInfo(outputPath).absolutePath() : outputPath;
+  if (!QDir().mkpath(directory))
+    {
+    qWarning() << Q_FUNC_INFO << ": Failed to create output directory" << directory;
+    return false;
+    }
+
+  d->OutputPath = outputPath;
+  d->FrameTimes.clear();
+  d->QuiltSize[0] = 0;
+  d->QuiltSize[1] = 0;
+  d->CapturedFrames = 0;
+  d->DroppedFrames = 0;
+  {
+    QMutexLocker locker(&d->Mutex);
+    d->PendingFrames = 0;
+    d->MaximumPendingFrameCount = 0;
+    d->WrittenFrames = 0;
+    d->TotalWriteTime = 0.0;
+  }
+  // The video encoder is used by a single thread that lives until the
+  // recording stops, frames are written in order.
+  d->WriterPool.setMaxThreadCount(d->OutputFormat == Video ? 1 : d->NumberOfWriterThreads);
+  d->WriterPool.setExpiryTimeout(-1);
+
+  if (!d->writeSidecar())
+    {
+    return false;
+    }
+  d->RecordingTime.start();
+  d->Recording = true;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorder::stop()
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  if (!d->Recording)
+    {
+    return;
+    }
+  d->ReadbackTimer.stop();
+  if (d->ReadbackWindow && d->hasPendingReadbacks())
+    {
+    d->ReadbackWindow->MakeCurrent();
+    while (d->hasPendingReadbacks())
+      {
+      d->collectReadbacks(true);
+      }
+    }
+  d->WriterPool.waitForDone();
+  if (d->OutputFormat == Video)
+    {
+    d->WriterPool.start(new qMRMLLookingGlassQuiltWriteTask(d, qMRMLLookingGlassQuiltRecorderPrivate::Frame(), true));
+    d->WriterPool.waitForDone();
+    }
+  d->Recording = false;
+  d->writeSidecar();
+}
+
+//-----------------------------------------------------------------------------
+bool qMRMLLookingGlassQuiltRecorder::isRecording()const
+{
+  Q_D(const qMRMLLookingGlassQuiltRecorder);
+  return d->Recording;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorder::captureImage(vtkImageData* quilt)
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  vtkUnsignedCharArray* pixels = quilt ? vtkUnsignedCharArray::SafeDownCast(quilt->GetPointData()->GetScalars()) : nullptr;
+  if (!d->Recording || !pixels || pixels->GetNumberOfComponents() != 3)
+    {
+    return;
+    }
+  if (!d->reserveFrame())
+    {
+    ++d->DroppedFrames;
+    return;
+    }
+  ++d->CapturedFrames;
+  int* dimensions = quilt->GetDimensions();
+  QByteArray data(reinterpret_cast<const char*>(pixels->GetPointer(0)),
+    static_cast<int>(pixels->GetNumberOfValues()));
+  d->enqueueFrame(data, dimensions[0], dimensions[1], d->RecordingTime.nsecsElapsed() * 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorder::captureFramebuffer(vtkOpenGLRenderWindow* renderWindow,
+  vtkOpenGLFramebufferObject* framebuffer)
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  if (!d->Recording || !renderWindow || !framebuffer)
+    {
+    return;
+    }
+  renderWindow->MakeCurrent();
+  if (d->ReadbackWindow != renderWindow)
+    {
+    if (d->ReadbackWindow)
+      {
+      this->releaseGraphicsResources(d->ReadbackWindow);
+      renderWindow->MakeCurrent();
+      }
+    d->ReadbackWindow = renderWindow;
+    }
+
+  d->collectReadbacks(false);
+  auto isFree = [](const qMRMLLookingGlassQuiltRecorderPrivate::Readback& readback) { return readback.Fence == nullptr; };
+  auto readback = std::find_if(d->Readbacks.begin(), d->Readbacks.end(), isFree);
+  if (d->DropPolicy == WaitForWriters)
+    {
+    // Frames being transferred are pending too, they must reach the writers
+    // before waiting for them.
+    while (d->hasPendingReadbacks()
+      && (readback == d->Readbacks.end() || this->pendingFrameCount() >= this->maximumPendingFrames()))
+      {
+      d->collectReadbacks(true);
+      readback = std::find_if(d->Readbacks.begin(), d->Readbacks.end(), isFree);
+      }
+    }
+  if (readback == d->Readbacks.end() || !d->reserveFrame())
+    {
+    ++d->DroppedFrames;
+    return;
+    }
+  ++d->CapturedFrames;
+
+  int size[2] = { 0, 0 };
+  framebuffer->GetLastSize(size);
+  size_t bufferSize = static_cast<size_t>(size[0]) * size[1] * 3;
+
+  vtkOpenGLState* state = renderWindow->GetState();
+  state->PushReadFramebufferBinding();
+  framebuffer->Bind(GL_READ_FRAMEBUFFER);
+  framebuffer->ActivateReadBuffer(0);
+  state->vtkglPixelStorei(GL_PACK_ALIGNMENT, 1);
+  if (!readback->Buffer)
+    {
+    glGenBuffers(1, &readback->Buffer);
+    }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->Buffer);
+  if (readback->BufferSize != bufferSize)
+    {
+    glBufferData(GL_PIXEL_PACK_BUFFER, bufferSize, nullptr, GL_STREAM_READ);
+    readback->BufferSize = bufferSize;
+    }
+  // The transfer is asynchronous as the destination is a buffer object
+  glReadPixels(0, 0, size[0], size[1], GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  readback->Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glFlush();
+  state->PopReadFramebufferBinding();
+
+  readback->Width = size[0];
+  readback->Height = size[1];
+  readback->Time = d->RecordingTime.nsecsElapsed() * 1e-9;
+  readback->Sequence = d->ReadbackSequence++;
+  if (!d->ReadbackTimer.isActive())
+    {
+    d->ReadbackTimer.start();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorder::releaseGraphicsResources(vtkOpenGLRenderWindow* renderWindow)
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  if (!renderWindow || d->ReadbackWindow != renderWindow)
+    {
+    return;
+    }
+  d->ReadbackTimer.stop();
+  renderWindow->MakeCurrent();
+  while (d->Recording && d->hasPendingReadbacks())
+    {
+    d->collectReadbacks(true);
+    }
+  d->releaseReadbacks();
+  d->ReadbackWindow = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLLookingGlassQuiltRecorder::onReadbackTimeout()
+{
+  Q_D(qMRMLLookingGlassQuiltRecorder);
+  if (!d->ReadbackWindow || !d->hasPendingReadbacks())
+    {
+    d->ReadbackTimer.stop();
+    return;
+    }
+  d->ReadbackWindow->MakeCurrent();
+  d->collectReadbacks(false);
+  if (!d->hasPendingReadbacks())
+    {
+    d->ReadbackTimer.stop();
+    }
+}
+
+//-----------------------------------------------------------------------------
+int qMRMLLookingGlassQuiltRecorder::capturedFrameCount()const
+{
+  Q_D(const qMRMLLookingGlassQuiltRecorder);
+  return d->CapturedFrames;
+}
+
+//-----------------------------------------------------------------------------
+int qMRMLLookingGlassQuiltRecorder::writtenFrameCount()const
+{
+  Q_D(const qMRMLLookingGlassQuiltRecorder);
+  QMutexLocker locker(&d->Mutex);
+  return d->WrittenFrames;
+}
+
+//-----------------------------------------------------------------------------
+int qMRMLLookingGlassQuiltRecorder::droppedFrameCount()const
+{
+  Q_D(const qMRMLLookingGlassQuiltRecorder);
+  return d->DroppedFrames;
+}
+
+//-----------------------------------------------------------------------------
+int qMRMLLookingGlassQuiltRecorder::pendingFrameCount()const
+{
+  Q_D(const qMRMLLookingGlassQuiltRecorder);
+  QMutexLocker locker(&d->Mutex);
+  return d->PendingFrames;
+}
+
+//-----------------------------------------------------------------------------
+int qMRMLLookingGlassQuiltRecorder::maximumPendingFrameCount()const
+{
+  Q_D(const qMRMLLookingGlassQuiltRecorder);
+  QMutexLocker locker(&d->Mutex);
+  return d->MaximumPendingFrameCount;
+}
+
+//-----------------------------------------------------------------------------
+double qMRMLLookingGlassQuiltRecorder::averageWriteTime()const
+{
+  Q_D(const qMRMLLookingGlassQuiltRecorder);
+  QMutexLocker locker(&d->Mutex);
+  return d->WrittenFrames > 0 ? d->TotalWriteTime / d->WrittenFrames : 0.0;
+}
@@ -0,0 +1,156 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qMRMLLookingGlassQuiltRecorder_h
+#define __qMRMLLookingGlassQuiltRecorder_h
+
+// Qt includes
+#include <QObject>
+#include <QString>
+
+#include "qSlicerLookingGlassModuleWidgetsExport.h"
+
+class qMRMLLookingGlassQuiltRecorderPrivate;
+class vtkImageData;
+class vtkOpenGLFramebufferObject;
+class vtkOpenGLRenderWindow;
+
+/// \brief Record the rendered quilts to an image sequence or a video.
+///
+/// Quilts are copied from the quilt image of the virtual device or read
+/// back asynchronously from the quilt framebuffer of the device window
+/// using pixel buffer objects, the pixels of a frame are only mapped
+/// when the GPU has completed the transfer, so capturing does not stall
+/// the render loop.
+///
+/// Frames are encoded and written by a pool of writer threads. PNG files
+/// are written in parallel, video frames are streamed in order to a local
+/// encoder process (ffmpeg by default) that encodes them losslessly.
+/// If the writers cannot keep up, frames are dropped (or rendering waits,
+/// depending on the drop policy) once maximumPendingFrames frames are queued.
+///
+/// A JSON sidecar describing the quilt layout and the recorded frames is
+/// written next to the output.
+class Q_SLICER_MODULE_LOOKINGGLASS_WIDGETS_EXPORT qMRMLLookingGlassQuiltRecorder : public QObject
+{
+  Q_OBJECT
+  Q_ENUMS(OutputFormat)
+  Q_ENUMS(DropPolicy)
+  Q_PROPERTY(OutputFormat outputFormat READ outputFormat WRITE setOutputFormat)
+  Q_PROPERTY(DropPolicy dropPolicy READ dropPolicy WRITE setDropPolicy)
+  Q_PROPERTY(int maximumPendingFrames READ maximumPendingFrames WRITE setMaximumPendingFrames)
+  Q_PROPERTY(int numberOfWriterThreads READ numberOfWriterThreads WRITE setNumberOfWriterThreads)
+  Q_PROPERTY(double frameRate READ frameRate WRITE setFrameRate)
+  Q_PROPERTY(QString encoderCommand READ encoderCommand WRITE setEncoderCommand)
+
+public:
+  typedef QObject Superclass;
+  explicit qMRMLLookingGlassQuiltRecorder(QObject* parent = nullptr);
+  virtual ~qMRMLLookingGlassQuiltRecorder();
+
+  enum OutputFormat
+  {
+    /// One PNG file per quilt in the output directory
+    ImageSequence,
+    /// Lossless video file encoded by the encoder command
+    Video
+  };
+
+  enum DropPolicy
+  {
+    /// Drop the captured frame if too many frames are pending
+    DropNewFrames,
+    /// Wait for the writers before capturing the frame
+    WaitForWriters
+  };
+
+  /// Output format, ImageSequence by default.
+  /// Only taken into account when the recording starts.
+  void setOutputFormat(OutputFormat format);
+  OutputFormat outputFormat()const;
+
+  void setDropPolicy(DropPolicy policy);
+  DropPolicy dropPolicy()const;
+
+  /// Maximum number of frames captured but not written yet, 8 by default.
+  void setMaximumPendingFrames(int frames);
+  int maximumPendingFrames()const;
+
+  /// Number of threads writing image files, 2 by default.
+  /// Video frames are written by a single thread to preserve their order.
+  void setNumberOfWriterThreads(int threads);
+  int numberOfWriterThreads()const;
+
+  /// Frame rate of the video, 30 by default. Quilts are only rendered when
+  /// the scene changes, the capture time of each frame is in the sidecar.
+  void setFrameRate(double fps);
+  double frameRate()const;
+
+  /// Encoder executable, reading raw RGB frames from its standard input
+  /// with ffmpeg command line arguments. "ffmpeg" by default.
+  void setEncoderCommand(const QString& command);
+  QString encoderCommand()const;
+
+  /// Quilt layout written in the sidecar. Columns and rows are 0 if unknown.
+  void setQuiltLayout(int columns, int rows, double viewCone, double displayAspect);
+
+  /// Start recording to \a outputPath, which is a directory for image
+  /// sequences and a file for videos. Return false if the output cannot
+  /// be created.
+  Q_INVOKABLE bool start(const QString& outputPath);
+
+  /// Write the pending frames and the sidecar and stop recording.
+  Q_INVOKABLE void stop();
+
+  Q_INVOKABLE bool isRecording()const;
+
+  /// Capture a copy of the \a quilt image (RGB unsigned char).
+  void captureImage(vtkImageData* quilt);
+
+  /// Capture the color attachment of the \a framebuffer of \a renderWindow
+  /// asynchronously. The pixels are transferred when the GPU is done, they
+  /// are retrieved on the next capture or when the application is idle.
+  void captureFramebuffer(vtkOpenGLRenderWindow* renderWindow, vtkOpenGLFramebufferObject* framebuffer);
+
+  /// Release the pixel buffer objects of \a renderWindow, which must be
+  /// called before the render window is destroyed.
+  void releaseGraphicsResources(vtkOpenGLRenderWindow* renderWindow);
+
+  /// Recording statistics since the recording started.
+  /// Dropped frames are the frames not captured because the writers could
+  /// not keep up or because the readback buffers were all in use.
+  Q_INVOKABLE int capturedFrameCount()const;
+  Q_INVOKABLE int writtenFrameCount()const;
+  Q_INVOKABLE int droppedFrameCount()const;
+  Q_INVOKABLE int pendingFrameCount()const;
+  Q_INVOKABLE int maximumPendingFrameCount()const;
+  /// Average time (in seconds) spent encoding and writing a frame.
+  Q_INVOKABLE double averageWriteTime()const;
+
+protected slots:
+  /// Retrieve the frames whose transfer is completed
+  void onReadbackTimeout();
+
+protected:
+  QScopedPointer<qMRMLLookingGlassQuiltRecorderPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qMRMLLookingGlassQuiltRecorder);
+  Q_DISABLE_COPY(qMRMLLookingGlassQuiltRecorder);
+};
+
+#endif
@@ -19,6 +19,8 @@
 ==============================================================================*/
 
 #include "qMRMLLookingGlassView_p.h"
+#include "qMRMLLookingGlassQuiltPublisher.h"
+#include "qMRMLLookingGlassQuiltRecorder.h"
 
 // Qt includes
 #include <QCoreApplication>
@@ -27,6 +29,7 @@
 #include <QFileInfo>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QOpenGLContext>
 #include <QPushButton>
 #include <QToolButton>
 #include <QTimer>
@@ -49,6 +52,13 @@
 
 // Slicer LookingGlass includes
 #include "vtkMRMLLookingGlassViewNode.h"
+#include "vtkSlicerLookingGlassFrameTimeController.h"
+#include "vtkSlicerLookingGlassLogic.h"
+#include "vtkSlicerLookingGlassLODCache.h"
+#include "vtkSlicerLookingGlassPassTimer.h"
+#include "vtkSlicerLookingGlassQuiltCuller.h"
+#include "vtkSlicerLookingGlassQuiltRenderer.h"
+#include "vtkSlicerLookingGlassShaderCache.h"
 
 // MRMLDisplayableManager includes
 #include <vtkMRMLAbstractDisplayableManager.h>
@@ -65,19 +75,35 @@
 #include <vtkLookingGlassInterface.h>
 
 // VTK includes
+#include <vtkAbstractVolumeMapper.h>
+#include <vtkActor.h>
 #include <vtkCamera.h>
 #include <vtkCollection.h>
+#include <vtkCoordinate.h>
 #include <vtkCullerCollection.h>
+#include <vtkDataSet.h>
+#include <vtkGPUVolumeRayCastMapper.h>
+#include <vtkImageData.h>
+#include <vtkInteractorStyle.h>
+#include <vtkMapper.h>
+#include <vtkMath.h>
 #include <vtkMathUtilities.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkOpenGLFramebufferObject.h>
 #include <vtkOpenGLRenderWindow.h>
 #include <vtkPolyDataMapper.h>
+#include <vtkProp.h>
+#include <vtkPropCollection.h>
 #include <vtkRenderer.h>
 #include <vtkRendererCollection.h>
 #include <vtkRenderingOpenGLConfigure.h> // For VTK_USE_X, VTK_USE_COCOA
 #include <vtkSmartPointer.h>
+#include <vtkTextActor.h>
+#include <vtkTextProperty.h>
 #include <vtkTimerLog.h>
+#include <vtkVolume.h>
+#include <vtk_glew.h>
 #if defined(VTK_USE_X)
 # include <vtkXLookingGlassRenderWindow.h>
 #elif defined(Q_OS_WIN)
@@ -86,42 +112,264 @@
 # include <vtkCocoaLookingGlassRenderWindow.h>
 #endif
 
+// STD includes
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <set>
+
+namespace
+{
+/// Lowest quality level used during interaction, prevents the rendering
+/// from becoming unusable if the desired update rate cannot be reached.
+const double MinimumInteractiveQuality = 0.1;
+
+/// Delay (in milliseconds) of the refinement render while the user holds
+/// a mouse button, e.g. while dragging a slice slider.
+const int RefinementRetryInterval = 100;
+
+/// Upper bound of the view cone (in degrees) of looking glass devices,
+/// the view cone of the device is not available from the device interface.
+const double DeviceViewConeUpperBound = 50.0;
+
+/// Node class displayed by a displayable manager. The displayable manager
+/// is instantiated when a node of this class is first in the scene.
+/// Displayable managers that are not listed are instantiated immediately.
+struct DisplayableManagerNodeClass
+{
+  const char* DisplayableManager;
+  const char* NodeClass;
+};
+const DisplayableManagerNodeClass DisplayableManagerNodeClasses[] =
+{
+  { "vtkMRMLModelDisplayableManager", "vtkMRMLModelNode" },
+  { "vtkMRMLThreeDReformatDisplayableManager", "vtkMRMLSliceNode" },
+  { "vtkMRMLCrosshairDisplayableManager3D", "vtkMRMLCrosshairNode" },
+  { "vtkMRMLAnnotationDisplayableManager", "vtkMRMLAnnotationNode" },
+  { "vtkMRMLMarkupsDisplayableManager", "vtkMRMLMarkupsNode" },
+  { "vtkMRMLSegmentationsDisplayableManager3D", "vtkMRMLSegmentationNode" },
+  { "vtkMRMLTransformsDisplayableManager3D", "vtkMRMLTransformDisplayNode" },
+  { "vtkMRMLLinearTransformsDisplayableManager3D", "vtkMRMLTransformDisplayNode" },
+  { "vtkMRMLVolumeRenderingDisplayableManager", "vtkMRMLVolumeRenderingDisplayNode" },
+};
+
+//---------------------------------------------------------------------------
+const char* displayedNodeClass(const QString& displayableManager)
+{
+  for (const DisplayableManagerNodeClass& entry : DisplayableManagerNodeClasses)
+  {
+    if (displayableManager == entry.DisplayableManager)
+    {
+      return entry.NodeClass;
+    }
+  }
+  return nullptr;
+}
+
+//---------------------------------------------------------------------------
+vtkDataSet* renderedData(vtkProp* prop)
+{
+  vtkActor* actor = vtkActor::SafeDownCast(prop);
+  vtkVolume* volume = vtkVolume::SafeDownCast(prop);
+  if (actor && actor->GetMapper())
+  {
+    return actor->GetMapper()->GetInput();
+  }
+  else if (volume && volume->GetMapper())
+  {
+    return volume->GetMapper()->GetDataSetInput();
+  }
+  return nullptr;
+}
+
+//---------------------------------------------------------------------------
+/// Smallest spacing of \a image rendered by \a volume, in world coordinates.
+/// The volume rendering displayable manager sets the IJK to RAS matrix of
+/// the volume as its user matrix.
+double minimumWorldSpacing(vtkVolume* volume, vtkImageData* image)
+{
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  image->GetSpacing(spacing);
+  vtkMatrix4x4* matrix = volume->GetMatrix();
+  double minimumSpacing = VTK_DOUBLE_MAX;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    double column[3] = { matrix->GetElement(0, axis), matrix->GetElement(1, axis), matrix->GetElement(2, axis) };
+    minimumSpacing = std::min(minimumSpacing, vtkMath::Norm(column) * std::abs(spacing[axis]));
+  }
+  return minimumSpacing;
+}
+
+//---------------------------------------------------------------------------
+/// Element \a index of the Halton low discrepancy sequence of \a base,
+/// in the [0, 1) range. Jitter offsets are well distributed for any
+/// number of accumulated frames.
+double halton(int index, int base)
+{
+  double result = 0.0;
+  double fraction = 1.0;
+  while (index > 0)
+  {
+    fraction /= base;
+    result += fraction * (index % base);
+    index /= base;
+  }
+  return result;
+}
+
+//---------------------------------------------------------------------------
+/// Return true if Qt creates its OpenGL contexts in a share group, which is
+/// required to share the context of a 3D view.
+bool areQtContextsShared()
+{
+  return QCoreApplication::testAttribute(Qt::AA_ShareOpenGLContexts)
+    && QOpenGLContext::globalShareContext() != nullptr;
+}
+
+//---------------------------------------------------------------------------
+/// Return true if the buffers created in the context of \a renderWindow
+/// exist in the context of \a otherRenderWindow. Contexts requested to be
+/// shared may not be, e.g. if they are created by different libraries.
+bool areObjectsShared(vtkOpenGLRenderWindow* renderWindow, vtkOpenGLRenderWindow* otherRenderWindow)
+{
+  renderWindow->MakeCurrent();
+  if (!renderWindow->IsCurrent())
+  {
+    return false;
+  }
+  GLuint buffer = 0;
+  glGenBuffers(1, &buffer);
+  // Buffer names become buffer objects when they are first bound
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  otherRenderWindow->MakeCurrent();
+  bool shared = otherRenderWindow->IsCurrent() && glIsBuffer(buffer) == GL_TRUE;
+  renderWindow->MakeCurrent();
+  glDeleteBuffers(1, &buffer);
+  return shared;
+}
+}
+
 //--------------------------------------------------------------------------
 // qMRMLLookingGlassViewPrivate methods
 
 //---------------------------------------------------------------------------
 qMRMLLookingGlassViewPrivate::qMRMLLookingGlassViewPrivate(qMRMLLookingGlassView& object)
   : q_ptr(&object)
+  , RenderTurn(false)
+  , ReferenceViewContextRequested(false)
   , CamerasLogic(nullptr)
+  , LookingGlassLogic(nullptr)
+  , CameraSyncTranslationThreshold(0.5)
+  , CameraSyncRotationThreshold(0.5)
+  , CameraSyncMinimumInterval(0.05)
   , ReferenceViewInteractive(false)
   , RequestTimer(nullptr)
+  , RenderInProgress(false)
+  , LastRenderedStateMTime(0)
+  , RenderRequested(false)
+  , RendererStartTime(0.0)
+  , TileRenderStartTime(0.0)
+  , FrameTileCount(0)
+  , NumberOfTilesPerFrame(1)
+  , InteractiveQuality(1.0)
+  , FullQualityMaximumNumberOfPeels(4)
+  , ProgressiveRefinement(true)
+  , RefinementQuality(1.0)
+  , LastFullQualityFrameTime(0.0)
+  , VolumeOversamplingFactor(0.0)
+  , AccumulationFramePending(false)
+  , QuiltRenderInProgress(false)
+  , QuiltRenderPending(false)
+  , KeyViewInterval(1)
+  , MaximumDisocclusionRatio(0.02)
+  , FrameRenderTime(0.0)
+  , QuiltRecorder(nullptr)
+  , QuiltPublisher(nullptr)
+  , Suspended(false)
 {
   this->MRMLLookingGlassViewNode = nullptr;
+  for (int phase = 0; phase < vtkMRMLLookingGlassRenderStatistics::Phase_Last; ++phase)
+    {
+    this->FramePhaseTimes[phase] = 0.0;
+    }
 }
 
 //---------------------------------------------------------------------------
 qMRMLLookingGlassViewPrivate::~qMRMLLookingGlassViewPrivate()
 {
+  qMRMLLookingGlassViewPrivate::Views.removeAll(this->q_ptr);
+  qMRMLLookingGlassViewPrivate::RenderQueue.removeAll(this->q_ptr);
 }
 
+//---------------------------------------------------------------------------
+QList<qMRMLLookingGlassView*> qMRMLLookingGlassViewPrivate::Views;
+QList<qMRMLLookingGlassView*> qMRMLLookingGlassViewPrivate::RenderQueue;
+bool qMRMLLookingGlassViewPrivate::RenderTurnScheduled = false;
+
 //---------------------------------------------------------------------------
 void qMRMLLookingGlassViewPrivate::init()
 {
   Q_Q(qMRMLLookingGlassView);
 
-  QObject::connect(&this->LookingGlassLoopTimer, SIGNAL(timeout()),
-    q, SLOT(scheduleRender()));
+  qMRMLLookingGlassViewPrivate::Views.append(q);
 
   this->RequestTimer = new QTimer(q);
   this->RequestTimer->setSingleShot(true);
   QObject::connect(this->RequestTimer, SIGNAL(timeout()),
                    q, SLOT(requestRender()));
+
+  this->CameraSyncTimer.setSingleShot(true);
+  QObject::connect(&this->CameraSyncTimer, SIGNAL(timeout()),
+                   this, SLOT(onReferenceCameraModified()));
+
+  // Refinement is rendered when no other events are pending
+  this->RefinementTimer.setSingleShot(true);
+  this->RefinementTimer.setInterval(0);
+  QObject::connect(&this->RefinementTimer, SIGNAL(timeout()),
+                   this, SLOT(onRefinementTimeout()));
+
+  // Jittered frames are accumulated when no other events are pending
+  this->AccumulationTimer.setSingleShot(true);
+  this->AccumulationTimer.setInterval(0);
+  QObject::connect(&this->AccumulationTimer, SIGNAL(timeout()),
+                   this, SLOT(onAccumulationTimeout()));
+
+  this->QuiltSliceTimer.setSingleShot(true);
+  this->QuiltSliceTimer.setInterval(0);
+  QObject::connect(&this->QuiltSliceTimer, SIGNAL(timeout()),
+                   this, SLOT(onQuiltSliceTimeout()));
+
+  this->QuiltRecorder = new qMRMLLookingGlassQuiltRecorder(q);
+  this->QuiltPublisher = new qMRMLLookingGlassQuiltPublisher(q);
+
+  this->EvictionTimer.setSingleShot(true);
+  QObject::connect(&this->EvictionTimer, SIGNAL(timeout()),
+                   this, SLOT(onEvictionTimeout()));
 }
 
+//----------------------------------------------------------------------------
+CTK_SET_CPP(qMRMLLookingGlassView, double, setCameraSyncTranslationThreshold, CameraSyncTranslationThreshold);
+CTK_GET_CPP(qMRMLLookingGlassView, double, cameraSyncTranslationThreshold, CameraSyncTranslationThreshold);
+CTK_SET_CPP(qMRMLLookingGlassView, double, setCameraSyncRotationThreshold, CameraSyncRotationThreshold);
+CTK_GET_CPP(qMRMLLookingGlassView, double, cameraSyncRotationThreshold, CameraSyncRotationThreshold);
+CTK_SET_CPP(qMRMLLookingGlassView, double, setCameraSyncMinimumInterval, CameraSyncMinimumInterval);
+CTK_GET_CPP(qMRMLLookingGlassView, double, cameraSyncMinimumInterval, CameraSyncMinimumInterval);
+CTK_SET_CPP(qMRMLLookingGlassView, bool, setProgressiveRefinement, ProgressiveRefinement);
+CTK_GET_CPP(qMRMLLookingGlassView, bool, progressiveRefinement, ProgressiveRefinement);
+CTK_SET_CPP(qMRMLLookingGlassView, int, setKeyViewInterval, KeyViewInterval);
+CTK_GET_CPP(qMRMLLookingGlassView, int, keyViewInterval, KeyViewInterval);
+CTK_SET_CPP(qMRMLLookingGlassView, double, setMaximumDisocclusionRatio, MaximumDisocclusionRatio);
+CTK_GET_CPP(qMRMLLookingGlassView, double, maximumDisocclusionRatio, MaximumDisocclusionRatio);
+
 //----------------------------------------------------------------------------
 CTK_SET_CPP(qMRMLLookingGlassView, vtkSlicerCamerasModuleLogic*, setCamerasLogic, CamerasLogic);
 CTK_GET_CPP(qMRMLLookingGlassView, vtkSlicerCamerasModuleLogic*, camerasLogic, CamerasLogic);
 
+//----------------------------------------------------------------------------
+CTK_SET_CPP(qMRMLLookingGlassView, vtkSlicerLookingGlassLogic*, setLookingGlassLogic, LookingGlassLogic);
+CTK_GET_CPP(qMRMLLookingGlassView, vtkSlicerLookingGlassLogic*, lookingGlassLogic, LookingGlassLogic);
+
 //----------------------------------------------------------------------------
 CTK_GET_CPP(qMRMLLookingGlassView, vtkRenderer*, renderer, Renderer);
 
@@ -134,21 +382,58 @@ vtkLookingGlassInterface* qMRMLLookingGlassView::lookingGlassTnterface()const
   Q_D(const qMRMLLookingGlassView);
 #if defined(VTK_USE_X)
   vtkXLookingGlassRenderWindow* renderWindow = vtkXLookingGlassRenderWindow::SafeDownCast(d->RenderWindow);
-  return renderWindow->GetInterface();
+  return renderWindow ? renderWindow->GetInterface() : nullptr;
 #elif defined(Q_OS_WIN)
   vtkWin32LookingGlassRenderWindow* renderWindow = vtkWin32LookingGlassRenderWindow::SafeDownCast(d->RenderWindow);
-  return renderWindow->GetInterface();
+  return renderWindow ? renderWindow->GetInterface() : nullptr;
 #elif defined(VTK_USE_COCOA)
   vtkCocoaLookingGlassRenderWindow* renderWindow = vtkCocoaLookingGlassRenderWindow::SafeDownCast(d->RenderWindow);
-  return renderWindow->GetInterface();
+  return renderWindow ? renderWindow->GetInterface() : nullptr;
 #else
   return nullptr;
 #endif
 }
 
+//----------------------------------------------------------------------------
+vtkImageData* qMRMLLookingGlassView::quiltImage()const
+{
+  Q_D(const qMRMLLookingGlassView);
+  return d->QuiltRenderer ? d->QuiltRenderer->GetQuiltImage() : nullptr;
+}
+
 //----------------------------------------------------------------------------
 CTK_GET_CPP(qMRMLLookingGlassView, vtkRenderWindowInteractor*, interactor, Interactor);
 
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::newRenderWindow()
+{
+  Q_Q(qMRMLLookingGlassView);
+  if (this->MRMLLookingGlassViewNode->GetVirtualDevice())
+    {
+    // The factory returns an OSMesa or EGL render window if VTK is built
+    // with one of them, which allows rendering without display and GPU.
+    vtkSmartPointer<vtkRenderWindow> renderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+    renderWindow->SetOffScreenRendering(1);
+    this->RenderWindow = vtkOpenGLRenderWindow::SafeDownCast(renderWindow);
+    }
+  else
+    {
+    this->RenderWindow = vtkSmartPointer<vtkOpenGLRenderWindow>::Take(
+          vtkLookingGlassInterface::CreateLookingGlassRenderWindow());
+    vtkLookingGlassInterface* lookingGlassInterface = q->lookingGlassTnterface();
+    if (lookingGlassInterface)
+      {
+      lookingGlassInterface->SetDeviceIndex(this->MRMLLookingGlassViewNode->GetDeviceIndex());
+      }
+    }
+  if (this->RenderWindow && this->LookingGlassLogic
+    && !this->LookingGlassLogic->GetShaderCacheDirectory().empty())
+    {
+    // Shader programs are linked from the binaries saved by previous windows
+    vtkSlicerLookingGlassShaderCache::Install(this->RenderWindow, this->LookingGlassLogic->GetShaderCacheDirectory());
+    }
+}
+
 //---------------------------------------------------------------------------
 void qMRMLLookingGlassViewPrivate::createRenderWindow()
 {
@@ -167,10 +452,61 @@ void qMRMLLookingGlassViewPrivate::createRenderWindow()
   this->LastViewPosition[1] = 0.0;
   this->LastViewPosition[2] = 0.0;
 
-  this->RenderWindow = vtkSmartPointer<vtkOpenGLRenderWindow>::Take(
-        vtkLookingGlassInterface::CreateLookingGlassRenderWindow());
+  // Ensure the first render of the new window is not skipped
+  this->LastRenderedStateMTime = 0;
+  this->RenderRequested = false;
+  this->MRMLLookingGlassViewNode->GetRenderStatistics()->Reset();
+
+  this->newRenderWindow();
+
+  // Models, volumes and textures displayed in several views are uploaded
+  // once to the shared context. The context of the reference view is
+  // created by Qt, it can only be shared if Qt shares its contexts.
+  this->ReferenceViewContextRequested = this->MRMLLookingGlassViewNode->GetShareReferenceViewContext();
+  this->SharedReferenceRenderWindow = nullptr;
+  vtkOpenGLRenderWindow* referenceRenderWindow = this->referenceRenderWindow();
+  vtkOpenGLRenderWindow* sharedRenderWindow =
+    this->ReferenceViewContextRequested && areQtContextsShared() ? referenceRenderWindow : nullptr;
+  if (!sharedRenderWindow)
+    {
+    sharedRenderWindow = this->sharedRenderWindow();
+    }
+  if (sharedRenderWindow)
+    {
+    // The render window uses the vertex buffer object cache of the shared
+    // render window, its context is created now to check that the buffers
+    // are actually shared.
+    this->RenderWindow->SetSharedRenderWindow(sharedRenderWindow);
+    this->RenderWindow->Initialize();
+    if (!areObjectsShared(sharedRenderWindow, this->RenderWindow))
+      {
+      qWarning() << Q_FUNC_INFO << ": OpenGL context could not be shared, using a private context";
+      this->RenderWindow->Finalize();
+      this->newRenderWindow();
+      }
+    else if (referenceRenderWindow && areQtContextsShared()
+      && (sharedRenderWindow == referenceRenderWindow
+        || areObjectsShared(referenceRenderWindow, this->RenderWindow)))
+      {
+      this->SharedReferenceRenderWindow = referenceRenderWindow;
+      }
+    }
 
   this->Renderer = vtkSmartPointer<vtkRenderer>::New();
+  // Props are culled once per quilt instead of once per view
+  this->QuiltCuller = vtkSmartPointer<vtkSlicerLookingGlassQuiltCuller>::New();
+  this->Renderer->GetCullers()->RemoveAllItems();
+  this->Renderer->AddCuller(this->QuiltCuller);
+  this->LODCache = vtkSmartPointer<vtkSlicerLookingGlassLODCache>::New();
+  this->FrameTimeController = vtkSmartPointer<vtkSlicerLookingGlassFrameTimeController>::New();
+  this->PassTimer = vtkSmartPointer<vtkSlicerLookingGlassPassTimer>::New();
+  this->PassTimer->SetRenderWindow(this->RenderWindow);
+  this->PassTimer->SetEnabled(this->MRMLLookingGlassViewNode->GetGPUTiming());
+  this->FullQualityMaximumNumberOfPeels = this->MRMLLookingGlassViewNode->GetMaximumNumberOfPeels();
+  this->InteractiveQuality = 1.0;
+  this->NumberOfTilesPerFrame = 1;
+  this->RefinementQuality = 1.0;
+  this->LastFullQualityFrameTime = 0.0;
   this->Interactor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
   this->InteractorStyle = vtkSmartPointer<vtkMRMLThreeDViewInteractorStyle>::New();
 
@@ -184,12 +520,27 @@ void qMRMLLookingGlassViewPrivate::createRenderWindow()
   this->RenderWindow->AddRenderer(this->Renderer);
   this->RenderWindow->SetInteractor(this->Interactor);
 
+  if (this->MRMLLookingGlassViewNode->GetVirtualDevice())
+    {
+    this->QuiltRenderer = vtkSmartPointer<vtkSlicerLookingGlassQuiltRenderer>::New();
+    this->QuiltRenderer->SetRenderWindow(this->RenderWindow);
+    this->QuiltRenderer->SetRenderer(this->Renderer);
+    }
+
   // The interactor never calls Render() on the render window.
   this->Interactor->SetEnableRender(false);
 
   // Ensure this view catches all render requests and ensure the desired framerate
   this->qvtkReconnect(this->RenderWindow->GetInteractor(), this->Interactor,
-                vtkCommand::RenderEvent, q, SLOT(scheduleRender()));
+                vtkCommand::RenderEvent, this, SLOT(onRenderRequested()));
+
+  // Renderer events are invoked for each tile of the quilt
+  this->qvtkConnect(this->Renderer, vtkCommand::StartEvent,
+                    this, SLOT(onRendererStartEvent()), 1000.0);
+  this->qvtkConnect(this->Renderer, vtkCommand::StartEvent,
+                    this, SLOT(onRendererStartEventProcessed()), -1000.0);
+  this->qvtkConnect(this->Renderer, vtkCommand::EndEvent,
+                    this, SLOT(onRendererEndEvent()));
 
   vtkMRMLLookingGlassViewDisplayableManagerFactory* factory
     = vtkMRMLLookingGlassViewDisplayableManagerFactory::GetInstance();
@@ -202,34 +553,17 @@ void qMRMLLookingGlassViewPrivate::createRenderWindow()
   }
   factory->SetMRMLApplicationLogic(appLogic);
 
-  QStringList displayableManagers;
-  displayableManagers
-      << "vtkMRMLCameraDisplayableManager"
-  //<< "vtkMRMLViewDisplayableManager"
-      << "vtkMRMLModelDisplayableManager"
-      << "vtkMRMLThreeDReformatDisplayableManager"
-      << "vtkMRMLCrosshairDisplayableManager3D"
-      << "vtkMRMLOrientationMarkerDisplayableManager"
-      << "vtkMRMLRulerDisplayableManager"
-      << "vtkMRMLAnnotationDisplayableManager"
-      << "vtkMRMLMarkupsDisplayableManager"
-      << "vtkMRMLSegmentationsDisplayableManager3D"
-      << "vtkMRMLTransformsDisplayableManager3D"
-      << "vtkMRMLLinearTransformsDisplayableManager3D"
-      << "vtkMRMLVolumeRenderingDisplayableManager"
-      ;
-
-  foreach (const QString& displayableManager, displayableManagers)
-  {
-    if (!factory->IsDisplayableManagerRegistered(displayableManager.toLatin1()))
-    {
-      factory->RegisterDisplayableManager(displayableManager.toLatin1());
-    }
-  }
-
+  // Displayable managers registered in the factory by other modules are
+  // instantiated immediately, the ones of the view node when needed.
   this->DisplayableManagerGroup = vtkSmartPointer<vtkMRMLDisplayableManagerGroup>::Take(
                                     factory->InstantiateDisplayableManagers(q->renderer()));
   this->DisplayableManagerGroup->SetMRMLDisplayableNode(this->MRMLLookingGlassViewNode);
+  this->InstantiatedDisplayableManagers.clear();
+  this->updatePendingDisplayableManagers();
+  this->instantiatePendingDisplayableManagers();
+  this->ObservedScene = this->MRMLLookingGlassViewNode->GetScene();
+  this->qvtkConnect(this->ObservedScene, vtkMRMLScene::NodeAddedEvent,
+    this, SLOT(onSceneNodeAdded(vtkObject*, vtkObject*)));
 
 //  ///CONFIGURATION OF THE OPENVR ENVIRONEMENT
 
@@ -241,137 +575,1406 @@ void qMRMLLookingGlassViewPrivate::createRenderWindow()
   this->RenderWindow->Initialize();
   this->Renderer->ResetCamera();
 
-  // Observe displayable manager group to catch RequestRender events
-  this->qvtkConnect(this->DisplayableManagerGroup, vtkCommand::UpdateEvent,
-    q, SLOT(scheduleRender()));
+  // Observe displayable manager group to catch RequestRender events
+  this->qvtkConnect(this->DisplayableManagerGroup, vtkCommand::UpdateEvent,
+    this, SLOT(onRenderRequested()));
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::destroyRenderWindow()
+{
+  Q_Q(qMRMLLookingGlassView);
+  this->stopPendingRenders();
+  this->CameraSyncTimer.stop();
+  this->EvictionTimer.stop();
+  this->Suspended = false;
+  this->qvtkDisconnect(this->CameraNode, vtkCommand::ModifiedEvent, q, SLOT(scheduleRender()));
+  this->qvtkDisconnect(this->ReferenceCameraNode, vtkCommand::ModifiedEvent, this, SLOT(onReferenceCameraModified()));
+  this->CameraNode = nullptr;
+  this->ReferenceCameraNode = nullptr;
+  // Must break the connection between interactor and render window,
+  // otherwise they would circularly refer to each other and would not
+  // be deleted.
+  this->Interactor->SetRenderWindow(nullptr);
+  this->Interactor = nullptr;
+  this->InteractorStyle = nullptr;
+  this->qvtkDisconnect(this->ObservedScene, vtkMRMLScene::NodeAddedEvent,
+    this, SLOT(onSceneNodeAdded(vtkObject*, vtkObject*)));
+  this->ObservedScene = nullptr;
+  this->DisplayableManagerGroup = nullptr;
+  this->InstantiatedDisplayableManagers.clear();
+  this->PendingDisplayableManagers.clear();
+  this->QuiltRenderer = nullptr;
+  this->QuiltCuller = nullptr;
+  if (this->LODCache)
+    {
+    this->LODCache->ReleaseGraphicsResources(this->RenderWindow);
+    }
+  this->LODCache = nullptr;
+  this->FrameTimeController = nullptr;
+  // Disables the timer queries of the render window
+  this->PassTimer = nullptr;
+  this->updateGPUTimingOverlay();
+  this->Renderer = nullptr;
+  this->Camera = nullptr;
+  this->QuiltRecorder->releaseGraphicsResources(this->RenderWindow);
+  this->RenderWindow = nullptr;
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::stopPendingRenders()
+{
+  Q_Q(qMRMLLookingGlassView);
+  this->RequestTimer->stop();
+  this->RequestTime = QTime();
+  qMRMLLookingGlassViewPrivate::RenderQueue.removeAll(q);
+  this->RefinementTimer.stop();
+  this->AccumulationTimer.stop();
+  this->AccumulationFramePending = false;
+  this->QuiltSliceTimer.stop();
+  this->QuiltRenderInProgress = false;
+  this->QuiltRenderPending = false;
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::suspendRenderWindow()
+{
+  this->stopPendingRenders();
+  this->CameraSyncTimer.stop();
+  this->Suspended = true;
+  if (!this->QuiltRenderer)
+  {
+    // Release the device display, the window is shown again when resumed
+    this->RenderWindow->SetShowWindow(false);
+  }
+  double timeout = this->MRMLLookingGlassViewNode ? this->MRMLLookingGlassViewNode->GetSuspendedResourcesTimeout() : 0.0;
+  if (timeout > 0.0)
+  {
+    this->EvictionTimer.start(static_cast<int>(std::min(timeout * 1000.0, static_cast<double>(INT_MAX))));
+  }
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::resumeRenderWindow()
+{
+  this->EvictionTimer.stop();
+  this->Suspended = false;
+  if (!this->QuiltRenderer)
+  {
+    this->RenderWindow->SetShowWindow(true);
+  }
+  // The scene may have changed while suspended
+  this->LastRenderedStateMTime = 0;
+}
+
+//---------------------------------------------------------------------------
+bool qMRMLLookingGlassViewPrivate::canKeepSuspendedResources()
+{
+  if (!this->MRMLLookingGlassViewNode || this->MRMLLookingGlassViewNode->GetSuspendedResourcesTimeout() <= 0.0)
+  {
+    return false;
+  }
+  return this->estimatedRenderedDataSize() <= this->MRMLLookingGlassViewNode->GetSuspendedResourcesMemoryLimit();
+}
+
+//---------------------------------------------------------------------------
+double qMRMLLookingGlassViewPrivate::estimatedRenderedDataSize()
+{
+  if (!this->Renderer)
+  {
+    return 0.0;
+  }
+  // Size of the input data of the mappers, an approximation of the size of
+  // the buffers and textures uploaded to the GPU.
+  double sizeInKiB = 0.0;
+  vtkPropCollection* props = this->Renderer->GetViewProps();
+  vtkCollectionSimpleIterator it;
+  vtkProp* prop = nullptr;
+  for (props->InitTraversal(it); (prop = props->GetNextProp(it));)
+  {
+    vtkDataSet* data = renderedData(prop);
+    if (data)
+    {
+      sizeInKiB += data->GetActualMemorySize();
+    }
+  }
+  return sizeInKiB / 1024.0;
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onEvictionTimeout()
+{
+  if (this->Suspended)
+  {
+    this->destroyRenderWindow();
+  }
+}
+
+// --------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::updateWidgetFromMRML()
+{
+  Q_Q(qMRMLLookingGlassView);
+  this->updateQuiltPublishing();
+  if (!this->MRMLLookingGlassViewNode || !this->MRMLLookingGlassViewNode->GetVisibility())
+  {
+    // Keep the render resources for a fast reconnection, unless the limits
+    // of the view node are exceeded.
+    if (this->RenderWindow != nullptr && !this->Suspended)
+    {
+      this->suspendRenderWindow();
+    }
+    if (this->RenderWindow != nullptr && !this->canKeepSuspendedResources())
+    {
+      this->destroyRenderWindow();
+    }
+    if (this->MRMLLookingGlassViewNode)
+    {
+      this->MRMLLookingGlassViewNode->ClearError();
+    }
+    return;
+  }
+
+  if (this->Suspended)
+  {
+    this->resumeRenderWindow();
+  }
+
+  if (this->RenderWindow
+    && this->MRMLLookingGlassViewNode->GetVirtualDevice() != (this->QuiltRenderer != nullptr))
+  {
+    // Switch between device and virtual device rendering
+    this->destroyRenderWindow();
+  }
+
+  if (this->RenderWindow
+    && this->MRMLLookingGlassViewNode->GetShareReferenceViewContext() != this->ReferenceViewContextRequested)
+  {
+    // Share group of the context is chosen when the render window is created
+    this->destroyRenderWindow();
+  }
+
+  if (this->RenderWindow)
+  {
+    if (this->updatePendingDisplayableManagers())
+    {
+      this->instantiatePendingDisplayableManagers();
+    }
+    else
+    {
+      // Displayable managers cannot be removed from the group
+      this->destroyRenderWindow();
+    }
+  }
+
+  if (!this->RenderWindow)
+  {
+    QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
+    this->createRenderWindow();
+    QApplication::restoreOverrideCursor();
+    if (!q->isHardwareConnected() && !q->isVirtualDevice())
+    {
+      this->MRMLLookingGlassViewNode->SetError("Connection failed");
+      return;
+    }
+    this->MRMLLookingGlassViewNode->ClearError();
+  }
+
+  if (this->DisplayableManagerGroup->GetMRMLDisplayableNode() != this->MRMLLookingGlassViewNode.GetPointer())
+  {
+    this->DisplayableManagerGroup->SetMRMLDisplayableNode(this->MRMLLookingGlassViewNode);
+  }
+
+  // Renderer properties
+  this->Renderer->SetGradientBackground(1);
+  this->Renderer->SetBackground(this->MRMLLookingGlassViewNode->GetBackgroundColor());
+  this->Renderer->SetBackground2(this->MRMLLookingGlassViewNode->GetBackgroundColor2());
+
+  // Translucent geometry is rendered for each tile of the quilt. The renderer
+  // uses weighted blended order independent transparency if depth peeling
+  // is disabled.
+  int transparencyMode = this->MRMLLookingGlassViewNode->GetTransparencyMode();
+  bool useDepthPeeling = (transparencyMode == vtkMRMLLookingGlassViewNode::TransparencyModeDualDepthPeeling)
+    || (transparencyMode == vtkMRMLLookingGlassViewNode::TransparencyModeDefault
+        && this->MRMLLookingGlassViewNode->GetUseDepthPeeling() != 0);
+  this->Renderer->SetUseDepthPeeling(useDepthPeeling);
+  this->Renderer->SetUseDepthPeelingForVolumes(useDepthPeeling);
+  this->FullQualityMaximumNumberOfPeels = this->MRMLLookingGlassViewNode->GetMaximumNumberOfPeels();
+
+  if (this->PassTimer)
+  {
+    this->PassTimer->SetEnabled(this->MRMLLookingGlassViewNode->GetGPUTiming());
+  }
+  this->updateGPUTimingOverlay();
+
+  if (this->FrameTimeController && !this->isAdaptive())
+  {
+    // Start from full quality when the Adaptive mode is enabled again
+    this->FrameTimeController->Reset();
+  }
+
+  // Render window properties
+  if (this->RenderWindow)
+  {
+    // Desired update rate
+    this->updateRenderQuality();
+
+    vtkMRMLCameraNode* cameraNode = this->CamerasLogic->GetViewActiveCameraNode(this->MRMLLookingGlassViewNode);
+    if (!cameraNode || !cameraNode->GetCamera())
+      {
+      qWarning() << Q_FUNC_INFO << " failed: camera node is not found";
+      return;
+      }
+
+    vtkLookingGlassInterface* lookingGlassInterface = q->lookingGlassTnterface();
+    if (lookingGlassInterface)
+      {
+      // Use clipping limits
+      lookingGlassInterface->SetUseClippingLimits(this->MRMLLookingGlassViewNode->GetUseClippingLimits());
+
+      // Near range limit
+      double previousNearClippingLimit = lookingGlassInterface->GetNearClippingLimit();
+      lookingGlassInterface->SetNearClippingLimit(this->MRMLLookingGlassViewNode->GetNearClippingLimit());
+      if (this->MRMLLookingGlassViewNode->GetUseClippingLimits() &&
+          !vtkMathUtilities::FuzzyCompare<double>(previousNearClippingLimit, this->MRMLLookingGlassViewNode->GetNearClippingLimit()))
+        {
+        // Trigger re-render
+        cameraNode->Modified();
+        }
+
+      // Far range limit
+      double previousFarClippingLimit = lookingGlassInterface->GetFarClippingLimit();
+      lookingGlassInterface->SetFarClippingLimit(this->MRMLLookingGlassViewNode->GetFarClippingLimit());
+      if (this->MRMLLookingGlassViewNode->GetUseClippingLimits() &&
+          !vtkMathUtilities::FuzzyCompare<double>(previousFarClippingLimit, this->MRMLLookingGlassViewNode->GetFarClippingLimit()))
+        {
+        // Trigger re-render
+        cameraNode->Modified();
+        }
+      }
+
+    if (this->QuiltRenderer)
+      {
+      // Quilt layout of the virtual device. The quilt renderer is not part
+      // of the render state, view node modification triggers the re-render.
+      this->QuiltRenderer->SetQuiltColumns(this->MRMLLookingGlassViewNode->GetQuiltColumns());
+      this->QuiltRenderer->SetQuiltRows(this->MRMLLookingGlassViewNode->GetQuiltRows());
+      this->QuiltRenderer->SetTileSize(this->MRMLLookingGlassViewNode->GetTileSize());
+      this->QuiltRenderer->SetDisplayAspect(this->MRMLLookingGlassViewNode->GetDisplayAspect());
+      this->QuiltRenderer->SetViewCone(this->MRMLLookingGlassViewNode->GetViewCone());
+      this->QuiltRenderer->SetUseClippingLimits(this->MRMLLookingGlassViewNode->GetUseClippingLimits());
+      this->QuiltRenderer->SetNearClippingLimit(this->MRMLLookingGlassViewNode->GetNearClippingLimit());
+      this->QuiltRenderer->SetFarClippingLimit(this->MRMLLookingGlassViewNode->GetFarClippingLimit());
+      this->QuiltRenderer->SetMultiViewRendering(this->MRMLLookingGlassViewNode->GetMultiViewRendering());
+      }
+
+    if (this->QuiltCuller)
+      {
+      this->QuiltCuller->SetViewCone(this->QuiltRenderer
+        ? this->MRMLLookingGlassViewNode->GetViewCone() : DeviceViewConeUpperBound);
+      this->QuiltCuller->SetUseClippingLimits(this->MRMLLookingGlassViewNode->GetUseClippingLimits());
+      this->QuiltCuller->SetNearClippingLimit(this->MRMLLookingGlassViewNode->GetNearClippingLimit());
+      this->QuiltCuller->SetFarClippingLimit(this->MRMLLookingGlassViewNode->GetFarClippingLimit());
+      }
+  }
+
+  this->updateCameraNodeObservations();
+
+  // Rendering is driven by changes: the view node has been modified, render
+  // the view with the updated properties.
+  if (this->MRMLLookingGlassViewNode->GetActive())
+    {
+    // Reference camera changes are ignored while rendering is not active
+    this->synchronizeCamera();
+    q->scheduleRender();
+    }
+  else
+    {
+    this->stopPendingRenders();
+    }
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::updateCameraNodeObservations()
+{
+  Q_Q(qMRMLLookingGlassView);
+  vtkMRMLCameraNode* cameraNode = nullptr;
+  vtkMRMLCameraNode* referenceCameraNode = nullptr;
+  if (this->CamerasLogic && this->MRMLLookingGlassViewNode)
+    {
+    cameraNode = this->CamerasLogic->GetViewActiveCameraNode(this->MRMLLookingGlassViewNode);
+    vtkMRMLViewNode* referenceViewNode = this->MRMLLookingGlassViewNode->GetReferenceViewNode();
+    if (referenceViewNode)
+      {
+      referenceCameraNode = this->CamerasLogic->GetViewActiveCameraNode(referenceViewNode);
+      }
+    }
+
+  if (this->CameraNode != cameraNode)
+    {
+    this->qvtkReconnect(this->CameraNode, cameraNode, vtkCommand::ModifiedEvent, q, SLOT(scheduleRender()));
+    this->CameraNode = cameraNode;
+    }
+  if (this->ReferenceCameraNode != referenceCameraNode)
+    {
+    this->qvtkReconnect(this->ReferenceCameraNode, referenceCameraNode, vtkCommand::ModifiedEvent, this, SLOT(onReferenceCameraModified()));
+    this->ReferenceCameraNode = referenceCameraNode;
+    }
+
+  qMRMLThreeDView* referenceView = this->referenceView();
+  vtkInteractorStyle* referenceInteractorStyle = referenceView
+    ? vtkInteractorStyle::SafeDownCast(referenceView->interactorStyle()) : nullptr;
+  if (this->ReferenceInteractorStyle != referenceInteractorStyle)
+    {
+    this->qvtkReconnect(this->ReferenceInteractorStyle, referenceInteractorStyle,
+      vtkCommand::StartInteractionEvent, this, SLOT(onReferenceViewStartInteraction()));
+    this->qvtkReconnect(this->ReferenceInteractorStyle, referenceInteractorStyle,
+      vtkCommand::EndInteractionEvent, this, SLOT(onReferenceViewEndInteraction()));
+    this->ReferenceInteractorStyle = referenceInteractorStyle;
+    // The end of an interaction in the previous reference view is not observed
+    q->setReferenceViewInteractive(false);
+    }
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onReferenceViewStartInteraction()
+{
+  Q_Q(qMRMLLookingGlassView);
+  q->setReferenceViewInteractive(true);
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onReferenceViewEndInteraction()
+{
+  Q_Q(qMRMLLookingGlassView);
+  q->setReferenceViewInteractive(false);
+}
+
+//---------------------------------------------------------------------------
+vtkOpenGLRenderWindow* qMRMLLookingGlassViewPrivate::sharedRenderWindow()
+{
+  Q_Q(qMRMLLookingGlassView);
+  bool virtualDevice = this->MRMLLookingGlassViewNode && this->MRMLLookingGlassViewNode->GetVirtualDevice();
+  foreach (qMRMLLookingGlassView* view, qMRMLLookingGlassViewPrivate::Views)
+    {
+    qMRMLLookingGlassViewPrivate* d = view->d_func();
+    if (view == q || !d->RenderWindow)
+      {
+      continue;
+      }
+    if ((d->QuiltRenderer != nullptr) == virtualDevice)
+      {
+      return d->RenderWindow;
+      }
+    }
+  return nullptr;
+}
+
+//---------------------------------------------------------------------------
+qMRMLThreeDView* qMRMLLookingGlassViewPrivate::referenceView()
+{
+  vtkMRMLViewNode* referenceViewNode = this->MRMLLookingGlassViewNode
+    ? this->MRMLLookingGlassViewNode->GetReferenceViewNode() : nullptr;
+  qSlicerLayoutManager* layoutManager = qSlicerApplication::application()
+    ? qSlicerApplication::application()->layoutManager() : nullptr;
+  if (!referenceViewNode || !layoutManager)
+    {
+    return nullptr;
+    }
+  qMRMLThreeDWidget* threeDWidget = layoutManager->threeDWidget(referenceViewNode);
+  return threeDWidget ? threeDWidget->threeDView() : nullptr;
+}
+
+//---------------------------------------------------------------------------
+vtkOpenGLRenderWindow* qMRMLLookingGlassViewPrivate::referenceRenderWindow()
+{
+  qMRMLThreeDView* referenceView = this->referenceView();
+  return referenceView ? vtkOpenGLRenderWindow::SafeDownCast(referenceView->renderWindow()) : nullptr;
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::updateGPUTimingOverlay()
+{
+  qMRMLThreeDView* overlayView = nullptr;
+  if (this->PassTimer
+    && this->MRMLLookingGlassViewNode
+    && this->MRMLLookingGlassViewNode->GetGPUTiming()
+    && this->MRMLLookingGlassViewNode->GetGPUTimingOverlay())
+    {
+    overlayView = this->referenceView();
+    }
+
+  if (this->GPUTimingOverlayView != overlayView)
+    {
+    if (this->GPUTimingOverlayView)
+      {
+      this->GPUTimingOverlayView->renderer()->RemoveViewProp(this->GPUTimingOverlayActor);
+      this->GPUTimingOverlayView->scheduleRender();
+      }
+    this->GPUTimingOverlayView = overlayView;
+    if (overlayView)
+      {
+      if (!this->GPUTimingOverlayActor)
+        {
+        this->GPUTimingOverlayActor = vtkSmartPointer<vtkTextActor>::New();
+        this->GPUTimingOverlayActor->GetPositionCoordinate()->SetCoordinateSystemToNormalizedViewport();
+        this->GPUTimingOverlayActor->SetPosition(0.01, 0.99);
+        this->GPUTimingOverlayActor->GetTextProperty()->SetVerticalJustificationToTop();
+        this->GPUTimingOverlayActor->GetTextProperty()->SetFontSize(14);
+        }
+      overlayView->renderer()->AddViewProp(this->GPUTimingOverlayActor);
+      }
+    }
+  if (!overlayView)
+    {
+    return;
+    }
+
+  // The overlay is only rendered by the reference view, modifying it does
+  // not trigger a looking glass render.
+  QStringList lines;
+  if (!this->PassTimer->IsSupported())
+    {
+    lines << QString("GPU timer queries are not supported");
+    }
+  else
+    {
+    vtkMRMLLookingGlassRenderStatistics* statistics = this->MRMLLookingGlassViewNode->GetRenderStatistics();
+    lines << QString("Looking glass GPU time (mean)");
+    for (int pass = 0; pass < vtkMRMLLookingGlassRenderStatistics::GPUPass_Last; ++pass)
+      {
+      lines << QString("%1: %2 ms")
+        .arg(vtkMRMLLookingGlassRenderStatistics::GetGPUPassAsString(pass))
+        .arg(statistics->GetMeanGPUPassTime(pass) * 1000.0, 0, 'f', 1);
+      }
+    }
+  std::string text = lines.join("\n").toStdString();
+  const char* previousText = this->GPUTimingOverlayActor->GetInput();
+  if (previousText && text == previousText)
+    {
+    return;
+    }
+  this->GPUTimingOverlayActor->SetInput(text.c_str());
+  overlayView->scheduleRender();
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::updateGraphicsMemoryStatistics()
+{
+  if (!this->Renderer || !this->RenderWindow)
+    {
+    return;
+    }
+
+  // Buffers of the polydata are cached per data array in the vertex buffer
+  // object cache, which is shared by the render windows of a share group.
+  // Volume textures are owned by each volume mapper, they are uploaded for
+  // each view.
+  std::set<vtkDataSet*> referenceData;
+  vtkOpenGLRenderWindow* referenceRenderWindow = this->referenceRenderWindow();
+  if (referenceRenderWindow && referenceRenderWindow == this->SharedReferenceRenderWindow.GetPointer())
+    {
+    vtkRendererCollection* renderers = referenceRenderWindow->GetRenderers();
+    vtkCollectionSimpleIterator rendererIt;
+    vtkRenderer* renderer = nullptr;
+    for (renderers->InitTraversal(rendererIt); (renderer = renderers->GetNextRenderer(rendererIt));)
+      {
+      vtkPropCollection* props = renderer->GetViewProps();
+      vtkCollectionSimpleIterator it;
+      vtkProp* prop = nullptr;
+      for (props->InitTraversal(it); (prop = props->GetNextProp(it));)
+        {
+        vtkActor* actor = vtkActor::SafeDownCast(prop);
+        if (actor && actor->GetMapper() && actor->GetMapper()->GetInput())
+          {
+          referenceData.insert(actor->GetMapper()->GetInput());
+          }
+        }
+      }
+    }
+
+  double uploadedSizeInKiB = 0.0;
+  double sharedSizeInKiB = 0.0;
+  vtkPropCollection* props = this->Renderer->GetViewProps();
+  vtkCollectionSimpleIterator it;
+  vtkProp* prop = nullptr;
+  for (props->InitTraversal(it); (prop = props->GetNextProp(it));)
+    {
+    vtkDataSet* data = renderedData(prop);
+    if (!data)
+      {
+      continue;
+      }
+    if (vtkActor::SafeDownCast(prop) && referenceData.count(data) > 0)
+      {
+      sharedSizeInKiB += data->GetActualMemorySize();
+      }
+    else
+      {
+      uploadedSizeInKiB += data->GetActualMemorySize();
+      }
+    }
+  this->MRMLLookingGlassViewNode->GetRenderStatistics()->SetGraphicsMemory(
+    uploadedSizeInKiB / 1024.0, sharedSizeInKiB / 1024.0);
+}
+
+//---------------------------------------------------------------------------
+int qMRMLLookingGlassViewPrivate::numberOfRenderingViews()
+{
+  int numberOfViews = 0;
+  foreach (qMRMLLookingGlassView* view, qMRMLLookingGlassViewPrivate::Views)
+    {
+    vtkMRMLLookingGlassViewNode* viewNode = view->mrmlLookingGlassViewNode();
+    if (viewNode && viewNode->GetActive() && viewNode->GetVisibility())
+      {
+      ++numberOfViews;
+      }
+    }
+  return numberOfViews;
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::queueRender()
+{
+  Q_Q(qMRMLLookingGlassView);
+  if (!qMRMLLookingGlassViewPrivate::RenderQueue.contains(q))
+    {
+    qMRMLLookingGlassViewPrivate::RenderQueue.append(q);
+    }
+  if (!qMRMLLookingGlassViewPrivate::RenderTurnScheduled)
+    {
+    // Application events are processed between the turns
+    qMRMLLookingGlassViewPrivate::RenderTurnScheduled = true;
+    QTimer::singleShot(0, &qMRMLLookingGlassViewPrivate::renderNextQueuedView);
+    }
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::renderNextQueuedView()
+{
+  qMRMLLookingGlassViewPrivate::RenderTurnScheduled = false;
+  if (qMRMLLookingGlassViewPrivate::RenderQueue.isEmpty())
+    {
+    return;
+    }
+  qMRMLLookingGlassView* view = qMRMLLookingGlassViewPrivate::RenderQueue.takeFirst();
+  qMRMLLookingGlassViewPrivate* d = view->d_func();
+  d->RenderTurn = true;
+  view->requestRender();
+  d->RenderTurn = false;
+  if (!qMRMLLookingGlassViewPrivate::RenderQueue.isEmpty()
+    && !qMRMLLookingGlassViewPrivate::RenderTurnScheduled)
+    {
+    qMRMLLookingGlassViewPrivate::RenderTurnScheduled = true;
+    QTimer::singleShot(0, &qMRMLLookingGlassViewPrivate::renderNextQueuedView);
+    }
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onReferenceCameraModified()
+{
+  this->synchronizeCamera();
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::synchronizeCamera(bool force)
+{
+  Q_Q(qMRMLLookingGlassView);
+  if (!this->MRMLLookingGlassViewNode
+    || !this->MRMLLookingGlassViewNode->GetActive()
+    || !this->ReferenceCameraNode
+    || !this->LastViewUpdateTime)
+    {
+    return;
+    }
+  int renderingMode = this->MRMLLookingGlassViewNode->GetRenderingMode();
+  if (renderingMode == vtkMRMLLookingGlassViewNode::RenderingModeOnlyWhenRequested)
+    {
+    return;
+    }
+  if (renderingMode == vtkMRMLLookingGlassViewNode::RenderingModeOnlyStillRenders
+    && this->ReferenceViewInteractive)
+    {
+    // Camera is synchronized when interaction ends
+    return;
+    }
+  if (!force)
+    {
+    // Ignore small changes (e.g. jitter of tracked pointers) that would
+    // trigger a full quilt render.
+    if (!this->isReferenceCameraChangeSignificant())
+      {
+      return;
+      }
+    this->LastViewUpdateTime->StopTimer();
+    double elapsedTime = this->LastViewUpdateTime->GetElapsedTime();
+    if (elapsedTime < this->CameraSyncMinimumInterval)
+      {
+      if (!this->CameraSyncTimer.isActive())
+        {
+        this->CameraSyncTimer.start(
+          static_cast<int>((this->CameraSyncMinimumInterval - elapsedTime) * 1000.) + 1);
+        }
+      return;
+      }
+    }
+  this->CameraSyncTimer.stop();
+  q->updateViewFromReferenceViewCamera();
+}
+
+//---------------------------------------------------------------------------
+bool qMRMLLookingGlassViewPrivate::isReferenceCameraChangeSignificant()
+{
+  vtkCamera* referenceCamera = this->ReferenceCameraNode ? this->ReferenceCameraNode->GetCamera() : nullptr;
+  if (!referenceCamera)
+    {
+    return false;
+    }
+
+  double position[3] = { 0.0, 0.0, 0.0 };
+  referenceCamera->GetPosition(position);
+  if (sqrt(vtkMath::Distance2BetweenPoints(position, this->LastViewPosition)) > this->CameraSyncTranslationThreshold)
+    {
+    return true;
+    }
+
+  double direction[3] = { 0.0, 0.0, 1.0 };
+  referenceCamera->GetDirectionOfProjection(direction);
+  double viewUp[3] = { 0.0, 1.0, 0.0 };
+  referenceCamera->GetViewUp(viewUp);
+  double rotation = std::max(
+    vtkMath::DegreesFromRadians(vtkMath::AngleBetweenVectors(direction, this->LastViewDirection)),
+    vtkMath::DegreesFromRadians(vtkMath::AngleBetweenVectors(viewUp, this->LastViewUp)));
+  if (rotation > this->CameraSyncRotationThreshold)
+    {
+    return true;
+    }
+
+  // Zoom does not move the camera in parallel projection or when the view angle is changed
+  vtkCamera* camera = this->CameraNode ? this->CameraNode->GetCamera() : nullptr;
+  if (camera)
+    {
+    if (camera->GetParallelProjection() != referenceCamera->GetParallelProjection()
+      || !vtkMathUtilities::FuzzyCompare<double>(camera->GetParallelScale(), referenceCamera->GetParallelScale())
+      || !vtkMathUtilities::FuzzyCompare<double>(camera->GetViewAngle(), referenceCamera->GetViewAngle()))
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onRendererStartEvent()
+{
+  ++this->FrameTileCount;
+  this->RendererStartTime = vtkTimerLog::GetUniversalTime();
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onRendererStartEventProcessed()
+{
+  this->TileRenderStartTime = vtkTimerLog::GetUniversalTime();
+  this->FramePhaseTimes[vtkMRMLLookingGlassRenderStatistics::PhaseDisplayableManagerUpdate] +=
+    this->TileRenderStartTime - this->RendererStartTime;
+  // Displayable managers may have reset the sample distances
+  this->applyVolumeSampleDistances();
+  // Displayable managers update the actors with their original mappers
+  this->applyLevelOfDetail();
+  if (this->PassTimer)
+    {
+    // Displayable manager updates are CPU work, not timed on the GPU
+    this->PassTimer->BeginTile();
+    }
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onRendererEndEvent()
+{
+  this->restoreFullDetail();
+  if (this->PassTimer)
+    {
+    this->PassTimer->EndTile();
+    }
+  this->FramePhaseTimes[vtkMRMLLookingGlassRenderStatistics::PhaseQuiltRender] +=
+    vtkTimerLog::GetUniversalTime() - this->TileRenderStartTime;
+}
+
+//---------------------------------------------------------------------------
+vtkMTimeType qMRMLLookingGlassViewPrivate::renderStateMTime()
+{
+  vtkMTimeType mtime = 0;
+  if (this->MRMLLookingGlassViewNode)
+    {
+    mtime = std::max(mtime, this->MRMLLookingGlassViewNode->GetMTime());
+    }
+  if (this->CameraNode)
+    {
+    mtime = std::max(mtime, this->CameraNode->GetMTime());
+    }
+  if (this->RenderWindow)
+    {
+    // Includes size changes
+    mtime = std::max(mtime, this->RenderWindow->GetMTime());
+    }
+  if (!this->Renderer)
+    {
+    return mtime;
+    }
+  mtime = std::max(mtime, this->Renderer->GetMTime());
+  if (this->Renderer->GetActiveCamera())
+    {
+    mtime = std::max(mtime, this->Renderer->GetActiveCamera()->GetMTime());
+    }
+
+  vtkPropCollection* props = this->Renderer->GetViewProps();
+  // Props added or removed
+  mtime = std::max(mtime, props->GetMTime());
+  vtkCollectionSimpleIterator pit;
+  vtkProp* prop = nullptr;
+  for (props->InitTraversal(pit); (prop = props->GetNextProp(pit));)
+    {
+    if (!prop->GetVisibility())
+      {
+      // Only a visibility change may affect the rendering
+      mtime = std::max(mtime, prop->GetMTime());
+      continue;
+      }
+    // Includes property, mapper and mapper input changes
+    mtime = std::max(mtime, prop->GetRedrawMTime());
+    }
+  return mtime;
+}
+
+//---------------------------------------------------------------------------
+bool qMRMLLookingGlassViewPrivate::isRenderStateModified()
+{
+  return this->RenderRequested || this->renderStateMTime() > this->LastRenderedStateMTime;
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onRenderRequested()
+{
+  Q_Q(qMRMLLookingGlassView);
+  // Displayable managers postpone their update to the renderer StartEvent,
+  // no prop has been modified yet.
+  this->RenderRequested = true;
+  q->scheduleRender();
+}
+
+//---------------------------------------------------------------------------
+bool qMRMLLookingGlassViewPrivate::updatePendingDisplayableManagers()
+{
+  QStringList displayableManagers;
+  for (const std::string& displayableManager : this->MRMLLookingGlassViewNode->GetDisplayableManagers())
+  {
+    displayableManagers << QString::fromStdString(displayableManager);
+  }
+  foreach (const QString& displayableManager, this->InstantiatedDisplayableManagers)
+  {
+    if (!displayableManagers.contains(displayableManager))
+    {
+      return false;
+    }
+  }
+  this->PendingDisplayableManagers.clear();
+  foreach (const QString& displayableManager, displayableManagers)
+  {
+    if (!this->InstantiatedDisplayableManagers.contains(displayableManager)
+      && !this->DisplayableManagerGroup->GetDisplayableManagerByClassName(displayableManager.toLatin1()))
+    {
+      this->PendingDisplayableManagers << displayableManager;
+    }
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::instantiatePendingDisplayableManagers(vtkMRMLNode* addedNode)
+{
+  Q_Q(qMRMLLookingGlassView);
+  if (!this->DisplayableManagerGroup || this->PendingDisplayableManagers.isEmpty())
+  {
+    return;
+  }
+  vtkMRMLScene* scene = this->MRMLLookingGlassViewNode ? this->MRMLLookingGlassViewNode->GetScene() : nullptr;
+  QStringList pendingDisplayableManagers;
+  bool instantiated = false;
+  foreach (const QString& displayableManagerName, this->PendingDisplayableManagers)
+  {
+    const char* nodeClass = displayedNodeClass(displayableManagerName);
+    bool needed = (nodeClass == nullptr);
+    if (nodeClass && addedNode)
+    {
+      needed = addedNode->IsA(nodeClass);
+    }
+    else if (nodeClass && scene)
+    {
+      needed = scene->GetFirstNodeByClass(nodeClass) != nullptr;
+    }
+    if (!needed)
+    {
+      pendingDisplayableManagers << displayableManagerName;
+      continue;
+    }
+    vtkSmartPointer<vtkMRMLAbstractDisplayableManager> displayableManager;
+    displayableManager.TakeReference(
+      vtkMRMLDisplayableManagerGroup::InstantiateDisplayableManager(displayableManagerName.toLatin1()));
+    if (!displayableManager)
+    {
+      qWarning() << Q_FUNC_INFO << ": Failed to instantiate displayable manager" << displayableManagerName;
+      continue;
+    }
+    this->DisplayableManagerGroup->AddDisplayableManager(displayableManager);
+    this->InstantiatedDisplayableManagers << displayableManagerName;
+    instantiated = true;
+  }
+  this->PendingDisplayableManagers = pendingDisplayableManagers;
+  if (instantiated && this->Renderer)
+  {
+    // New displayable managers add their props when the renderer starts
+    this->RenderRequested = true;
+    q->scheduleRender();
+  }
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onSceneNodeAdded(vtkObject* vtkNotUsed(scene), vtkObject* node)
+{
+  vtkMRMLNode* addedNode = vtkMRMLNode::SafeDownCast(node);
+  if (!addedNode)
+  {
+    return;
+  }
+  this->instantiatePendingDisplayableManagers(addedNode);
+}
+
+//---------------------------------------------------------------------------
+double qMRMLLookingGlassViewPrivate::desiredUpdateRate()
+{
+  double rate = this->MRMLLookingGlassViewNode->GetDesiredUpdateRate();
+
+  // enforce non-zero frame rate to avoid division by zero errors
+  const double defaultStaticViewUpdateRate = 0.0001;
+  if (rate < defaultStaticViewUpdateRate)
+  {
+    rate = defaultStaticViewUpdateRate;
+  }
+
+  return rate;
+}
+
+//---------------------------------------------------------------------------
+bool qMRMLLookingGlassViewPrivate::isInteractiveQualityReduced()
+{
+  return this->MRMLLookingGlassViewNode
+    && this->MRMLLookingGlassViewNode->GetRenderingMode() == vtkMRMLLookingGlassViewNode::RenderingModeAlways
+    && this->MRMLLookingGlassViewNode->GetReduceQualityDuringInteraction()
+    && this->ReferenceViewInteractive;
+}
+
+//---------------------------------------------------------------------------
+double qMRMLLookingGlassViewPrivate::renderQuality()
+{
+  if (this->isInteractiveQualityReduced())
+    {
+    return this->InteractiveQuality;
+    }
+  if (this->QuiltRenderer)
+    {
+    // Coarse frames of the virtual device render fewer views in full quality
+    return 1.0;
+    }
+  return this->RefinementQuality;
+}
+
+//---------------------------------------------------------------------------
+bool qMRMLLookingGlassViewPrivate::isAdaptive()
+{
+  return this->MRMLLookingGlassViewNode
+    && this->MRMLLookingGlassViewNode->GetRenderingMode() == vtkMRMLLookingGlassViewNode::RenderingModeAdaptive;
+}
+
+//---------------------------------------------------------------------------
+double qMRMLLookingGlassViewPrivate::renderQuality(int knob)
+{
+  if (this->isAdaptive() && this->FrameTimeController)
+    {
+    return this->FrameTimeController->GetKnobValue(knob);
+    }
+  if (knob == vtkSlicerLookingGlassFrameTimeController::KnobViewCount)
+    {
+    // Coarse frames of the virtual device render a sparse subset of the
+    // views and synthesize the others. The device renders all its views.
+    return this->QuiltRenderer && !this->isInteractiveQualityReduced() ? this->RefinementQuality : 1.0;
+    }
+  if (knob == vtkSlicerLookingGlassFrameTimeController::KnobTileResolution)
+    {
+    // Tile resolution is only reduced in the Adaptive rendering mode
+    return 1.0;
+    }
+  return this->renderQuality();
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::updateRenderQuality()
+{
+  if (!this->MRMLLookingGlassViewNode || !this->RenderWindow || !this->Renderer)
+    {
+    return;
+    }
+
+  // The quilt of devices is not read back for temporal accumulation, full
+  // quality frames are anti-aliased by FXAA, which is cheap compared to MSAA.
+  this->Renderer->SetUseFXAA(!this->QuiltRenderer && this->renderQuality() >= 1.0
+    && this->MRMLLookingGlassViewNode->GetTemporalAccumulation());
+
+  if (this->isAdaptive())
+    {
+    // Volume sample distances follow the adaptive volume quality, translucent
+    // geometry is rendered with fewer peels when geometry quality is reduced
+    this->RenderWindow->SetDesiredUpdateRate(this->desiredUpdateRate());
+    this->Renderer->SetMaximumNumberOfPeels(std::max(1, static_cast<int>(std::floor(
+      this->FullQualityMaximumNumberOfPeels * this->renderQuality(vtkSlicerLookingGlassFrameTimeController::KnobGeometry) + 0.5))));
+    return;
+    }
+
+  double quality = this->renderQuality();
+  if (quality >= 1.0)
+    {
+    if (this->MRMLLookingGlassViewNode->GetRenderingMode() == vtkMRMLLookingGlassViewNode::RenderingModeAlways
+      && !this->MRMLLookingGlassViewNode->GetReduceQualityDuringInteraction())
+      {
+      this->RenderWindow->SetDesiredUpdateRate(this->desiredUpdateRate());
+      }
+    else
+      {
+      // Still render
+      this->RenderWindow->SetDesiredUpdateRate(1);
+      }
+    this->Renderer->SetMaximumNumberOfPeels(this->FullQualityMaximumNumberOfPeels);
+    return;
+    }
+
+  // The renderer is rendered once for each tile of the quilt, the time
+  // allocated to the props (e.g. volume ray casting sample distance) must be
+  // shared by all the tiles to reach the desired update rate of the quilt.
+  this->RenderWindow->SetDesiredUpdateRate(
+    this->desiredUpdateRate() * this->NumberOfTilesPerFrame / quality);
+
+  // Translucent geometry is rendered with fewer peels
+  this->Renderer->SetMaximumNumberOfPeels(std::max(1,
+    static_cast<int>(std::floor(this->FullQualityMaximumNumberOfPeels * quality + 0.5))));
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::updateVolumeRenderingQuality()
+{
+  this->VolumeOversamplingFactor = 0.0;
+  if (!this->LookingGlassLogic || !this->MRMLLookingGlassViewNode)
+    {
+    return;
+    }
+  // The factor is applied to the mappers of this view only, modifying the
+  // view node would save the interaction quality in the scene.
+  this->VolumeOversamplingFactor = this->LookingGlassLogic->GetVolumeRenderingOversamplingFactor(
+    this->MRMLLookingGlassViewNode, this->renderQuality(vtkSlicerLookingGlassFrameTimeController::KnobVolume));
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::applyVolumeSampleDistances()
+{
+  if (this->VolumeOversamplingFactor <= 0.0 || !this->Renderer)
+    {
+    this->AppliedSampleDistances.clear();
+    return;
+    }
+  // Mappers removed from the renderer are forgotten
+  QHash<vtkGPUVolumeRayCastMapper*, AppliedSampleDistance> appliedSampleDistances;
+  vtkPropCollection* props = this->Renderer->GetViewProps();
+  vtkCollectionSimpleIterator it;
+  vtkProp* prop = nullptr;
+  for (props->InitTraversal(it); (prop = props->GetNextProp(it));)
+    {
+    vtkVolume* volume = vtkVolume::SafeDownCast(prop);
+    vtkGPUVolumeRayCastMapper* mapper = volume
+      ? vtkGPUVolumeRayCastMapper::SafeDownCast(volume->GetMapper()) : nullptr;
+    vtkImageData* image = mapper ? mapper->GetInput() : nullptr;
+    if (!image || !volume->GetVisibility())
+      {
+      continue;
+      }
+    // The mappers are only used by this view. Settings are only modified
+    // when the factor changes or when the displayable manager, the volume
+    // transform or the input modified them since they were last set.
+    vtkMTimeType mtime = std::max(std::max(volume->GetMTime(), image->GetMTime()), mapper->GetMTime());
+    QHash<vtkGPUVolumeRayCastMapper*, AppliedSampleDistance>::const_iterator applied =
+      this->AppliedSampleDistances.constFind(mapper);
+    if (applied == this->AppliedSampleDistances.constEnd()
+      || applied->OversamplingFactor != this->VolumeOversamplingFactor
+      || applied->MTime != mtime)
+      {
+      mapper->SetAutoAdjustSampleDistances(0);
+      mapper->SetLockSampleDistanceToInputSpacing(0);
+      mapper->SetSampleDistance(minimumWorldSpacing(volume, image) / this->VolumeOversamplingFactor);
+      mtime = std::max(mtime, mapper->GetMTime());
+      }
+    AppliedSampleDistance appliedSampleDistance = { this->VolumeOversamplingFactor, mtime };
+    appliedSampleDistances.insert(mapper, appliedSampleDistance);
+    }
+  this->AppliedSampleDistances.swap(appliedSampleDistances);
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::adaptInteractiveQuality(double frameTime)
+{
+  if (frameTime <= 0.0)
+    {
+    return;
+    }
+  double targetFrameTime = 1.0 / this->desiredUpdateRate();
+  double ratio = targetFrameTime / frameTime;
+  // Adjustments are damped and only made out of a tolerance band
+  // to prevent the quality level from oscillating between frames.
+  if (ratio < 0.9)
+    {
+    this->InteractiveQuality *= std::max(ratio, 0.5);
+    }
+  else if (ratio > 1.2)
+    {
+    this->InteractiveQuality *= std::min(ratio, 1.25);
+    }
+  this->InteractiveQuality = std::min(std::max(this->InteractiveQuality, MinimumInteractiveQuality), 1.0);
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::adaptRenderQuality(double frameTime)
+{
+  if (!this->FrameTimeController)
+    {
+    return;
+    }
+  vtkSlicerLookingGlassFrameTimeController* controller = this->FrameTimeController;
+  controller->SetTargetFrameTime(1.0 / this->desiredUpdateRate());
+  controller->SetMinimumKnobValue(vtkSlicerLookingGlassFrameTimeController::KnobGeometry,
+    this->MRMLLookingGlassViewNode->GetInteractiveTriangleBudget() > 0
+    ? this->MRMLLookingGlassViewNode->GetAdaptiveMinimumGeometryQuality() : 1.0);
+  controller->SetMinimumKnobValue(vtkSlicerLookingGlassFrameTimeController::KnobVolume,
+    this->MRMLLookingGlassViewNode->GetAdaptiveMinimumVolumeQuality());
+  // The quilt layout of the device cannot be changed
+  controller->SetMinimumKnobValue(vtkSlicerLookingGlassFrameTimeController::KnobViewCount,
+    this->QuiltRenderer ? this->MRMLLookingGlassViewNode->GetAdaptiveMinimumViewFraction() : 1.0);
+  controller->SetMinimumKnobValue(vtkSlicerLookingGlassFrameTimeController::KnobTileResolution,
+    this->QuiltRenderer ? this->MRMLLookingGlassViewNode->GetAdaptiveMinimumTileScale() : 1.0);
+
+  if (!controller->AddFrameTime(frameTime))
+    {
+    return;
+    }
+  this->MRMLLookingGlassViewNode->GetRenderStatistics()->AddAdaptiveAdjustment(
+    controller->GetLastAdjustmentAsString(),
+    controller->GetKnobValue(vtkSlicerLookingGlassFrameTimeController::KnobGeometry),
+    controller->GetKnobValue(vtkSlicerLookingGlassFrameTimeController::KnobVolume),
+    controller->GetKnobValue(vtkSlicerLookingGlassFrameTimeController::KnobViewCount),
+    controller->GetKnobValue(vtkSlicerLookingGlassFrameTimeController::KnobTileResolution));
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::startProgressiveRefinement()
+{
+  this->RefinementTimer.stop();
+  this->RefinementQuality = 1.0;
+  if (!this->ProgressiveRefinement
+    || this->isInteractiveQualityReduced()
+    || this->isAdaptive()
+    || this->LastFullQualityFrameTime <= 0.0)
+    {
+    return;
+    }
+  double targetFrameTime = 1.0 / this->desiredUpdateRate();
+  double quality = targetFrameTime / this->LastFullQualityFrameTime;
+  if (quality >= 0.9)
+    {
+    // Full quality is fast enough
+    return;
+    }
+  this->RefinementQuality = std::max(quality, MinimumInteractiveQuality);
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onRefinementTimeout()
+{
+  Q_Q(qMRMLLookingGlassView);
+  if (!this->MRMLLookingGlassViewNode || !this->MRMLLookingGlassViewNode->GetActive())
+    {
+    return;
+    }
+  if (QApplication::mouseButtons() != Qt::NoButton)
+    {
+    // The full quality render would freeze the application while the user
+    // interacts with another view or widget, postpone it.
+    this->RefinementTimer.start(RefinementRetryInterval);
+    return;
+    }
+  q->requestRender();
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onAccumulationTimeout()
+{
+  Q_Q(qMRMLLookingGlassView);
+  if (!this->MRMLLookingGlassViewNode || !this->MRMLLookingGlassViewNode->GetActive())
+    {
+    return;
+    }
+  if (QApplication::mouseButtons() != Qt::NoButton)
+    {
+    // The user is about to change the scene, which restarts the accumulation
+    this->AccumulationTimer.start(RefinementRetryInterval);
+    return;
+    }
+  this->AccumulationFramePending = true;
+  q->requestRender();
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::updateTemporalAccumulation(bool accumulationFrame)
+{
+  if (!this->QuiltRenderer)
+    {
+    return;
+    }
+  bool temporalAccumulation = this->MRMLLookingGlassViewNode->GetTemporalAccumulation();
+  this->QuiltRenderer->SetTemporalAccumulation(temporalAccumulation);
+  if (!temporalAccumulation || !accumulationFrame)
+    {
+    // The quilts of the previous scene are discarded
+    this->QuiltRenderer->ResetAccumulation();
+    this->QuiltRenderer->SetJitter(0.0, 0.0);
+    return;
+    }
+  int frame = this->QuiltRenderer->GetNumberOfAccumulatedQuilts();
+  this->QuiltRenderer->SetJitter(halton(frame, 2) - 0.5, halton(frame, 3) - 0.5);
 }
 
 //---------------------------------------------------------------------------
-void qMRMLLookingGlassViewPrivate::destroyRenderWindow()
+void qMRMLLookingGlassViewPrivate::continueTemporalAccumulation()
 {
-  Q_Q(qMRMLLookingGlassView);
-  this->LookingGlassLoopTimer.stop();
-  // Must break the connection between interactor and render window,
-  // otherwise they would circularly refer to each other and would not
-  // be deleted.
-  this->Interactor->SetRenderWindow(nullptr);
-  this->Interactor = nullptr;
-  this->InteractorStyle = nullptr;
-  this->DisplayableManagerGroup = nullptr;
-  this->Renderer = nullptr;
-  this->Camera = nullptr;
-  this->RenderWindow = nullptr;
+  this->AccumulationTimer.stop();
+  if (!this->QuiltRenderer
+    || !this->MRMLLookingGlassViewNode->GetTemporalAccumulation()
+    || this->QuiltRenderPending
+    || this->ReferenceViewInteractive
+    || this->renderQuality() < 1.0
+    || this->RefinementQuality < 1.0
+    || this->QuiltRenderer->GetNumberOfAccumulatedQuilts()
+      >= this->MRMLLookingGlassViewNode->GetMaximumNumberOfAccumulatedFrames())
+    {
+    return;
+    }
+  this->AccumulationTimer.start(0);
 }
 
-// --------------------------------------------------------------------------
-void qMRMLLookingGlassViewPrivate::updateWidgetFromMRML()
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::onQuiltSliceTimeout()
 {
   Q_Q(qMRMLLookingGlassView);
-  if (!this->MRMLLookingGlassViewNode || !this->MRMLLookingGlassViewNode->GetVisibility())
-  {
-    if (this->RenderWindow != nullptr)
+  if (!this->QuiltRenderInProgress || !this->QuiltRenderer)
     {
-      this->destroyRenderWindow();
+    return;
     }
-    if (this->MRMLLookingGlassViewNode)
+  this->RenderInProgress = true;
+  bool quiltComplete = this->renderQuiltSlice();
+  if (quiltComplete)
     {
-      this->MRMLLookingGlassViewNode->ClearError();
+    this->endFrame();
     }
-    return;
-  }
+  this->RenderInProgress = false;
 
-  if (!this->RenderWindow)
-  {
-    QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
-    this->createRenderWindow();
-    QApplication::restoreOverrideCursor();
-    if (!q->isHardwareConnected())
+  if (quiltComplete && this->QuiltRenderPending)
     {
-      this->MRMLLookingGlassViewNode->SetError("Connection failed");
-      return;
+    // The scene changed while the quilt was rendered in several slices
+    this->QuiltRenderPending = false;
+    q->scheduleRender();
     }
-    this->MRMLLookingGlassViewNode->ClearError();
-  }
-
-  if (this->DisplayableManagerGroup->GetMRMLDisplayableNode() != this->MRMLLookingGlassViewNode.GetPointer())
-  {
-    this->DisplayableManagerGroup->SetMRMLDisplayableNode(this->MRMLLookingGlassViewNode);
-  }
+}
 
-  // Renderer properties
-  this->Renderer->SetGradientBackground(1);
-  this->Renderer->SetBackground(this->MRMLLookingGlassViewNode->GetBackgroundColor());
-  this->Renderer->SetBackground2(this->MRMLLookingGlassViewNode->GetBackgroundColor2());
-  this->Renderer->SetUseDepthPeeling(this->MRMLLookingGlassViewNode->GetUseDepthPeeling() != 0);
-  this->Renderer->SetUseDepthPeelingForVolumes(this->MRMLLookingGlassViewNode->GetUseDepthPeeling() != 0);
+//---------------------------------------------------------------------------
+bool qMRMLLookingGlassViewPrivate::renderQuiltSlice()
+{
+  double timeSlice = this->MRMLLookingGlassViewNode->GetQuiltRenderTimeSlice();
+  double timeBudget = timeSlice > 0.0 ? timeSlice : VTK_DOUBLE_MAX;
+  double startTime = vtkTimerLog::GetUniversalTime();
+  bool success = this->QuiltRenderer->RenderNextTiles(timeBudget);
+  this->FrameRenderTime += vtkTimerLog::GetUniversalTime() - startTime;
+  if (success && !this->QuiltRenderer->IsQuiltComplete())
+    {
+    this->QuiltRenderInProgress = true;
+    this->QuiltSliceTimer.start();
+    return false;
+    }
+  this->QuiltRenderInProgress = false;
+  return true;
+}
 
-  // Render window properties
-  if (this->RenderWindow)
-  {
-    // Desired update rate
-    if (this->MRMLLookingGlassViewNode->GetRenderingMode() == vtkMRMLLookingGlassViewNode::RenderingModeAlways)
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::applyLevelOfDetail()
+{
+  if (!this->LODCache || !this->MRMLLookingGlassViewNode)
     {
-      this->RenderWindow->SetDesiredUpdateRate(this->desiredUpdateRate());
+    return;
     }
-    else
+  double quality = this->renderQuality(vtkSlicerLookingGlassFrameTimeController::KnobGeometry);
+  int quiltTriangleBudget = this->MRMLLookingGlassViewNode->GetInteractiveTriangleBudget();
+  if (quality >= 1.0 || quiltTriangleBudget <= 0)
     {
-      this->RenderWindow->SetDesiredUpdateRate(1);
+    // Full detail for still renders
+    return;
     }
+  // The budget of the quilt is shared by all its tiles, and it follows the
+  // quality level adapted from the measured frame times.
+  vtkIdType triangleBudget = static_cast<vtkIdType>(
+    quiltTriangleBudget * quality / std::max(1, this->NumberOfTilesPerFrame));
+  this->LODCache->ApplyProxies(this->Renderer, triangleBudget);
+}
 
-    vtkMRMLCameraNode* cameraNode = this->CamerasLogic->GetViewActiveCameraNode(this->MRMLLookingGlassViewNode);
-    if (!cameraNode || !cameraNode->GetCamera())
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::restoreFullDetail()
+{
+  if (this->LODCache)
+    {
+    this->LODCache->RestoreMappers();
+    }
+}
+
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::endFrame()
+{
+  double quiltCompletedTime = vtkTimerLog::GetUniversalTime();
+  vtkMRMLLookingGlassRenderStatistics* statistics = this->MRMLLookingGlassViewNode->GetRenderStatistics();
+
+  // Time not spent in rendering tiles is spent in drawing the light field
+  // and presenting it on the device.
+  this->FramePhaseTimes[vtkMRMLLookingGlassRenderStatistics::PhaseDeviceSubmit] = std::max(0.0, this->FrameRenderTime
+    - this->FramePhaseTimes[vtkMRMLLookingGlassRenderStatistics::PhaseDisplayableManagerUpdate]
+    - this->FramePhaseTimes[vtkMRMLLookingGlassRenderStatistics::PhaseQuiltRender]);
+  statistics->AddFrame(this->FramePhaseTimes);
+  this->FramePhaseTimes[vtkMRMLLookingGlassRenderStatistics::PhaseCameraSync] = 0.0;
+
+  if (this->FrameTileCount > 0)
+    {
+    this->NumberOfTilesPerFrame = this->FrameTileCount;
+    }
+  this->publishQuilt(quiltCompletedTime);
+  this->recordQuilt();
+  this->updateGraphicsMemoryStatistics();
+  this->continueTemporalAccumulation();
+  if (this->PassTimer)
+    {
+    // Pass times of the previous quilts whose timer queries completed
+    this->PassTimer->EndQuilt();
+    if (this->PassTimer->CollectQuilts(statistics) > 0)
       {
-      qWarning() << Q_FUNC_INFO << " failed: camera node is not found";
-      return;
+      this->updateGPUTimingOverlay();
       }
+    }
+  if (this->isAdaptive())
+    {
+    this->adaptRenderQuality(statistics->GetLastFrameTime());
+    }
+  else if (this->isInteractiveQualityReduced())
+    {
+    this->adaptInteractiveQuality(statistics->GetLastFrameTime());
+    }
+  else if (this->RefinementQuality < 1.0)
+    {
+    this->RefinementTimer.start(0);
+    }
+  else
+    {
+    this->LastFullQualityFrameTime = statistics->GetLastFrameTime();
+    }
 
-    // Use clipping limits
-    q->lookingGlassTnterface()->SetUseClippingLimits(this->MRMLLookingGlassViewNode->GetUseClippingLimits());
+  // Displayable manager updates requested before or while rendering are applied
+  this->RenderRequested = false;
 
-    // Near range limit
-    double previousNearClippingLimit = q->lookingGlassTnterface()->GetNearClippingLimit();
-    q->lookingGlassTnterface()->SetNearClippingLimit(this->MRMLLookingGlassViewNode->GetNearClippingLimit());
-    if (this->MRMLLookingGlassViewNode->GetUseClippingLimits() &&
-        !vtkMathUtilities::FuzzyCompare<double>(previousNearClippingLimit, this->MRMLLookingGlassViewNode->GetNearClippingLimit()))
-      {
-      // Trigger re-render
-      cameraNode->Modified();
-      }
+  if (this->QuiltRenderPending)
+    {
+    // Changes made between quilt slices are not rendered yet
+    this->LastRenderedStateMTime = 0;
+    return;
+    }
 
-    // Far range limit
-    double previousFarClippingLimit = q->lookingGlassTnterface()->GetFarClippingLimit();
-    q->lookingGlassTnterface()->SetFarClippingLimit(this->MRMLLookingGlassViewNode->GetFarClippingLimit());
-    if (this->MRMLLookingGlassViewNode->GetUseClippingLimits() &&
-        !vtkMathUtilities::FuzzyCompare<double>(previousFarClippingLimit, this->MRMLLookingGlassViewNode->GetFarClippingLimit()))
-      {
-      // Trigger re-render
-      cameraNode->Modified();
-      }
-  }
+  // Modifications made while rendering (e.g. clipping range update) are
+  // part of the rendered state.
+  this->LastRenderedStateMTime = this->renderStateMTime();
+}
 
-  if (this->MRMLLookingGlassViewNode->GetActive())
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::recordQuilt()
+{
+  Q_Q(qMRMLLookingGlassView);
+  if (!this->QuiltRecorder->isRecording())
     {
-    this->LookingGlassLoopTimer.start(0);
+    return;
     }
-  else
+  if (this->QuiltRenderer)
     {
-    this->LookingGlassLoopTimer.stop();
+    // The quilt of the virtual device is already read back
+    this->QuiltRecorder->captureImage(this->QuiltRenderer->GetQuiltImage());
+    return;
+    }
+  vtkLookingGlassInterface* lookingGlassInterface = q->lookingGlassTnterface();
+  if (lookingGlassInterface)
+    {
+    this->QuiltRecorder->captureFramebuffer(this->RenderWindow, lookingGlassInterface->GetQuiltFramebuffer());
     }
 }
 
 //---------------------------------------------------------------------------
-double qMRMLLookingGlassViewPrivate::desiredUpdateRate()
+void qMRMLLookingGlassViewPrivate::updateQuiltPublishing()
 {
-  double rate = this->MRMLLookingGlassViewNode->GetDesiredUpdateRate();
-
-  // enforce non-zero frame rate to avoid division by zero errors
-  const double defaultStaticViewUpdateRate = 0.0001;
-  if (rate < defaultStaticViewUpdateRate)
-  {
-    rate = defaultStaticViewUpdateRate;
-  }
+  if (!this->MRMLLookingGlassViewNode || !this->MRMLLookingGlassViewNode->GetQuiltPublishing())
+    {
+    this->QuiltPublisher->stop();
+    return;
+    }
+  if (this->MRMLLookingGlassViewNode->GetVirtualDevice())
+    {
+    this->QuiltPublisher->setQuiltLayout(this->MRMLLookingGlassViewNode->GetQuiltColumns(),
+      this->MRMLLookingGlassViewNode->GetQuiltRows(), this->MRMLLookingGlassViewNode->GetViewCone(),
+      this->MRMLLookingGlassViewNode->GetDisplayAspect());
+    }
+  else
+    {
+    // Quilt layout of the device is chosen by the looking glass interface
+    this->QuiltPublisher->setQuiltLayout(0, 0, 0.0, 0.0);
+    }
+  this->QuiltPublisher->start(QString::fromStdString(this->MRMLLookingGlassViewNode->GetQuiltPublishingKey()));
+}
 
-  return rate;
+//---------------------------------------------------------------------------
+void qMRMLLookingGlassViewPrivate::publishQuilt(double quiltCompletedTime)
+{
+  Q_Q(qMRMLLookingGlassView);
+  if (!this->QuiltPublisher->isPublishing())
+    {
+    return;
+    }
+  bool published = false;
+  if (this->QuiltRenderer)
+    {
+    published = this->QuiltPublisher->publishImage(this->QuiltRenderer->GetQuiltImage(), this->Renderer->GetActiveCamera());
+    }
+  else if (q->lookingGlassTnterface())
+    {
+    published = this->QuiltPublisher->publishFramebuffer(this->RenderWindow,
+      q->lookingGlassTnterface()->GetQuiltFramebuffer(), this->Renderer->GetActiveCamera());
+    }
+  if (published)
+    {
+    this->MRMLLookingGlassViewNode->GetRenderStatistics()->AddPublishedFrame(
+      vtkTimerLog::GetUniversalTime() - quiltCompletedTime);
+    }
 }
 
 // --------------------------------------------------------------------------
@@ -540,8 +2143,9 @@ void qMRMLLookingGlassView::getDisplayableManagers(vtkCollection* displayableMan
 //------------------------------------------------------------------------------
 bool qMRMLLookingGlassView::isHardwareConnected()const
 {
+  Q_D(const qMRMLLookingGlassView);
   vtkOpenGLRenderWindow* renWin = this->renderWindow();
-  if (!renWin)
+  if (!renWin || d->Suspended || !this->lookingGlassTnterface())
   {
     return false;
   }
@@ -549,6 +2153,66 @@ bool qMRMLLookingGlassView::isHardwareConnected()const
   return true;
 }
 
+//------------------------------------------------------------------------------
+bool qMRMLLookingGlassView::isVirtualDevice()const
+{
+  Q_D(const qMRMLLookingGlassView);
+  return d->RenderWindow != nullptr && d->QuiltRenderer != nullptr && !d->Suspended;
+}
+
+//------------------------------------------------------------------------------
+qMRMLLookingGlassQuiltRecorder* qMRMLLookingGlassView::quiltRecorder()const
+{
+  Q_D(const qMRMLLookingGlassView);
+  return d->QuiltRecorder;
+}
+
+//------------------------------------------------------------------------------
+qMRMLLookingGlassQuiltPublisher* qMRMLLookingGlassView::quiltPublisher()const
+{
+  Q_D(const qMRMLLookingGlassView);
+  return d->QuiltPublisher;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLLookingGlassView::startRecording(const QString& outputPath)
+{
+  Q_D(qMRMLLookingGlassView);
+  if (d->MRMLLookingGlassViewNode && d->MRMLLookingGlassViewNode->GetVirtualDevice())
+    {
+    d->QuiltRecorder->setQuiltLayout(d->MRMLLookingGlassViewNode->GetQuiltColumns(),
+      d->MRMLLookingGlassViewNode->GetQuiltRows(), d->MRMLLookingGlassViewNode->GetViewCone(),
+      d->MRMLLookingGlassViewNode->GetDisplayAspect());
+    }
+  else
+    {
+    // Quilt layout of the device is chosen by the looking glass interface
+    d->QuiltRecorder->setQuiltLayout(0, 0, 0.0, 0.0);
+    }
+  return d->QuiltRecorder->start(outputPath);
+}
+
+//------------------------------------------------------------------------------
+void qMRMLLookingGlassView::stopRecording()
+{
+  Q_D(qMRMLLookingGlassView);
+  d->QuiltRecorder->stop();
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLLookingGlassView::isRecording()const
+{
+  Q_D(const qMRMLLookingGlassView);
+  return d->QuiltRecorder->isRecording();
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLLookingGlassView::isSuspended()const
+{
+  Q_D(const qMRMLLookingGlassView);
+  return d->Suspended;
+}
+
 //---------------------------------------------------------------------------
 bool qMRMLLookingGlassView::isReferenceViewInteractive() const
 {
@@ -560,7 +2224,18 @@ bool qMRMLLookingGlassView::isReferenceViewInteractive() const
 void qMRMLLookingGlassView::setReferenceViewInteractive(bool interactive)
 {
   Q_D(qMRMLLookingGlassView);
+  if (d->ReferenceViewInteractive == interactive)
+    {
+    return;
+    }
   d->ReferenceViewInteractive = interactive;
+  if (!interactive)
+    {
+    // Camera synchronization and still renders may have been skipped
+    // during interaction
+    d->synchronizeCamera(/* force= */ true);
+    this->scheduleRender();
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -594,7 +2269,20 @@ void qMRMLLookingGlassView::updateViewFromReferenceViewCamera()
     qWarning() << Q_FUNC_INFO << " failed: looking glass camera node is not found";
     return;
     }
+  double startTime = vtkTimerLog::GetUniversalTime();
   lgCameraNode->CopyContent(cameraNode);
+  d->FramePhaseTimes[vtkMRMLLookingGlassRenderStatistics::PhaseCameraSync] +=
+    vtkTimerLog::GetUniversalTime() - startTime;
+
+  // Keep track of the synchronized camera to ignore insignificant changes
+  vtkCamera* camera = cameraNode->GetCamera();
+  camera->GetPosition(d->LastViewPosition);
+  camera->GetDirectionOfProjection(d->LastViewDirection);
+  camera->GetViewUp(d->LastViewUp);
+  if (d->LastViewUpdateTime)
+    {
+    d->LastViewUpdateTime->StartTimer();
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -606,11 +2294,20 @@ void qMRMLLookingGlassView::scheduleRender()
   //             arg(d->RenderEnabled ? "true" : "false")
   //             .arg(d->RequestTime.elapsed()));
 
-  if (!d->MRMLLookingGlassViewNode->GetActive())
+  if (!d->MRMLLookingGlassViewNode || !d->MRMLLookingGlassViewNode->GetActive())
+    {
+    return;
+    }
+
+  if (d->RenderInProgress)
     {
     return;
     }
 
+  // A new change supersedes the refinement of the previous frame
+  d->RefinementTimer.stop();
+  d->AccumulationTimer.stop();
+
   if (d->MRMLLookingGlassViewNode->GetRenderingMode() == vtkMRMLLookingGlassViewNode::RenderingModeOnlyWhenRequested)
     {
     return;
@@ -622,8 +2319,6 @@ void qMRMLLookingGlassView::scheduleRender()
     return;
     }
 
-  this->updateViewFromReferenceViewCamera();
-
   double msecsBeforeRender = 0;
   // If the MaximumUpdateRate is set to 0 then it indicates that rendering is done next time
   // the application is idle.
@@ -656,13 +2351,21 @@ void qMRMLLookingGlassView::scheduleRender()
 //----------------------------------------------------------------------------
 void qMRMLLookingGlassView::requestRender()
 {
-  Q_D(const qMRMLLookingGlassView);
+  Q_D(qMRMLLookingGlassView);
 
 //  if (this->isRenderPaused())
 //    {
 //    return;
 //    }
+  if (!d->RenderTurn && qMRMLLookingGlassViewPrivate::numberOfRenderingViews() > 1)
+    {
+    // Several devices are rendering, wait for the turn of this one
+    d->queueRender();
+    return;
+    }
+  d->RenderInProgress = true;
   this->forceRender();
+  d->RenderInProgress = false;
 }
 
 //----------------------------------------------------------------------------
@@ -690,7 +2393,114 @@ void qMRMLLookingGlassView::forceRender()
     {
     return;
     }
-  d->RenderWindow->Render();
+
+  if (d->QuiltRenderInProgress)
+    {
+    // Camera of the quilt being rendered is fixed, render again with the
+    // latest changes when the quilt is completed.
+    d->QuiltRenderPending = true;
+    return;
+    }
+
+  vtkMRMLLookingGlassRenderStatistics* statistics = d->MRMLLookingGlassViewNode->GetRenderStatistics();
+
+  // Jittered frame of the temporal accumulation of an unchanged quilt
+  bool accumulationFrame = d->AccumulationFramePending && !d->isRenderStateModified();
+  d->AccumulationFramePending = false;
+
+  if (d->isRenderStateModified())
+    {
+    d->startProgressiveRefinement();
+    }
+  else
+    {
+    // Nothing changed since the coarse frame, refine it
+    d->RefinementTimer.stop();
+    d->RefinementQuality = 1.0;
+    }
+
+  // Switching between reduced and full quality modifies the render window,
+  // so the first frame after the interaction ends or the refinement of a
+  // coarse frame is rendered in full quality.
+  d->updateRenderQuality();
+  d->updateVolumeRenderingQuality();
+
+  // Rendering the quilt is expensive, skip it if nothing changed since the last render
+  bool renderStateChanged = d->isRenderStateModified();
+  if (!renderStateChanged && !accumulationFrame)
+    {
+    statistics->AddSkippedFrame();
+    return;
+    }
+
+  d->FramePhaseTimes[vtkMRMLLookingGlassRenderStatistics::PhaseDisplayableManagerUpdate] = 0.0;
+  d->FramePhaseTimes[vtkMRMLLookingGlassRenderStatistics::PhaseQuiltRender] = 0.0;
+  d->FrameTileCount = 0;
+  d->FrameRenderTime = 0.0;
+
+  if (d->QuiltCuller)
+    {
+    // Display aspect of the device is the aspect of its render window,
+    // a wide aspect is used until the window is sized as it culls less.
+    int* windowSize = d->RenderWindow->GetSize();
+    d->QuiltCuller->SetDisplayAspect(d->QuiltRenderer ? d->QuiltRenderer->GetDisplayAspect()
+      : (windowSize[0] > 0 && windowSize[1] > 0 ? static_cast<double>(windowSize[0]) / windowSize[1] : 16.0 / 9.0));
+    d->QuiltCuller->BeginQuilt(d->Renderer);
+    }
+
+  if (d->QuiltRenderer)
+    {
+    // The Adaptive rendering mode synthesizes more views and renders
+    // smaller tiles to hold the desired update rate, coarse frames of the
+    // progressive refinement synthesize more views. At most viewFraction
+    // of the views are rendered.
+    double viewFraction = d->renderQuality(vtkSlicerLookingGlassFrameTimeController::KnobViewCount);
+    double tileScale = d->renderQuality(vtkSlicerLookingGlassFrameTimeController::KnobTileResolution);
+    int keyViewInterval = viewFraction < 1.0
+      ? static_cast<int>(std::ceil(1.0 / std::max(viewFraction, 0.01) - 1e-6)) : 1;
+    d->QuiltRenderer->SetKeyViewInterval(std::max(d->KeyViewInterval, keyViewInterval));
+    int* tileSize = d->MRMLLookingGlassViewNode->GetTileSize();
+    d->QuiltRenderer->SetTileSize(
+      std::max(1, static_cast<int>(std::floor(tileSize[0] * tileScale + 0.5))),
+      std::max(1, static_cast<int>(std::floor(tileSize[1] * tileScale + 0.5))));
+    d->QuiltRenderer->SetMaximumDisocclusionRatio(d->MaximumDisocclusionRatio);
+    d->updateTemporalAccumulation(accumulationFrame && !renderStateChanged);
+    if (!d->QuiltRenderer->BeginQuilt())
+      {
+      return;
+      }
+    if (!d->renderQuiltSlice())
+      {
+      // Frame is completed by the next slices
+      return;
+      }
+    }
+  else
+    {
+    double startTime = vtkTimerLog::GetUniversalTime();
+    d->RenderWindow->Render();
+    d->FrameRenderTime = vtkTimerLog::GetUniversalTime() - startTime;
+    }
+
+  d->endFrame();
+}
+
+//----------------------------------------------------------------------------
+double qMRMLLookingGlassView::interactiveQuality()const
+{
+  Q_D(const qMRMLLookingGlassView);
+  return d->InteractiveQuality;
+}
+
+//----------------------------------------------------------------------------
+unsigned long qMRMLLookingGlassView::skippedFrameCount()const
+{
+  Q_D(const qMRMLLookingGlassView);
+  if (!d->MRMLLookingGlassViewNode)
+    {
+    return 0;
+    }
+  return d->MRMLLookingGlassViewNode->GetRenderStatistics()->GetNumberOfSkippedFrames();
 }
 
 ////----------------------------------------------------------------------------
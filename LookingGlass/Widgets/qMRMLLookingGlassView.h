@@ -33,12 +33,16 @@
 // CTK includes
 #include <ctkVTKObject.h> 
 
+class qMRMLLookingGlassQuiltPublisher;
+class qMRMLLookingGlassQuiltRecorder;
 class qMRMLLookingGlassViewPrivate;
 class vtkMRMLLookingGlassViewNode;
 class vtkCollection;
 class vtkGenericOpenGLRenderWindow;
+class vtkImageData;
 class vtkRenderWindowInteractor;
 class vtkSlicerCamerasModuleLogic;
+class vtkSlicerLookingGlassLogic;
 
 class vtkLookingGlassInterface;
 //class vtkOpenVRRenderer;
@@ -58,6 +62,12 @@ class Q_SLICER_MODULE_LOOKINGGLASS_WIDGETS_EXPORT qMRMLLookingGlassView : public
   Q_OBJECT
   QVTK_OBJECT
   Q_PROPERTY(bool referenceViewInteractive READ isReferenceViewInteractive WRITE setReferenceViewInteractive)
+  Q_PROPERTY(double cameraSyncTranslationThreshold READ cameraSyncTranslationThreshold WRITE setCameraSyncTranslationThreshold)
+  Q_PROPERTY(double cameraSyncRotationThreshold READ cameraSyncRotationThreshold WRITE setCameraSyncRotationThreshold)
+  Q_PROPERTY(double cameraSyncMinimumInterval READ cameraSyncMinimumInterval WRITE setCameraSyncMinimumInterval)
+  Q_PROPERTY(bool progressiveRefinement READ progressiveRefinement WRITE setProgressiveRefinement)
+  Q_PROPERTY(int keyViewInterval READ keyViewInterval WRITE setKeyViewInterval)
+  Q_PROPERTY(double maximumDisocclusionRatio READ maximumDisocclusionRatio WRITE setMaximumDisocclusionRatio)
 public:
   /// Superclass typedef
   typedef QWidget Superclass;
@@ -72,9 +82,9 @@ public:
   /// If you want to register a displayable manager with all the 3D
   /// views (existing or future), you need to do it via
   /// vtkMRMLLookingGlassViewDisplayableManagerFactory::RegisterDisplayableManager()
-  /// By default: vtkMRMLCameraDisplayableManager,
-  /// vtkMRMLViewDisplayableManager and vtkMRMLModelDisplayableManager are
-  /// already registered.
+  /// The displayable managers of the view node
+  /// (see vtkMRMLLookingGlassViewNode::SetDisplayableManagers()) are
+  /// instantiated when a node they display is first in the scene.
   void addDisplayableManager(const QString& displayableManager);
   Q_INVOKABLE void getDisplayableManagers(vtkCollection *displayableManagers);
 
@@ -83,6 +93,11 @@ public:
   void setCamerasLogic(vtkSlicerCamerasModuleLogic* camerasLogic);
   vtkSlicerCamerasModuleLogic* camerasLogic()const;
 
+  /// Set LookingGlass module logic.
+  /// Required for controlling the volume rendering quality of the view.
+  void setLookingGlassLogic(vtkSlicerLookingGlassLogic* lookingGlassLogic);
+  vtkSlicerLookingGlassLogic* lookingGlassLogic()const;
+
   /// Get the 3D View node observed by view.
   Q_INVOKABLE vtkMRMLLookingGlassViewNode* mrmlLookingGlassViewNode()const;
 
@@ -93,8 +108,14 @@ public:
   Q_INVOKABLE vtkOpenGLRenderWindow* renderWindow()const;
 
   /// Get LookingGlass interface
+  /// Return nullptr if the view is not connected to a device.
   Q_INVOKABLE vtkLookingGlassInterface* lookingGlassTnterface()const;
 
+  /// Get the last rendered quilt when rendering for a virtual device.
+  /// Return nullptr if the view renders on a looking glass device.
+  /// \sa vtkMRMLLookingGlassViewNode::GetVirtualDevice
+  Q_INVOKABLE vtkImageData* quiltImage()const;
+
   /// Get underlying RenderWindow interactor
   Q_INVOKABLE vtkRenderWindowInteractor* interactor()const;
 
@@ -102,9 +123,71 @@ public:
   /// matched the camera of the reference view camera.
   Q_INVOKABLE void updateViewFromReferenceViewCamera();
 
-  /// Get underlying RenderWindow
+  /// Minimum displacement of the reference view camera position (in mm)
+  /// that is propagated to the looking glass camera.
+  /// Default is 0.5mm.
+  void setCameraSyncTranslationThreshold(double threshold);
+  double cameraSyncTranslationThreshold()const;
+
+  /// Minimum rotation of the reference view camera direction or view up
+  /// (in degrees) that is propagated to the looking glass camera.
+  /// Default is 0.5 degrees.
+  void setCameraSyncRotationThreshold(double threshold);
+  double cameraSyncRotationThreshold()const;
+
+  /// Minimum time (in seconds) between two synchronizations of the looking
+  /// glass camera with the reference view camera.
+  /// Default is 0.05s.
+  void setCameraSyncMinimumInterval(double interval);
+  double cameraSyncMinimumInterval()const;
+
+  /// If enabled and a full quality quilt takes longer to render than
+  /// 1/DesiredUpdateRate, each change is first rendered with reduced quality
+  /// (shown immediately) and the full quality quilt is rendered next time the
+  /// application is idle. A new change cancels the pending refinement.
+  /// The reduced quality quilt of the virtual device renders a subset of the
+  /// views and synthesizes the others, the device cannot skip views and
+  /// renders them with a lower desired update rate and fewer peels.
+  /// Enabled by default.
+  void setProgressiveRefinement(bool enable);
+  bool progressiveRefinement()const;
+
+  /// Render only every keyViewInterval-th view of the virtual device quilt
+  /// (and the last one) with color and depth, and synthesize the views in
+  /// between by depth-based reprojection of the surrounding rendered views.
+  /// Synthesized views with more than maximumDisocclusionRatio of pixels
+  /// not visible in the rendered views are rendered instead.
+  /// 1 means all the views are rendered, which is the default. A
+  /// maximumDisocclusionRatio of 0 renders all the views as well, including
+  /// in coarse frames.
+  /// \sa vtkSlicerLookingGlassQuiltRenderer::SetKeyViewInterval
+  void setKeyViewInterval(int interval);
+  int keyViewInterval()const;
+  void setMaximumDisocclusionRatio(double ratio);
+  double maximumDisocclusionRatio()const;
+
+  /// Return true if the view renders on a looking glass device.
   Q_INVOKABLE bool isHardwareConnected()const;
 
+  /// Return true if the view renders the quilt offscreen for a virtual device.
+  Q_INVOKABLE bool isVirtualDevice()const;
+
+  /// Return true if the view is hidden but its render window, displayable
+  /// managers and GPU resources are kept for a fast reconnection.
+  /// \sa vtkMRMLLookingGlassViewNode::SetSuspendedResourcesTimeout
+  Q_INVOKABLE bool isSuspended()const;
+
+  /// Recorder capturing every rendered quilt while recording.
+  /// Output format, writer threads and drop policy are set on the recorder.
+  Q_INVOKABLE qMRMLLookingGlassQuiltRecorder* quiltRecorder()const;
+
+  Q_INVOKABLE bool isRecording()const;
+
+  /// Publisher of the rendered quilts to shared memory.
+  /// Publishing is enabled from the view node.
+  /// \sa vtkMRMLLookingGlassViewNode::SetQuiltPublishing
+  Q_INVOKABLE qMRMLLookingGlassQuiltPublisher* quiltPublisher()const;
+
   /// Indicate if reference view is being interacted with
   bool isReferenceViewInteractive() const;
 
@@ -114,6 +197,18 @@ public:
   /// on vtkCommand::StartInteractionEvent and vtkCommand::EndInteractionEvent
   void setReferenceViewInteractive(bool interactive);
 
+  /// Number of renders skipped because neither the view node, the camera,
+  /// nor any of the displayed props changed since the last render, and no
+  /// displayable manager requested a render.
+  /// \sa vtkMRMLLookingGlassViewNode::GetRenderStatistics
+  Q_INVOKABLE unsigned long skippedFrameCount()const;
+
+  /// Quality level used for rendering while the reference view is
+  /// interacted with, in the [0.1, 1] range. 1 means full quality.
+  /// It is adapted from measured frame times to meet the desired update rate.
+  /// \sa vtkMRMLLookingGlassViewNode::GetReduceQualityDuringInteraction
+  Q_INVOKABLE double interactiveQuality()const;
+
 public slots:
   /// Set the current \a viewNode to observe
   void setMRMLLookingGlassViewNode(vtkMRMLLookingGlassViewNode* newViewNode);
@@ -121,17 +216,28 @@ public slots:
   void pushFocalPlaneBack();
   void pullFocalPlaneForward();
 
+  /// Record the rendered quilts to \a outputPath, a directory for image
+  /// sequences or a video file. Return false if the output cannot be created.
+  /// \sa quiltRecorder
+  bool startRecording(const QString& outputPath);
+  void stopRecording();
+
   /// Notify that the view needs to be rendered.
   /// scheduleRender() respects the maximum update rate of the view,
   /// it won't render the window more frequently than what the maximum
   /// update rate is.
+  ///
+  /// The view does not render continuously: a render is scheduled only when
+  /// the view node, the looking glass or reference camera node is modified,
+  /// or when a displayable manager requests it.
   /// \sa setMaximumUpdateRate
   virtual void scheduleRender();
 
   /// Force a render even if a render is already ocurring
   /// Be careful when calling forceRender() as it can slow down your
   /// application. It is preferable to use scheduleRender() instead.
-  /// \sa scheduleRender
+  /// The render is skipped if nothing changed since the last render.
+  /// \sa scheduleRender, skippedFrameCount
   virtual void forceRender();
 
   /// Set maximum rate for rendering (in frames per second).
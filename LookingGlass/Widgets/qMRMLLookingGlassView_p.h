@@ -43,13 +43,25 @@
 // qMRML includes
 #include "qMRMLLookingGlassView.h"
 
+// LookingGlass MRML includes
+#include "vtkMRMLLookingGlassRenderStatistics.h"
+
 // Qt includes
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QStringList>
 #include <QTime>
 #include <QTimer>
 
 class QLabel;
+class qMRMLLookingGlassQuiltPublisher;
+class qMRMLLookingGlassQuiltRecorder;
+class qMRMLThreeDView;
 class vtkMRMLCameraNode;
 class vtkMRMLDisplayableManagerGroup;
+class vtkMRMLNode;
+class vtkMRMLScene;
 class vtkMRMLTransformNode;
 class vtkMRMLLookingGlassViewNode;
 class vtkObject;
@@ -58,7 +70,16 @@ class vtkObject;
 class vtkTimerLog;
 class vtkLookingGlassViewInteractor;
 class vtkLookingGlassViewInteractorStyle;
+class vtkGPUVolumeRayCastMapper;
+class vtkInteractorStyle;
 class vtkMRMLThreeDViewInteractorStyle;
+class vtkSlicerLookingGlassFrameTimeController;
+class vtkSlicerLookingGlassLODCache;
+class vtkSlicerLookingGlassLogic;
+class vtkSlicerLookingGlassPassTimer;
+class vtkSlicerLookingGlassQuiltCuller;
+class vtkSlicerLookingGlassQuiltRenderer;
+class vtkTextActor;
 
 
 //-----------------------------------------------------------------------------
@@ -80,16 +101,247 @@ public:
 
   double desiredUpdateRate();
 
+  /// Return true if frames are rendered with reduced quality because the
+  /// reference view is interacted with.
+  /// \sa vtkMRMLLookingGlassViewNode::GetReduceQualityDuringInteraction
+  bool isInteractiveQualityReduced();
+
+  /// Return the quality level of the next frame, in the [0.1, 1] range.
+  /// It is reduced during interaction and for coarse frames of the
+  /// progressive refinement of the device. Coarse frames of the virtual
+  /// device reduce the number of rendered views instead.
+  double renderQuality();
+
+  /// Return true if the view node uses the Adaptive rendering mode.
+  bool isAdaptive();
+
+  /// Return the quality level of \a knob for the next frame: the level set
+  /// by the frame time controller in the Adaptive rendering mode, otherwise
+  /// renderQuality() for geometry and volumes, the refinement quality for
+  /// the view count of the virtual device and 1 for the tile resolution.
+  /// \sa vtkSlicerLookingGlassFrameTimeController
+  double renderQuality(int knob);
+
+  /// Set render window desired update rate and depth peeling parameters
+  /// according to the rendering mode, the interaction state and the
+  /// current interactive quality level.
+  void updateRenderQuality();
+
+  /// Get the volume rendering oversampling factor of the next frame from
+  /// the looking glass logic. The view node is not modified.
+  /// \sa vtkSlicerLookingGlassLogic::GetVolumeRenderingOversamplingFactor
+  void updateVolumeRenderingQuality();
+
+  /// Set the sample distance of the GPU volume mappers of the renderer from
+  /// the oversampling factor of the frame. Called for each tile after the
+  /// displayable managers are updated, mappers are only modified if the
+  /// factor, the volume or the mapper changed since they were last set.
+  /// \sa AppliedSampleDistances
+  void applyVolumeSampleDistances();
+
+  /// Adjust the interactive quality level so that frames rendered during
+  /// interaction take about 1/DesiredUpdateRate seconds.
+  void adaptInteractiveQuality(double frameTime);
+
+  /// Let the frame time controller adjust the quality knobs of the Adaptive
+  /// rendering mode so that frames take about 1/DesiredUpdateRate seconds,
+  /// and record its adjustments in the render statistics.
+  void adaptRenderQuality(double frameTime);
+
+  /// Choose the quality of the first frame rendered after a change.
+  /// If full quality frames cannot be rendered at the desired update rate,
+  /// a coarse frame is rendered first and refined when the application is idle.
+  /// The coarse frame of the virtual device renders every n-th view and
+  /// synthesizes the others (see vtkSlicerLookingGlassQuiltRenderer::SetKeyViewInterval).
+  /// The device renders all the views of its quilt itself, its coarse frame
+  /// is rendered with a lower desired update rate and fewer peels.
+  void startProgressiveRefinement();
+
+  /// Render tiles of the virtual device quilt for at most the quilt render
+  /// time slice of the view node. Render requests received meanwhile are
+  /// processed once the quilt is completed.
+  /// Return true if the quilt is complete, otherwise the next slice is scheduled.
+  /// \sa vtkMRMLLookingGlassViewNode::GetQuiltRenderTimeSlice
+  bool renderQuiltSlice();
+
+  /// Enable the temporal accumulation of the quilt renderer as requested by
+  /// the view node. If \a accumulationFrame is true then the next quilt is
+  /// rendered with the jitter of the next accumulated frame, otherwise the
+  /// accumulation restarts from the next quilt.
+  void updateTemporalAccumulation(bool accumulationFrame);
+
+  /// Schedule the next jittered frame if the quilt of the unchanged scene
+  /// has accumulated fewer frames than requested by the view node.
+  void continueTemporalAccumulation();
+
+  /// Render the large models with decimated proxies fitting the interactive
+  /// triangle budget of the view node if the render quality is reduced.
+  /// Called for each tile after the displayable managers updated the actors,
+  /// restoreFullDetail() is called at the end of the tile.
+  void applyLevelOfDetail();
+  void restoreFullDetail();
+
+  /// Record the statistics of the rendered frame and update the rendering
+  /// quality of the next frames.
+  void endFrame();
+
+  /// Capture the rendered quilt if recording
+  void recordQuilt();
+
+  /// Start or stop publishing the quilts to shared memory as requested by
+  /// the view node.
+  void updateQuiltPublishing();
+
+  /// Publish the rendered quilt to shared memory if publishing and record
+  /// the publish latency from \a quiltCompletedTime.
+  void publishQuilt(double quiltCompletedTime);
+
+  /// Copy the reference view camera to the looking glass camera if it moved
+  /// more than the translation or rotation threshold and if the minimum
+  /// update interval elapsed since the last synchronization.
+  /// If \a force is true then thresholds and update interval are ignored.
+  void synchronizeCamera(bool force = false);
+
 public slots:
   void updateWidgetFromMRML();
 
+protected slots:
+  void onReferenceCameraModified();
+
+  /// Track the interaction in the reference view of this view
+  void onReferenceViewStartInteraction();
+  void onReferenceViewEndInteraction();
+
+  /// Instantiate the pending displayable managers displaying the added node
+  void onSceneNodeAdded(vtkObject* scene, vtkObject* node);
+
+  /// Schedule a render that is not skipped, even if the render state is
+  /// unchanged: displayable managers request a render before updating
+  /// their props.
+  void onRenderRequested();
+
+  /// Render the full quality frame replacing the coarse frame
+  void onRefinementTimeout();
+
+  /// Render the next jittered frame of the temporal accumulation
+  void onAccumulationTimeout();
+
+  /// Continue rendering the quilt started by the last render
+  void onQuiltSliceTimeout();
+
+  /// Release the render resources kept since the view was hidden
+  void onEvictionTimeout();
+
+  /// Measure displayable manager update and tile rendering time.
+  /// Displayable managers update from MRML when the renderer starts rendering,
+  /// onRendererStartEvent() is called before and onRendererStartEventProcessed() after them.
+  void onRendererStartEvent();
+  void onRendererStartEventProcessed();
+  void onRendererEndEvent();
+
 protected:
+  /// Create the device or virtual device render window, without renderer.
+  void newRenderWindow();
   void createRenderWindow();
   void destroyRenderWindow();
 
+  /// Cancel the scheduled renders, refinement and quilt slices.
+  void stopPendingRenders();
+
+  /// Stop rendering but keep the render window, displayable managers and
+  /// GPU resources, so that showing the view again is fast. The resources
+  /// are released after the suspended resources timeout of the view node.
+  void suspendRenderWindow();
+  void resumeRenderWindow();
+
+  /// Return true if the resources of the hidden view can be kept according
+  /// to the suspended resources timeout and memory limit of the view node.
+  bool canKeepSuspendedResources();
+
+  /// Estimate the size (in MB) of the data rendered in the view, i.e. the
+  /// input of the mappers of the renderer props.
+  double estimatedRenderedDataSize();
+
+  /// Observe the looking glass and reference view camera nodes so that
+  /// camera changes schedule a render, and the interactor style of the
+  /// reference view so that its interaction sets referenceViewInteractive.
+  void updateCameraNodeObservations();
+
+  /// Update the list of displayable managers to instantiate from the view
+  /// node. Return false if a displayable manager already instantiated has
+  /// been removed from the list, the render window must be recreated then.
+  bool updatePendingDisplayableManagers();
+
+  /// Instantiate the pending displayable managers that display \a addedNode,
+  /// or any node of the scene if \a addedNode is nullptr. Displayable managers
+  /// that do not display a specific node type are instantiated immediately.
+  void instantiatePendingDisplayableManagers(vtkMRMLNode* addedNode = nullptr);
+
+  /// Return true if the reference camera moved more than the synchronization
+  /// thresholds since the last synchronization.
+  bool isReferenceCameraChangeSignificant();
+
+  /// Return the most recent modification time of everything that affects
+  /// the rendered quilt: view node, camera, renderer and its view props.
+  vtkMTimeType renderStateMTime();
+
+  /// Return true if the render state changed since the last render or if
+  /// a render has been requested since then.
+  /// \sa renderStateMTime, RenderRequested
+  bool isRenderStateModified();
+
+  /// Return the render window of another view of the same kind (device or
+  /// virtual device), whose OpenGL context is shared by the new render window
+  /// so that textures, buffers and shader programs are not duplicated.
+  vtkOpenGLRenderWindow* sharedRenderWindow();
+
+  /// Return the reference 3D view, nullptr if it is not displayed.
+  qMRMLThreeDView* referenceView();
+
+  /// Return the render window of the reference 3D view, nullptr if the
+  /// reference view is not displayed.
+  vtkOpenGLRenderWindow* referenceRenderWindow();
+
+  /// Show the mean GPU pass times of the render statistics in the reference
+  /// view if requested by the view node, otherwise remove the overlay.
+  void updateGPUTimingOverlay();
+
+  /// Update the graphics memory of the render statistics: the data rendered
+  /// in the view whose buffers are shared with the reference view, and the
+  /// data uploaded for this view only.
+  void updateGraphicsMemoryStatistics();
+
+  /// Return the number of views displaying an active and visible view node.
+  static int numberOfRenderingViews();
+
+  /// Wait for the turn of the view to render. Views render one frame per
+  /// turn, in the order of the requests, so that each device gets its share
+  /// of the frame time when several devices are rendering.
+  void queueRender();
+  static void renderNextQueuedView();
+
+  /// All the views, in creation order
+  static QList<qMRMLLookingGlassView*> Views;
+  /// Views waiting for their turn to render
+  static QList<qMRMLLookingGlassView*> RenderQueue;
+  static bool RenderTurnScheduled;
+  /// Set while the view renders in its turn
+  bool RenderTurn;
+  /// Sharing of the reference view context requested when the render
+  /// window was created
+  bool ReferenceViewContextRequested;
+  /// Render window of the reference view whose OpenGL objects are shared
+  /// by the render window, nullptr if the contexts are not shared.
+  vtkWeakPointer<vtkOpenGLRenderWindow> SharedReferenceRenderWindow;
+
   vtkSlicerCamerasModuleLogic* CamerasLogic;
+  vtkSlicerLookingGlassLogic* LookingGlassLogic;
 
   vtkSmartPointer<vtkMRMLDisplayableManagerGroup> DisplayableManagerGroup;
+  /// Displayable managers of the view node, instantiated or not yet
+  QStringList InstantiatedDisplayableManagers;
+  QStringList PendingDisplayableManagers;
+  vtkWeakPointer<vtkMRMLScene> ObservedScene;
   vtkWeakPointer<vtkMRMLLookingGlassViewNode> MRMLLookingGlassViewNode;
   vtkSmartPointer<vtkRenderer> Renderer;
   vtkSmartPointer<vtkOpenGLRenderWindow> RenderWindow;
@@ -100,18 +352,122 @@ protected:
   //vtkSmartPointer<vtkOpenVRInteractorStyle> InteractorStyle; //TODO: For debugging the original interactor
   vtkSmartPointer<vtkCamera> Camera;
 
+  /// Renders the quilt offscreen when the view node uses a virtual device
+  vtkSmartPointer<vtkSlicerLookingGlassQuiltRenderer> QuiltRenderer;
+  /// Culls the props and computes the clipping range once for all the views
+  vtkSmartPointer<vtkSlicerLookingGlassQuiltCuller> QuiltCuller;
+  /// Decimated proxies of the large models rendered during interaction
+  vtkSmartPointer<vtkSlicerLookingGlassLODCache> LODCache;
+  /// Adjusts the quality knobs in the Adaptive rendering mode
+  vtkSmartPointer<vtkSlicerLookingGlassFrameTimeController> FrameTimeController;
+  /// Measures the GPU time of the render passes
+  vtkSmartPointer<vtkSlicerLookingGlassPassTimer> PassTimer;
+  /// Displays the GPU pass times in the reference view
+  vtkSmartPointer<vtkTextActor> GPUTimingOverlayActor;
+  QPointer<qMRMLThreeDView> GPUTimingOverlayView;
+
+  vtkWeakPointer<vtkMRMLCameraNode> CameraNode;
+  vtkWeakPointer<vtkMRMLCameraNode> ReferenceCameraNode;
+  vtkWeakPointer<vtkInteractorStyle> ReferenceInteractorStyle;
+
   vtkSmartPointer<vtkTimerLog> LastViewUpdateTime;
   double LastViewDirection[3];
   double LastViewUp[3];
   double LastViewPosition[3];
 
+  double CameraSyncTranslationThreshold;
+  double CameraSyncRotationThreshold;
+  double CameraSyncMinimumInterval;
+
+  /// Synchronizes the camera when a change is throttled by the minimum interval
+  QTimer CameraSyncTimer;
+
   bool ReferenceViewInteractive;
 
   // Copied from ctkVTKAbstractViewPrivate
   QTimer*                                       RequestTimer;
   QTime                                         RequestTime;
 
-  QTimer LookingGlassLoopTimer;
+  /// Set while a requested render is in progress. Render requests emitted
+  /// while rendering (e.g. camera synchronization) are ignored as the
+  /// ongoing render already takes them into account.
+  bool RenderInProgress;
+
+  /// Render state modification time at the end of the last render.
+  /// \sa renderStateMTime
+  vtkMTimeType LastRenderedStateMTime;
+
+  /// Set when a displayable manager or the interactor requests a render,
+  /// cleared when the frame is rendered. Displayable managers apply their
+  /// pending updates in the renderer StartEvent, so the requested render
+  /// must not be skipped although no prop has been modified yet.
+  bool RenderRequested;
+
+  /// Time spent in each phase of the current frame.
+  /// \sa vtkMRMLLookingGlassRenderStatistics
+  double FramePhaseTimes[vtkMRMLLookingGlassRenderStatistics::Phase_Last];
+  double RendererStartTime;
+  double TileRenderStartTime;
+
+  /// Number of renderer passes (one per quilt tile) counted in the current frame
+  int FrameTileCount;
+  /// Number of renderer passes measured in the last rendered frame
+  int NumberOfTilesPerFrame;
+
+  /// Quality level used during interaction, in the [MinimumInteractiveQuality, 1] range.
+  /// It is kept between interactions as the scene complexity rarely changes.
+  double InteractiveQuality;
+  /// Depth peeling setting of the renderer used for full quality frames
+  int FullQualityMaximumNumberOfPeels;
+
+  bool ProgressiveRefinement;
+  /// Quality level of the still frame being rendered, 1 once refined.
+  double RefinementQuality;
+  /// Duration of the last frame rendered with full quality
+  double LastFullQualityFrameTime;
+  /// Volume rendering oversampling factor of the frame being rendered,
+  /// 0 if the sample distances of the volume mappers are not modified.
+  double VolumeOversamplingFactor;
+  /// Oversampling factor last applied to a volume mapper and the time its
+  /// volume, input and mapper were last modified, including by the factor.
+  struct AppliedSampleDistance
+  {
+    double OversamplingFactor;
+    vtkMTimeType MTime;
+  };
+  /// Sample distances applied to the volume mappers of the renderer
+  QHash<vtkGPUVolumeRayCastMapper*, AppliedSampleDistance> AppliedSampleDistances;
+  /// Triggers the refinement render when the application is idle
+  QTimer RefinementTimer;
+
+  /// Triggers the rendering of the next jittered frame when the application is idle
+  QTimer AccumulationTimer;
+  /// Set when the next render is a jittered frame of the temporal accumulation
+  bool AccumulationFramePending;
+
+  /// Set while the tiles of a quilt are rendered in several slices
+  bool QuiltRenderInProgress;
+  /// Set if a render is requested while a quilt is being rendered
+  bool QuiltRenderPending;
+  /// Interval between the rendered views of the virtual device quilt,
+  /// the views in between are synthesized
+  int KeyViewInterval;
+  double MaximumDisocclusionRatio;
+  /// Time spent rendering the current frame, excluding event processing
+  /// between quilt slices
+  double FrameRenderTime;
+  /// Triggers the rendering of the next quilt slice
+  QTimer QuiltSliceTimer;
+
+  /// Records the rendered quilts
+  qMRMLLookingGlassQuiltRecorder* QuiltRecorder;
+  /// Publishes the rendered quilts to shared memory
+  qMRMLLookingGlassQuiltPublisher* QuiltPublisher;
+
+  /// Set while the view is hidden and its render resources are kept
+  bool Suspended;
+  /// Releases the render resources of the suspended view
+  QTimer EvictionTimer;
 };
 
 #endif
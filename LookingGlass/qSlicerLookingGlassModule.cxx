@@ -19,6 +19,9 @@
 #include <QAction>
 #include <QApplication>
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QList>
 #include <QMainWindow>
 #include <QMenu>
 #include <QSettings>
@@ -68,11 +71,19 @@ public:
   /// Adds Looking Glass view widget
   void addViewWidget();
 
+  /// Creates a view widget rendering to a looking glass device
+  qMRMLLookingGlassView* createViewWidget(const QString& objectName);
+
+  /// Adds or removes the view widgets of the devices other than the active
+  /// one, so that there is one view widget per looking glass view node.
+  void updateDeviceViewWidgets();
+
   QToolBar* ToolBar;
   QAction* LookingGlassToggleAction;
   QAction* UpdateViewFromReferenceViewCameraAction;
   QAction* ConfigureAction;
   qMRMLLookingGlassView* LookingGlassViewWidget;
+  QList<qMRMLLookingGlassView*> DeviceViewWidgets;
   QAction* Spacer;
 };
 
@@ -86,27 +97,71 @@ vtkSlicerLookingGlassLogic* qSlicerLookingGlassModulePrivate::logic()
 //-----------------------------------------------------------------------------
 void qSlicerLookingGlassModulePrivate::addViewWidget()
 {
-  Q_Q(qSlicerLookingGlassModule);
-
   if (this->LookingGlassViewWidget != nullptr)
     {
     return;
     }
 
-  this->LookingGlassViewWidget = new qMRMLLookingGlassView();
-  this->LookingGlassViewWidget->setObjectName(QString("LookingGlassWidget"));
+  this->LookingGlassViewWidget = this->createViewWidget(QString("LookingGlassWidget"));
+}
+
+//-----------------------------------------------------------------------------
+qMRMLLookingGlassView* qSlicerLookingGlassModulePrivate::createViewWidget(const QString& objectName)
+{
+  qMRMLLookingGlassView* viewWidget = new qMRMLLookingGlassView();
+  viewWidget->setObjectName(objectName);
+  viewWidget->setLookingGlassLogic(this->logic());
 
   qSlicerAbstractCoreModule* camerasModule =
     qSlicerCoreApplication::application()->moduleManager()->module("Cameras");
   if (camerasModule)
     {
     vtkSlicerCamerasModuleLogic* camerasLogic = vtkSlicerCamerasModuleLogic::SafeDownCast(camerasModule->logic());
-    this->LookingGlassViewWidget->setCamerasLogic(camerasLogic);
+    viewWidget->setCamerasLogic(camerasLogic);
     }
   else
     {
     qWarning() << "Cameras module is not found";
     }
+  return viewWidget;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerLookingGlassModulePrivate::updateDeviceViewWidgets()
+{
+  vtkSlicerLookingGlassLogic* logic = this->logic();
+  QList<vtkMRMLLookingGlassViewNode*> viewNodes;
+  for (int n = 0; n < logic->GetNumberOfLookingGlassViewNodes(); ++n)
+    {
+    vtkMRMLLookingGlassViewNode* viewNode = logic->GetNthLookingGlassViewNode(n);
+    if (viewNode != logic->GetLookingGlassViewNode())
+      {
+      viewNodes << viewNode;
+      }
+    }
+
+  // Remove the view widgets of the removed view nodes
+  foreach (qMRMLLookingGlassView* viewWidget, this->DeviceViewWidgets)
+    {
+    vtkMRMLLookingGlassViewNode* viewNode = viewWidget->mrmlLookingGlassViewNode();
+    if (viewNodes.contains(viewNode))
+      {
+      viewNodes.removeOne(viewNode);
+      continue;
+      }
+    this->DeviceViewWidgets.removeOne(viewWidget);
+    delete viewWidget;
+    }
+
+  // Each device renders in its own view widget
+  foreach (vtkMRMLLookingGlassViewNode* viewNode, viewNodes)
+    {
+    qMRMLLookingGlassView* viewWidget =
+      this->createViewWidget(QString("LookingGlassWidget%1").arg(viewNode->GetDeviceIndex()));
+    logic->SetDefaultReferenceView(viewNode);
+    viewWidget->setMRMLLookingGlassViewNode(viewNode);
+    this->DeviceViewWidgets << viewWidget;
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -237,6 +292,7 @@ qSlicerLookingGlassModulePrivate::~qSlicerLookingGlassModulePrivate()
     {
     delete this->LookingGlassViewWidget;
     }
+  qDeleteAll(this->DeviceViewWidgets);
 }
 
 //-----------------------------------------------------------------------------
@@ -302,11 +358,21 @@ void qSlicerLookingGlassModule::setup()
 
   this->Superclass::setup();
 
+  // Linked shader programs are cached in the settings directory, before the
+  // view widget creates its render window.
+  vtkSlicerLookingGlassLogic* vrLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
+  QSettings settings;
+  if (settings.value("LookingGlass/ShaderCache", true).toBool())
+    {
+    QString shaderCacheDir = QFileInfo(qSlicerCoreApplication::application()->slicerUserSettingsFilePath()).absolutePath()
+      + "/LookingGlass/ShaderCache";
+    vrLogic->SetShaderCacheDirectory(QDir(shaderCacheDir).absolutePath().toStdString());
+    }
+
   d->addToolBar();
   d->addViewWidget();
 
   // Set volume rendering logic to LookingGlass logic
-  vtkSlicerLookingGlassLogic* vrLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
   qSlicerAbstractCoreModule* volumeRenderingModule =
     qSlicerCoreApplication::application()->moduleManager()->module("VolumeRendering");
   if (volumeRenderingModule)
@@ -364,6 +430,28 @@ qMRMLLookingGlassView* qSlicerLookingGlassModule::viewWidget()
   return d->LookingGlassViewWidget;
 }
 
+// --------------------------------------------------------------------------
+qMRMLLookingGlassView* qSlicerLookingGlassModule::viewWidgetForNode(vtkMRMLLookingGlassViewNode* viewNode)
+{
+  Q_D(qSlicerLookingGlassModule);
+  if (!viewNode)
+    {
+    return nullptr;
+    }
+  if (d->LookingGlassViewWidget && d->LookingGlassViewWidget->mrmlLookingGlassViewNode() == viewNode)
+    {
+    return d->LookingGlassViewWidget;
+    }
+  foreach (qMRMLLookingGlassView* viewWidget, d->DeviceViewWidgets)
+    {
+    if (viewWidget->mrmlLookingGlassViewNode() == viewNode)
+      {
+      return viewWidget;
+      }
+    }
+  return nullptr;
+}
+
 // --------------------------------------------------------------------------
 void qSlicerLookingGlassModule::enableLookingGlass(bool enable)
 {
@@ -447,6 +535,9 @@ void qSlicerLookingGlassModule::onViewNodeModified()
     d->LookingGlassViewWidget->setMRMLLookingGlassViewNode(lgViewNode);
   }
 
+  // Update view widgets of the other devices
+  d->updateDeviceViewWidgets();
+
   // Update toolbar
   d->updateToolBar();
 }
@@ -28,6 +28,7 @@
 
 class qSlicerLookingGlassModulePrivate;
 class qMRMLLookingGlassView;
+class vtkMRMLLookingGlassViewNode;
 class QToolBar;
 
 class Q_SLICER_QTMODULES_LOOKINGGLASS_EXPORT
@@ -59,8 +60,13 @@ public:
   Q_INVOKABLE bool isToolBarVisible();
   Q_INVOKABLE QToolBar* toolBar();
 
+  /// View widget of the active looking glass view node
   Q_INVOKABLE virtual qMRMLLookingGlassView* viewWidget();
 
+  /// View widget rendering \a viewNode, there is one view widget per
+  /// looking glass device. Return nullptr if the node is not displayed.
+  Q_INVOKABLE qMRMLLookingGlassView* viewWidgetForNode(vtkMRMLLookingGlassViewNode* viewNode);
+
 public slots:
   void setToolBarVisible(bool visible);
   void enableLookingGlass(bool);
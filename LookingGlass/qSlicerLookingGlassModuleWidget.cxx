@@ -17,15 +17,7 @@
 
 // Qt includes
 #include <QDebug>
-
-// Slicer includes
-#include <qSlicerApplication.h>
-#include <qSlicerLayoutManager.h>
-#include <qMRMLThreeDWidget.h>
-#include <qMRMLThreeDView.h>
-
-// VTK includes
-#include <vtkInteractorStyle.h>
+#include <QTimer>
 
 // LookingGlass includes
 #include "qSlicerLookingGlassModuleWidget.h"
@@ -35,6 +27,7 @@
 #include <vtkSlicerLookingGlassLogic.h>
 
 // LookingGlass MRML includes
+#include <vtkMRMLLookingGlassRenderStatistics.h>
 #include <vtkMRMLLookingGlassViewNode.h>
 
 // LookingGlass Widget includes
@@ -49,6 +42,9 @@ class qSlicerLookingGlassModuleWidgetPrivate: public Ui_qSlicerLookingGlassModul
 {
 public:
   qSlicerLookingGlassModuleWidgetPrivate();
+
+  /// Periodically refreshes the render statistics readout while the module is entered
+  QTimer RenderStatisticsTimer;
 };
 
 //-----------------------------------------------------------------------------
@@ -86,6 +82,10 @@ void qSlicerLookingGlassModuleWidget::setup()
   {
     d->RenderingModeComboBox->addItem(vtkMRMLLookingGlassViewNode::GetRenderingModeAsString(idx));
   }
+  for (int idx = 0; idx < vtkMRMLLookingGlassViewNode::VirtualDeviceProfile_Last; idx++)
+  {
+    d->VirtualDeviceProfileComboBox->addItem(vtkMRMLLookingGlassViewNode::GetVirtualDeviceProfileAsString(idx));
+  }
 
   // Connection
   connect(d->ConnectCheckBox, SIGNAL(toggled(bool)), this, SLOT(setLookingGlassConnected(bool)));
@@ -94,6 +94,11 @@ void qSlicerLookingGlassModuleWidget::setup()
   // Display
   connect(d->RenderingModeComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(onRenderingModeChanged(int)));
   connect(d->DesiredUpdateRateSlider, SIGNAL(valueChanged(double)), this, SLOT(onDesiredUpdateRateChanged(double)));
+  connect(d->ReduceQualityDuringInteractionCheckBox, SIGNAL(toggled(bool)), this, SLOT(setReduceQualityDuringInteraction(bool)));
+  connect(d->VolumeRenderingStillOversamplingSpinBox, SIGNAL(valueChanged(double)), this, SLOT(onVolumeRenderingStillOversamplingChanged(double)));
+  connect(d->VolumeRenderingInteractiveOversamplingSpinBox, SIGNAL(valueChanged(double)), this, SLOT(onVolumeRenderingInteractiveOversamplingChanged(double)));
+  connect(d->VolumeRenderingAutoDownsamplingCheckBox, SIGNAL(toggled(bool)), this, SLOT(setVolumeRenderingAutoDownsampling(bool)));
+  connect(d->VolumeRenderingMemorySpinBox, SIGNAL(valueChanged(int)), this, SLOT(onVolumeRenderingMemoryChanged(int)));
   connect(d->UpdateViewFromReferenceViewCameraButton, SIGNAL(clicked()), this, SLOT(updateViewFromReferenceViewCamera()));
 
   // Advanced
@@ -103,6 +108,13 @@ void qSlicerLookingGlassModuleWidget::setup()
   connect(d->UseClippingLimitsCheckBox, SIGNAL(toggled(bool)), this, SLOT(setUseClippingLimits(bool)));
   connect(d->NearClippingLimitSlider, SIGNAL(valueChanged(double)), this, SLOT(onNearClippingLimitChanged(double)));
   connect(d->FarClippingLimitSlider, SIGNAL(valueChanged(double)), this, SLOT(onFarClippingLimitChanged(double)));
+  connect(d->VirtualDeviceCheckBox, SIGNAL(toggled(bool)), this, SLOT(setVirtualDevice(bool)));
+  connect(d->VirtualDeviceProfileComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(onVirtualDeviceProfileChanged(int)));
+  connect(d->QuiltRenderTimeSliceSpinBox, SIGNAL(valueChanged(double)), this, SLOT(onQuiltRenderTimeSliceChanged(double)));
+
+  // Statistics are updated after each rendered frame, refresh readout at a lower rate
+  d->RenderStatisticsTimer.setInterval(500);
+  connect(&d->RenderStatisticsTimer, SIGNAL(timeout()), this, SLOT(updateRenderStatistics()));
 
   this->updateWidgetFromMRML();
 
@@ -142,6 +154,31 @@ void qSlicerLookingGlassModuleWidget::updateWidgetFromMRML()
   d->DesiredUpdateRateSlider->setEnabled(lgViewNode != nullptr);
   d->DesiredUpdateRateSlider->blockSignals(wasBlocked);
 
+  wasBlocked = d->ReduceQualityDuringInteractionCheckBox->blockSignals(true);
+  d->ReduceQualityDuringInteractionCheckBox->setChecked(lgViewNode != nullptr && lgViewNode->GetReduceQualityDuringInteraction());
+  d->ReduceQualityDuringInteractionCheckBox->setEnabled(lgViewNode != nullptr);
+  d->ReduceQualityDuringInteractionCheckBox->blockSignals(wasBlocked);
+
+  wasBlocked = d->VolumeRenderingStillOversamplingSpinBox->blockSignals(true);
+  d->VolumeRenderingStillOversamplingSpinBox->setValue(lgViewNode != nullptr ? lgViewNode->GetVolumeRenderingStillOversamplingFactor() : 1.0);
+  d->VolumeRenderingStillOversamplingSpinBox->setEnabled(lgViewNode != nullptr);
+  d->VolumeRenderingStillOversamplingSpinBox->blockSignals(wasBlocked);
+
+  wasBlocked = d->VolumeRenderingInteractiveOversamplingSpinBox->blockSignals(true);
+  d->VolumeRenderingInteractiveOversamplingSpinBox->setValue(lgViewNode != nullptr ? lgViewNode->GetVolumeRenderingInteractiveOversamplingFactor() : 0.5);
+  d->VolumeRenderingInteractiveOversamplingSpinBox->setEnabled(lgViewNode != nullptr);
+  d->VolumeRenderingInteractiveOversamplingSpinBox->blockSignals(wasBlocked);
+
+  wasBlocked = d->VolumeRenderingAutoDownsamplingCheckBox->blockSignals(true);
+  d->VolumeRenderingAutoDownsamplingCheckBox->setChecked(lgViewNode != nullptr && lgViewNode->GetVolumeRenderingAutoDownsampling());
+  d->VolumeRenderingAutoDownsamplingCheckBox->setEnabled(lgViewNode != nullptr);
+  d->VolumeRenderingAutoDownsamplingCheckBox->blockSignals(wasBlocked);
+
+  wasBlocked = d->VolumeRenderingMemorySpinBox->blockSignals(true);
+  d->VolumeRenderingMemorySpinBox->setValue(lgViewNode != nullptr ? lgViewNode->GetGPUMemorySize() : 0);
+  d->VolumeRenderingMemorySpinBox->setEnabled(lgViewNode != nullptr);
+  d->VolumeRenderingMemorySpinBox->blockSignals(wasBlocked);
+
   wasBlocked = d->ReferenceViewNodeComboBox->blockSignals(true);
   d->ReferenceViewNodeComboBox->setCurrentNode(lgViewNode != nullptr ? lgViewNode->GetReferenceViewNode() : NULL);
   d->ReferenceViewNodeComboBox->blockSignals(wasBlocked);
@@ -149,39 +186,115 @@ void qSlicerLookingGlassModuleWidget::updateWidgetFromMRML()
 
   d->UpdateViewFromReferenceViewCameraButton->setEnabled(lgViewNode != nullptr
     && lgViewNode->GetReferenceViewNode() != nullptr);
+
+  wasBlocked = d->VirtualDeviceCheckBox->blockSignals(true);
+  d->VirtualDeviceCheckBox->setChecked(lgViewNode != nullptr && lgViewNode->GetVirtualDevice());
+  d->VirtualDeviceCheckBox->setEnabled(lgViewNode != nullptr);
+  d->VirtualDeviceCheckBox->blockSignals(wasBlocked);
+
+  wasBlocked = d->VirtualDeviceProfileComboBox->blockSignals(true);
+  d->VirtualDeviceProfileComboBox->setCurrentIndex(lgViewNode != nullptr ? lgViewNode->GetVirtualDeviceProfile() : 0);
+  d->VirtualDeviceProfileComboBox->setEnabled(lgViewNode != nullptr && lgViewNode->GetVirtualDevice());
+  d->VirtualDeviceProfileComboBox->blockSignals(wasBlocked);
+
+  wasBlocked = d->QuiltRenderTimeSliceSpinBox->blockSignals(true);
+  d->QuiltRenderTimeSliceSpinBox->setValue(lgViewNode != nullptr ? lgViewNode->GetQuiltRenderTimeSlice() * 1000.0 : 16.0);
+  d->QuiltRenderTimeSliceSpinBox->setEnabled(lgViewNode != nullptr && lgViewNode->GetVirtualDevice());
+  d->QuiltRenderTimeSliceSpinBox->blockSignals(wasBlocked);
 }
 
 //-----------------------------------------------------------------------------
-void qSlicerLookingGlassModuleWidget::onInteractorStyleStartInteractionEvent()
+void qSlicerLookingGlassModuleWidget::setVirtualDevice(bool virtualDevice)
 {
-  Q_D(qSlicerLookingGlassModuleWidget);
-  qSlicerLookingGlassModule* lgModule = dynamic_cast<qSlicerLookingGlassModule*>(this->module());
-  if (!lgModule)
+  vtkSlicerLookingGlassLogic* lgLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
+  vtkMRMLLookingGlassViewNode* lgViewNode = lgLogic->GetLookingGlassViewNode();
+  if (lgViewNode)
     {
-    return;
+    lgViewNode->SetVirtualDevice(virtualDevice);
     }
-  qMRMLLookingGlassView* lgView = lgModule->viewWidget();
-  if (!lgView)
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerLookingGlassModuleWidget::onVirtualDeviceProfileChanged(int profile)
+{
+  vtkSlicerLookingGlassLogic* lgLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
+  vtkMRMLLookingGlassViewNode* lgViewNode = lgLogic->GetLookingGlassViewNode();
+  if (lgViewNode)
     {
-    return;
+    lgViewNode->SetVirtualDeviceProfile(profile);
     }
-  lgView->setReferenceViewInteractive(true);
 }
 
 //-----------------------------------------------------------------------------
-void qSlicerLookingGlassModuleWidget::onInteractorStyleEndInteractionEvent()
+void qSlicerLookingGlassModuleWidget::onQuiltRenderTimeSliceChanged(double milliseconds)
 {
-  qSlicerLookingGlassModule* lgModule = dynamic_cast<qSlicerLookingGlassModule*>(this->module());
-  if (!lgModule)
+  vtkSlicerLookingGlassLogic* lgLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
+  vtkMRMLLookingGlassViewNode* lgViewNode = lgLogic->GetLookingGlassViewNode();
+  if (lgViewNode)
     {
-    return;
+    lgViewNode->SetQuiltRenderTimeSlice(milliseconds / 1000.0);
     }
-  qMRMLLookingGlassView* lgView = lgModule->viewWidget();
-  if (!lgView)
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerLookingGlassModuleWidget::enter()
+{
+  Q_D(qSlicerLookingGlassModuleWidget);
+  this->Superclass::enter();
+  this->updateRenderStatistics();
+  d->RenderStatisticsTimer.start();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerLookingGlassModuleWidget::exit()
+{
+  Q_D(qSlicerLookingGlassModuleWidget);
+  d->RenderStatisticsTimer.stop();
+  this->Superclass::exit();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerLookingGlassModuleWidget::updateRenderStatistics()
+{
+  Q_D(qSlicerLookingGlassModuleWidget);
+  vtkSlicerLookingGlassLogic* lgLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
+  vtkMRMLLookingGlassViewNode* lgViewNode = lgLogic ? lgLogic->GetLookingGlassViewNode() : nullptr;
+  vtkMRMLLookingGlassRenderStatistics* statistics = lgViewNode ? lgViewNode->GetRenderStatistics() : nullptr;
+  if (!statistics || !lgLogic->GetLookingGlassActive() || statistics->GetNumberOfFrames() == 0)
     {
+    d->RenderStatisticsLabel->setText(QString());
+    d->RenderStatisticsLabel->setToolTip(tr("Achieved update rate and mean frame time of the looking glass view."));
     return;
     }
-  lgView->setReferenceViewInteractive(false);
+
+  d->RenderStatisticsLabel->setText(tr("%1 fps, %2 ms")
+    .arg(statistics->GetFrameRate(), 0, 'f', 1)
+    .arg(statistics->GetMeanFrameTime() * 1000.0, 0, 'f', 0));
+
+  QStringList details;
+  details << tr("Frame time (last/mean/p95/max): %1 / %2 / %3 / %4 ms")
+    .arg(statistics->GetLastFrameTime() * 1000.0, 0, 'f', 1)
+    .arg(statistics->GetMeanFrameTime() * 1000.0, 0, 'f', 1)
+    .arg(statistics->GetPercentileFrameTime(95.0) * 1000.0, 0, 'f', 1)
+    .arg(statistics->GetMaximumFrameTime() * 1000.0, 0, 'f', 1);
+  for (int phase = 0; phase < vtkMRMLLookingGlassRenderStatistics::Phase_Last; ++phase)
+    {
+    details << tr("%1 (mean): %2 ms")
+      .arg(vtkMRMLLookingGlassRenderStatistics::GetPhaseAsString(phase))
+      .arg(statistics->GetMeanPhaseTime(phase) * 1000.0, 0, 'f', 1);
+    }
+  if (statistics->GetNumberOfGPUFrames() > 0)
+    {
+    for (int pass = 0; pass < vtkMRMLLookingGlassRenderStatistics::GPUPass_Last; ++pass)
+      {
+      details << tr("%1 GPU time (mean): %2 ms")
+        .arg(vtkMRMLLookingGlassRenderStatistics::GetGPUPassAsString(pass))
+        .arg(statistics->GetMeanGPUPassTime(pass) * 1000.0, 0, 'f', 1);
+      }
+    }
+  details << tr("Rendered frames: %1").arg(statistics->GetNumberOfRenderedFrames());
+  details << tr("Skipped frames: %1").arg(statistics->GetNumberOfSkippedFrames());
+  d->RenderStatisticsLabel->setToolTip(details.join("\n"));
 }
 
 //-----------------------------------------------------------------------------
@@ -211,20 +324,8 @@ void qSlicerLookingGlassModuleWidget::setReferenceViewNode(vtkMRMLNode* node)
     return;
     }
   vtkMRMLViewNode* referenceViewNode = vtkMRMLViewNode::SafeDownCast(node);
+  // The looking glass view observes the interaction in its reference view
   lgViewNode->SetAndObserveReferenceViewNode(referenceViewNode);
-
-  // Get reference to interactor style
-  qSlicerLayoutManager* layoutManager = qSlicerApplication::application()->layoutManager();
-  if (!layoutManager)
-    {
-    qWarning() << Q_FUNC_INFO << " failed: layout manager is not available";
-    return;
-    }
-  qMRMLThreeDWidget* threeDWidget = qobject_cast<qMRMLThreeDWidget*>(layoutManager->viewWidget(referenceViewNode));
-  qMRMLThreeDView* threeDView = threeDWidget->threeDView();
-  vtkInteractorStyle* interactor = vtkInteractorStyle::SafeDownCast(threeDView->interactorStyle());
-  qvtkReconnect(interactor, vtkCommand::StartInteractionEvent, this, SLOT(onInteractorStyleStartInteractionEvent()));
-  qvtkReconnect(interactor, vtkCommand::EndInteractionEvent, this, SLOT(onInteractorStyleEndInteractionEvent()));
 }
 
 //-----------------------------------------------------------------------------
@@ -268,6 +369,61 @@ void qSlicerLookingGlassModuleWidget::onDesiredUpdateRateChanged(double fps)
     }
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerLookingGlassModuleWidget::setReduceQualityDuringInteraction(bool reduce)
+{
+  vtkSlicerLookingGlassLogic* lgLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
+  vtkMRMLLookingGlassViewNode* lgViewNode = lgLogic->GetLookingGlassViewNode();
+  if (lgViewNode)
+    {
+    lgViewNode->SetReduceQualityDuringInteraction(reduce);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerLookingGlassModuleWidget::onVolumeRenderingStillOversamplingChanged(double factor)
+{
+  vtkSlicerLookingGlassLogic* lgLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
+  vtkMRMLLookingGlassViewNode* lgViewNode = lgLogic->GetLookingGlassViewNode();
+  if (lgViewNode)
+    {
+    lgViewNode->SetVolumeRenderingStillOversamplingFactor(factor);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerLookingGlassModuleWidget::onVolumeRenderingInteractiveOversamplingChanged(double factor)
+{
+  vtkSlicerLookingGlassLogic* lgLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
+  vtkMRMLLookingGlassViewNode* lgViewNode = lgLogic->GetLookingGlassViewNode();
+  if (lgViewNode)
+    {
+    lgViewNode->SetVolumeRenderingInteractiveOversamplingFactor(factor);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerLookingGlassModuleWidget::setVolumeRenderingAutoDownsampling(bool enable)
+{
+  vtkSlicerLookingGlassLogic* lgLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
+  vtkMRMLLookingGlassViewNode* lgViewNode = lgLogic->GetLookingGlassViewNode();
+  if (lgViewNode)
+    {
+    lgViewNode->SetVolumeRenderingAutoDownsampling(enable);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerLookingGlassModuleWidget::onVolumeRenderingMemoryChanged(int sizeInMB)
+{
+  vtkSlicerLookingGlassLogic* lgLogic = vtkSlicerLookingGlassLogic::SafeDownCast(this->logic());
+  vtkMRMLLookingGlassViewNode* lgViewNode = lgLogic->GetLookingGlassViewNode();
+  if (lgViewNode)
+    {
+    lgViewNode->SetGPUMemorySize(sizeInMB);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void qSlicerLookingGlassModuleWidget::setUseClippingLimits(bool activate)
 {
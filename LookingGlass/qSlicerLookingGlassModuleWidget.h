@@ -41,6 +41,9 @@ public:
   qSlicerLookingGlassModuleWidget(QWidget *parent=nullptr);
   virtual ~qSlicerLookingGlassModuleWidget();
 
+  virtual void enter() override;
+  virtual void exit() override;
+
 public slots:
   void setLookingGlassConnected(bool connect);
   void setLookingGlassActive(bool activate);
@@ -48,16 +51,23 @@ public slots:
   void updateViewFromReferenceViewCamera();
   void onRenderingModeChanged(int);
   void onDesiredUpdateRateChanged(double);
+  void setReduceQualityDuringInteraction(bool);
+  void onVolumeRenderingStillOversamplingChanged(double);
+  void onVolumeRenderingInteractiveOversamplingChanged(double);
+  void setVolumeRenderingAutoDownsampling(bool);
+  void onVolumeRenderingMemoryChanged(int);
   void setUseClippingLimits(bool);
   void onNearClippingLimitChanged(double);
   void onFarClippingLimitChanged(double);
+  void setVirtualDevice(bool);
+  void onVirtualDeviceProfileChanged(int);
+  void onQuiltRenderTimeSliceChanged(double);
   void pullFocalPlaneForward();
   void pushFocalPlaneBack();
 
 protected slots:
   void updateWidgetFromMRML();
-  void onInteractorStyleStartInteractionEvent();
-  void onInteractorStyleEndInteractionEvent();
+  void updateRenderStatistics();
 
 protected:
   QScopedPointer<qSlicerLookingGlassModuleWidgetPrivate> d_ptr;